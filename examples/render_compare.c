@@ -0,0 +1,171 @@
+#include <smol.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* === Constants === */
+
+#define WIN_W 640
+#define WIN_H 480
+
+#define CANVAS_W 320
+#define CANVAS_H 240
+
+#define CHANNEL_TOLERANCE 8         //< Filtering and rounding differ slightly between backends
+#define MAX_MISMATCH_RATIO 0.01f    //< Share of pixels allowed above the tolerance
+
+// NOTE: Renders a fixed scene, then writes it as a PPM when the reference
+//       file given on the command line does not exist yet, or compares
+//       against it otherwise. Generate the reference with a GL build, then
+//       run the SL_BACKEND_SOFTWARE build with the same path to compare.
+
+/* === Scene === */
+
+static void render_scene(sl_mesh_id ground, sl_texture_id texture)
+{
+    sl_render_clear(SL_COLOR(32, 32, 48, 255));
+
+    /* --- Ground plane in perspective --- */
+
+    sl_mat4_t proj = sl_mat4_perspective(60 * SL_DEG2RAD, (float)CANVAS_W / CANVAS_H, 0.1f, 100.0f);
+    sl_render_set_projection(&proj);
+
+    sl_render_set_sampler(0, texture);
+    sl_render_set_color(SL_WHITE);
+    sl_render_mesh(ground, 6);
+
+    sl_render_set_projection(NULL);
+
+    /* --- Flat and textured shapes --- */
+
+    sl_render_set_sampler(0, 0);
+
+    sl_render_set_color(SL_RED);
+    sl_render_rectangle(16, 16, 64, 48);
+
+    sl_render_set_color(SL_COLOR(0, 255, 0, 128));
+    sl_render_circle(SL_VEC2(96, 48), 32, 32);
+
+    sl_render_set_color(SL_YELLOW);
+    sl_render_triangle(SL_VEC2(160, 16), SL_VEC2(140, 72), SL_VEC2(200, 60));
+    sl_render_line(SL_VEC2(220, 20), SL_VEC2(300, 90), 3);
+
+    sl_render_set_sampler(0, texture);
+    sl_render_set_color(SL_WHITE);
+    sl_render_rectangle(232, 120, 64, 64);
+
+    sl_render_set_sampler(0, 0);
+}
+
+/* === Helper Functions === */
+
+static bool write_ppm(const char* path, const sl_image_t* image)
+{
+    char header[32];
+    int header_size = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", image->w, image->h);
+
+    size_t size = header_size + (size_t)image->w * image->h * 3;
+    uint8_t* data = malloc(size);
+    if (data == NULL) {
+        return false;
+    }
+
+    memcpy(data, header, header_size);
+
+    const uint8_t* src = image->pixels;
+    uint8_t* dst = data + header_size;
+
+    for (int i = 0; i < image->w * image->h; i++, src += 4, dst += 3) {
+        dst[0] = src[0], dst[1] = src[1], dst[2] = src[2];
+    }
+
+    bool ok = sl_file_write(path, data, size);
+    free(data);
+
+    return ok;
+}
+
+static bool compare_images(const sl_image_t* frame, const sl_image_t* reference)
+{
+    if (frame->w != reference->w || frame->h != reference->h) {
+        sl_loge("COMPARE: Size mismatch; %dx%d against %dx%d", frame->w, frame->h, reference->w, reference->h);
+        return false;
+    }
+
+    int mismatches = 0;
+    int max_delta = 0;
+
+    for (int y = 0; y < frame->h; y++) {
+        for (int x = 0; x < frame->w; x++) {
+            sl_color_t a = sl_image_get_pixel(frame, x, y);
+            sl_color_t b = sl_image_get_pixel(reference, x, y);
+            int delta = SL_MAX(SL_MAX(abs(a.r - b.r), abs(a.g - b.g)), abs(a.b - b.b));
+            if (delta > CHANNEL_TOLERANCE) mismatches++;
+            max_delta = SL_MAX(max_delta, delta);
+        }
+    }
+
+    float ratio = (float)mismatches / (frame->w * frame->h);
+    sl_logi("COMPARE: %d pixels above tolerance (%.2f%%), max channel delta %d", mismatches, ratio * 100.0f, max_delta);
+
+    return ratio <= MAX_MISMATCH_RATIO;
+}
+
+/* === Program === */
+
+int main(int argc, char* argv[])
+{
+    const char* reference_path = (argc > 1) ? argv[1] : "render_compare.ppm";
+
+    sl_init("Smol - Render Compare Example", WIN_W, WIN_H, 0);
+
+    /* --- Load the scene resources --- */
+
+    const sl_vertex_3d_t ground_vertices[4] =
+    {
+        // Starts behind the eye to go through the near plane clipping
+        SL_VERTEX_3D(SL_VEC3(-3, -1, 5), SL_VEC2(0, 0), SL_VEC3(0, 1, 0), SL_WHITE),
+        SL_VERTEX_3D(SL_VEC3(3, -1, 5), SL_VEC2(1, 0), SL_VEC3(0, 1, 0), SL_WHITE),
+        SL_VERTEX_3D(SL_VEC3(3, -1, -40), SL_VEC2(1, 1), SL_VEC3(0, 1, 0), SL_WHITE),
+        SL_VERTEX_3D(SL_VEC3(-3, -1, -40), SL_VEC2(0, 1), SL_VEC3(0, 1, 0), SL_WHITE),
+    };
+
+    const uint16_t ground_indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+    sl_mesh_id ground = sl_mesh_create(ground_vertices, 4, ground_indices, 6);
+    sl_texture_id texture = sl_texture_load(RESOURCES_PATH "wabbit.png", NULL, NULL);
+    sl_canvas_id canvas = sl_canvas_create(CANVAS_W, CANVAS_H, SL_PIXEL_FORMAT_RGBA8, false);
+
+    /* --- Render and read back --- */
+
+    sl_image_t frame = { 0 };
+
+    sl_render_set_canvas(canvas);
+    render_scene(ground, texture);
+    bool ok = sl_render_read_pixels(&frame);
+    sl_render_set_canvas(0);
+
+    /* --- Write the reference or compare against it --- */
+
+    if (ok) {
+        sl_image_t reference = { 0 };
+        if (sl_image_load(&reference, reference_path)) {
+            ok = compare_images(&frame, &reference);
+            sl_image_destroy(&reference);
+        }
+        else {
+            ok = write_ppm(reference_path, &frame);
+            sl_logi("COMPARE: Reference written to '%s'", reference_path);
+        }
+        sl_image_destroy(&frame);
+    }
+
+    sl_canvas_destroy(canvas);
+    sl_texture_destroy(texture);
+    sl_mesh_destroy(ground);
+
+    sl_quit();
+
+    return ok ? 0 : 1;
+}
@@ -11,8 +11,9 @@ int main(void)
     sl_font_id font = sl_font_load(RESOURCES_PATH "font.ttf", SL_FONT_SDF, 32, 0, 0);
     sl_render_set_font(font);
 
-    sl_shader_id shader = sl_shader_load(RESOURCES_PATH "text_sdf.glsl");
-    sl_render_set_shader(shader);
+    // SDF fonts are drawn with a built-in shader, one atlas serves all sizes
+    sl_render_set_text_outline(2.0f, SL_BLACK);
+    sl_render_set_text_shadow(SL_VEC2(4, 4), SL_COLOR(0, 0, 0, 128));
 
     while (sl_frame_step())
     {
@@ -21,6 +22,9 @@ int main(void)
         sl_render_set_color(SL_YELLOW);
         sl_render_text_centered("Hello World!", sl_vec2_scale(SL_VEC2(WIN_W, WIN_H), 0.5f), 128, SL_VEC2(2, 2));
 
+        sl_render_set_color(SL_WHITE);
+        sl_render_text_centered("Small text from the same atlas", SL_VEC2(WIN_W * 0.5f, WIN_H * 0.8f), 24, SL_VEC2(1, 1));
+
         sl_render_present();
     }
 
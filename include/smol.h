@@ -58,6 +58,7 @@ typedef uint64_t sl_flags_t;
 #define SL_FLAG_KEYBOARD_GRABBED        (1 << 15)
 #define SL_FLAG_HIGH_PIXEL_DENSITY      (1 << 16)
 #define SL_FLAG_MSAA_X4                 (1 << 17)
+#define SL_FLAG_AUDIO_OFFLINE           (1 << 18)
 
 typedef enum sl_mouse_button {
     SL_MOUSE_BUTTON_LEFT = 1,
@@ -388,9 +389,51 @@ typedef enum sl_stencil_op {
 typedef enum sl_font_type {
     SL_FONT_BITMAP,             ///< Grayscale bitmap font (anti-aliased, default stb_truetype output)
     SL_FONT_PIXEL,              ///< Pixel-art style bitmap (grayscale thresholded to binary alpha)
-    SL_FONT_SDF,                ///< Signed Distance Field (needs a custom shader)
+    SL_FONT_SDF,                ///< Signed Distance Field (one atlas for all sizes, uses a built-in shader)
 } sl_font_type_t;
 
+typedef enum sl_text_wrap {
+    SL_TEXT_WRAP_NONE,          ///< Lines only break on '\n'
+    SL_TEXT_WRAP_WORD,          ///< Lines break between words, long words break between characters
+    SL_TEXT_WRAP_CHAR,          ///< Lines break before the first character that overflows
+} sl_text_wrap_t;
+
+typedef enum sl_text_align {
+    SL_TEXT_ALIGN_LEFT,
+    SL_TEXT_ALIGN_CENTER,
+    SL_TEXT_ALIGN_RIGHT,
+} sl_text_align_t;
+
+typedef enum sl_stream_latency {
+    SL_STREAM_LATENCY_DEFAULT,      ///< 3 buffers of 185 ms, cheap on CPU
+    SL_STREAM_LATENCY_LOW,          ///< 4 buffers of 20 ms, changes are heard within 80 ms
+} sl_stream_latency_t;
+
+typedef enum sl_sample_storage {
+    SL_SAMPLE_STORAGE_PCM,          ///< 16-bit PCM, nothing to decode while playing
+    SL_SAMPLE_STORAGE_ADPCM,        ///< 4-bit IMA ADPCM, 4x smaller, decoded while playing
+} sl_sample_storage_t;
+
+typedef enum sl_audio_bus {
+    SL_AUDIO_BUS_SFX,               ///< Bus of the samples not routed elsewhere
+    SL_AUDIO_BUS_MUSIC,             ///< Bus of the streams
+    SL_AUDIO_BUS_VOICE,
+    SL_AUDIO_BUS_UI,
+    SL_AUDIO_BUS_COUNT
+} sl_audio_bus_t;
+
+typedef enum sl_audio_filter {
+    SL_AUDIO_FILTER_NONE,
+    SL_AUDIO_FILTER_LOWPASS,        ///< Keeps the frequencies below the cutoff
+    SL_AUDIO_FILTER_HIGHPASS,       ///< Keeps the frequencies above the cutoff
+} sl_audio_filter_t;
+
+typedef enum sl_load_state {
+    SL_LOAD_FAILED,                 ///< Failed to load, destroyed, or unknown ID
+    SL_LOAD_PENDING,                ///< Still loading on a worker thread
+    SL_LOAD_READY,
+} sl_load_state_t;
+
 /* === Structures === */
 
 typedef struct sl_app_desc {
@@ -410,6 +453,31 @@ typedef struct sl_app_desc {
 
 } sl_app_desc_t;
 
+typedef struct sl_stream_desc {
+
+    sl_stream_latency_t latency;    ///< Preset providing the values left to zero
+    int buffer_count;               ///< Number of buffers queued ahead (2 to 16)
+    float buffer_duration;          ///< Duration of each buffer in seconds (0.005 to 2.0)
+
+} sl_stream_desc_t;
+
+typedef struct sl_audio_bus_desc {
+
+    sl_audio_filter_t filter;       ///< Filter applied first, SL_AUDIO_FILTER_NONE to bypass
+    float filter_cutoff;            ///< Cutoff frequency in Hz
+    float filter_q;                 ///< Resonance, 0 for a flat response (0.707)
+
+    float reverb_mix;               ///< Reverb added to the dry signal (0.0 to 1.0), 0 to bypass
+    float reverb_room_size;         ///< Length of the reverb tail (0.0 to 1.0)
+    float reverb_damping;           ///< Absorption of the high frequencies (0.0 to 1.0)
+
+    float compressor_threshold;     ///< Level in dBFS above which the gain is reduced
+    float compressor_ratio;         ///< Input to output ratio above the threshold, 1 or less to bypass, 20 or more limits
+    float compressor_attack;        ///< Seconds to react to a louder level, 0 for the default (0.005)
+    float compressor_release;       ///< Seconds to recover once the level drops, 0 for the default (0.1)
+
+} sl_audio_bus_desc_t;
+
 typedef union sl_vec2 {
     struct { float x, y; };
     float v[2];
@@ -467,6 +535,12 @@ typedef struct sl_image {
     sl_pixel_format_t format;
 } sl_image_t;
 
+typedef struct sl_text_builder {
+    char* data;             ///< Null-terminated content, NULL until the first append
+    int length;             ///< Length of the content in bytes
+    int capacity;           ///< Allocated size in bytes
+} sl_text_builder_t;
+
 /* === ID Types === */
 
 typedef uint32_t sl_texture_id;
@@ -474,16 +548,23 @@ typedef uint32_t sl_canvas_id;
 typedef uint32_t sl_shader_id;
 typedef uint32_t sl_mesh_id;
 typedef uint32_t sl_font_id;
+typedef uint32_t sl_text_layout_id;
 
 typedef uint32_t sl_sample_id;
 typedef uint32_t sl_stream_id;
 
+/* === Callback Types === */
+
+typedef void (*sl_load_callback_t)(uint32_t id, bool success, void* user_data);
+
 /* === Macros === */
 
 #define SL_MIN(a, b) ((a) < (b) ? (a) : (b))
 #define SL_MAX(a, b) ((a) > (b) ? (a) : (b))
 #define SL_CLAMP(val, min, max) ((val) < (min) ? (min) : ((val) > (max) ? (max) : (val)))
 
+#define SL_TEXT_FORMAT_RING_SIZE 8
+
 #ifdef __cplusplus
 #define SL_VEC2(x, y)                                       \
     sl_vec2 {                                               \
@@ -960,6 +1041,14 @@ SLAPI void sl_render_present(void);
 /** Clear the screen or current canvas with specified color */
 SLAPI void sl_render_clear(sl_color_t color);
 
+/**
+ * Read back the pixels of the screen or current canvas
+ * Automatically flushes the batch
+ * @param image Receives a new RGBA8 image, top row first; free it with sl_image_destroy
+ * @return True on success, false on failure
+ */
+SLAPI bool sl_render_read_pixels(sl_image_t* image);
+
 /**
  * Set specific viewport dimensions
  * Automatically flushes the batch
@@ -998,6 +1087,17 @@ SLAPI void sl_render_set_depth_write(bool enabled);
  */
 SLAPI void sl_render_set_depth_range(float near, float far);
 
+/** Draw opaque batched geometry front to back using the depth buffer
+ * Each state change of the batch becomes a layer with its own depth,
+ * opaque layers (SL_BLEND_OPAQUE) are drawn first from the closest one
+ * so that hidden pixels are rejected early, then the other layers are
+ * drawn back to front as usual. The result is the same as without it.
+ * The current target must have a depth buffer, which is cleared by
+ * every flush that uses this mode. Has no effect with the software backend.
+ * Automatically flushes the batch
+ */
+SLAPI void sl_render_set_opaque_sorting(bool enabled);
+
 /** Set which faces to cull during rendering
  * Automatically flushes the batch
  */
@@ -1021,6 +1121,20 @@ SLAPI void sl_render_set_sampler(uint32_t slot, sl_texture_id texture);
  */
 SLAPI void sl_render_set_font(sl_font_id font);
 
+/** Set the outline of SDF text
+ * Width is in atlas pixels, clamped to [0, 3.5]; zero disables the outline
+ * Only applies with the built-in SDF shader (no custom shader set)
+ * Flushes the batch if the outline changes
+ */
+SLAPI void sl_render_set_text_outline(float width, sl_color_t color);
+
+/** Set the drop shadow of SDF text
+ * Offset is in screen pixels (positive Y goes down), a transparent color disables the shadow
+ * Requires derivatives support (always on GL 3.3, an extension on GLES2)
+ * Flushes the batch if the shadow changes
+ */
+SLAPI void sl_render_set_text_shadow(sl_vec2_t offset, sl_color_t color);
+
 /** Set the shader to use
  * Zero applies default shader
  * May trigger a new draw call for the next primitive
@@ -1141,6 +1255,16 @@ SLAPI void sl_render_set_transform(const sl_mat4_t* matrix);
  */
 SLAPI sl_mat4_t sl_render_get_transform(void);
 
+/**
+ * Let the GPU apply the current transform to batched geometry.
+ * Transforms are stored in a small per-batch palette and applied by the
+ * vertex shader instead of transforming every vertex on the CPU.
+ * Transforms only use their 2D part, as on the CPU path.
+ * Has no effect with the software backend.
+ * @param enabled Whether transforms are applied on the GPU
+ */
+SLAPI void sl_render_set_gpu_transform(bool enabled);
+
 /** Reset texture transform to identity */
 SLAPI void sl_render_texture_identity(void);
 
@@ -1278,6 +1402,16 @@ SLAPI void sl_render_rectangle_lines(float x, float y, float w, float h, float t
  */
 SLAPI void sl_render_rectangle_ex(sl_vec2_t center, sl_vec2_t size, float rotation);
 
+/** Render many rectangles with center, size, and rotation in one call
+ *  Cheaper than calling sl_render_rectangle_ex in a loop
+ *  @param centers Center points of the rectangles
+ *  @param sizes Widths and heights as vectors
+ *  @param rotations Rotation angles in radians (NULL for no rotation)
+ *  @param colors Colors of the rectangles (NULL to use the current color)
+ *  @param count Number of rectangles
+ */
+SLAPI void sl_render_rectangles_ex(const sl_vec2_t* centers, const sl_vec2_t* sizes, const float* rotations, const sl_color_t* colors, int count);
+
 /** Render rotated rectangle outline
  *  Only works correctly in 2D
  *  @param center Center point of the rectangle
@@ -1338,6 +1472,16 @@ SLAPI void sl_render_rounded_rectangle_lines_ex(sl_vec2_t center, sl_vec2_t size
  */
 SLAPI void sl_render_circle(sl_vec2_t p, float radius, int segments);
 
+/** Render many filled circles in one call
+ *  Cheaper than calling sl_render_circle in a loop
+ *  @param centers Center positions
+ *  @param radii Circle radii
+ *  @param colors Colors of the circles (NULL to use the current color)
+ *  @param count Number of circles
+ *  @param segments Number of segments per circle (higher = smoother circles)
+ */
+SLAPI void sl_render_circles(const sl_vec2_t* centers, const float* radii, const sl_color_t* colors, int count, int segments);
+
 /** Render circle outline
  *  Only works correctly in 2D
  *  @param p Center position
@@ -1433,6 +1577,17 @@ SLAPI void sl_render_ring_arc_lines(sl_vec2_t center, float inner_radius, float
  */
 SLAPI void sl_render_line(sl_vec2_t p0, sl_vec2_t p1, float thickness);
 
+/** Render many lines in one call
+ *  Only works correctly in 2D
+ *  Cheaper than calling sl_render_line in a loop
+ *  @param starts Start points
+ *  @param ends End points
+ *  @param colors Colors of the lines (NULL to use the current color)
+ *  @param count Number of lines
+ *  @param thickness Line thickness in pixels
+ */
+SLAPI void sl_render_lines(const sl_vec2_t* starts, const sl_vec2_t* ends, const sl_color_t* colors, int count, float thickness);
+
 /** Render an arc
  *  Only works correctly in 2D
  *  @param center Center position
@@ -1547,6 +1702,29 @@ SLAPI void sl_render_text(const char* text, sl_vec2_t position, float font_size,
  */
 SLAPI void sl_render_text_centered(const char* text, sl_vec2_t position, float font_size, sl_vec2_t spacing);
 
+/** Render a text layout
+ *  @param layout Text layout to render, drawn with its own font
+ *  @param position Starting position
+ *  @param color Color of the glyphs
+ */
+SLAPI void sl_render_text_layout(sl_text_layout_id layout, sl_vec2_t position, sl_color_t color);
+
+/** Render a text layout centered on position
+ *  @param layout Text layout to render, drawn with its own font
+ *  @param position Center position
+ *  @param color Color of the glyphs
+ */
+SLAPI void sl_render_text_layout_centered(sl_text_layout_id layout, sl_vec2_t position, sl_color_t color);
+
+/** Render a text layout clipped to its box
+ *  Only the lines visible in the box are emitted, glyphs are cut at its edges
+ *  @param layout Text layout to render, drawn with its own font
+ *  @param position Top-left corner of the box
+ *  @param scroll Vertical offset of the text in the box, in pixels
+ *  @param color Color of the glyphs
+ */
+SLAPI void sl_render_text_layout_box(sl_text_layout_id layout, sl_vec2_t position, float scroll, sl_color_t color);
+
 /** Render mesh, count = number of vertices or indices if index buffer used
  *  @param mesh Mesh to render
  *  @param count Number of vertices or indices to render
@@ -1630,6 +1808,19 @@ SLAPI sl_texture_id sl_texture_load(const char* file_path, int* w, int* h);
  */
 SLAPI sl_texture_id sl_texture_load_from_memory(const sl_image_t* image);
 
+/**
+ * @brief Update a region of a texture
+ * @param texture Texture identifier
+ * @param x Left of the region in pixels
+ * @param y Top of the region in pixels
+ * @param w Width of the region
+ * @param h Height of the region
+ * @param pixels Tightly packed pixel data of the region
+ * @param format Pixel format, must match the one the texture was created with
+ * @return True if the region was uploaded
+ */
+SLAPI bool sl_texture_update(sl_texture_id texture, int x, int y, int w, int h, const void* pixels, sl_pixel_format_t format);
+
 /**
  * @brief Destroy a texture
  * @param texture Texture identifier
@@ -1894,6 +2085,45 @@ SLAPI sl_font_id sl_font_load_from_memory(const void* file_data, size_t data_siz
 SLAPI sl_font_id sl_font_load(const char* filePath, sl_font_type_t type,
                               int base_size, int* codepoints, int codepoint_count);
 
+/**
+ * @brief Load a dynamic font from memory
+ *
+ * Glyphs are rasterized the first time they are drawn or measured and
+ * packed into atlas pages, so any codepoint of the font can be used
+ * without building a full atlas up front. The least recently used page
+ * is evicted when the cache budget is reached.
+ *
+ * @param file_data Pointer to font file data in memory, copied by the font
+ * @param data_size Size of the font data in bytes
+ * @param type Font type (e.g., bitmap, vector)
+ * @param base_size Base size of the font
+ * @return Font ID on success, 0 on failure
+ */
+SLAPI sl_font_id sl_font_load_dynamic_from_memory(const void* file_data, size_t data_size,
+                                                  sl_font_type_t type, int base_size);
+
+/**
+ * @brief Load a dynamic font from a file
+ * @param file_path Path to the font file
+ * @param type Font type (e.g., bitmap, vector)
+ * @param base_size Base size of the font
+ * @return Font ID on success, 0 on failure
+ * @see sl_font_load_dynamic_from_memory
+ */
+SLAPI sl_font_id sl_font_load_dynamic(const char* file_path, sl_font_type_t type, int base_size);
+
+/**
+ * @brief Set the memory budget of a dynamic font's glyph cache
+ *
+ * The budget is rounded down to whole 512x512 pages of 2 bytes per
+ * texel, between 1 and 16 pages; the default is 4 pages (2 MiB).
+ * Pages over a lowered budget are released immediately.
+ *
+ * @param font Font ID, ignored if the font is not dynamic
+ * @param bytes Texture memory allowed for the glyph pages
+ */
+SLAPI void sl_font_set_cache_budget(sl_font_id font, size_t bytes);
+
 /**
  * @brief Destroy a loaded font
  * @param font Font ID
@@ -1929,6 +2159,87 @@ SLAPI void sl_font_measure_codepoints(float* w, float* h, sl_font_id font, const
 
 /** @} */ // Font
 
+/* === Text Layout Functions === */
+
+/** @defgroup TextLayout Text Layout Functions
+ *  Retained glyph runs for text that is drawn many times.
+ *
+ *  A layout decodes its string, resolves the glyphs and measures the
+ *  bounds once; drawing it only emits the quads. It is rebuilt when
+ *  its string, font, size or spacing actually changes.
+ *
+ *  A layout can also be bounded by a box, its lines are then wrapped
+ *  to the box width, aligned in it and clipped to it when drawn with
+ *  sl_render_text_layout_box(). Line breaks are cached per paragraph
+ *  (text between two '\n'), changing the string only lays out again
+ *  the paragraphs that differ.
+ *  @{
+ */
+
+/**
+ * @brief Create a text layout
+ * @param font Font ID used to resolve and draw the glyphs
+ * @param text UTF-8 encoded string, copied by the layout (nullable)
+ * @param font_size Font size in pixels
+ * @param spacing Horizontal and vertical spacing between characters
+ * @return Text layout ID on success, 0 on failure
+ */
+SLAPI sl_text_layout_id sl_text_layout_create(sl_font_id font, const char* text, float font_size, sl_vec2_t spacing);
+
+/**
+ * @brief Destroy a text layout
+ * @param layout Text layout ID
+ */
+SLAPI void sl_text_layout_destroy(sl_text_layout_id layout);
+
+/**
+ * @brief Change the string of a text layout
+ * @param layout Text layout ID
+ * @param text UTF-8 encoded string, the layout is only rebuilt if it differs (nullable)
+ * @return True on success
+ */
+SLAPI bool sl_text_layout_set_text(sl_text_layout_id layout, const char* text);
+
+/**
+ * @brief Change the font of a text layout
+ * @param layout Text layout ID
+ * @param font Font ID
+ * @param font_size Font size in pixels
+ * @param spacing Horizontal and vertical spacing between characters
+ * @return True on success
+ */
+SLAPI bool sl_text_layout_set_font(sl_text_layout_id layout, sl_font_id font, float font_size, sl_vec2_t spacing);
+
+/**
+ * @brief Bound a text layout by a box
+ * @param layout Text layout ID
+ * @param w Width used to wrap and align the lines, zero for unbounded
+ * @param h Height used to clip the lines, zero for unbounded
+ * @param wrap How lines are broken when they overflow the width
+ * @param align Horizontal alignment of the lines in the box
+ * @return True on success
+ * @note Only a change of the width or the wrap mode lays out the text again
+ */
+SLAPI bool sl_text_layout_set_box(sl_text_layout_id layout, float w, float h, sl_text_wrap_t wrap, sl_text_align_t align);
+
+/**
+ * @brief Query the measured bounds of a text layout
+ * @param layout Text layout ID
+ * @param w Returns the width (nullable)
+ * @param h Returns the height (nullable)
+ * @return True if the layout exists
+ */
+SLAPI bool sl_text_layout_query(sl_text_layout_id layout, float* w, float* h);
+
+/**
+ * @brief Get the number of lines of a text layout, wrapped lines included
+ * @param layout Text layout ID
+ * @return Line count, 0 if the layout doesn't exist
+ */
+SLAPI int sl_text_layout_line_count(sl_text_layout_id layout);
+
+/** @} */ // TextLayout
+
 /* === Audio Functions === */
 
 /** @defgroup Audio Audio Functions
@@ -1972,12 +2283,110 @@ SLAPI void sl_audio_set_volume_stream(float volume);
  */
 SLAPI void sl_audio_set_volume_sample(float volume);
 
+/**
+ * @brief Set the buffering used by streams loaded with sl_stream_load()
+ *
+ * Fewer and shorter buffers make play, stop and seek changes audible sooner,
+ * at the cost of waking the stream thread more often. The stream thread refills
+ * each stream as soon as one of its buffers has been played, so the refill rate
+ * follows the buffer duration.
+ *
+ * @param desc Buffering description, NULL restores the default preset
+ * @note Streams already loaded keep their buffering.
+ */
+SLAPI void sl_audio_set_stream_desc(const sl_stream_desc_t* desc);
+
+/**
+ * @brief Get the buffering used by streams loaded with sl_stream_load()
+ * @param desc Receives the resolved description, no field left to zero
+ */
+SLAPI void sl_audio_get_stream_desc(sl_stream_desc_t* desc);
+
+/**
+ * @brief Set the volume of a submix bus
+ *
+ * The change is ramped over a few milliseconds, which makes it usable for
+ * ducking a bus under another one.
+ *
+ * @param bus Bus to change
+ * @param volume Volume value (0.0 = mute, 1.0 = max)
+ */
+SLAPI void sl_audio_set_bus_volume(sl_audio_bus_t bus, float volume);
+
+/**
+ * @brief Get the volume of a submix bus
+ * @param bus Bus to query
+ * @return Bus volume (0.0 = mute, 1.0 = max)
+ */
+SLAPI float sl_audio_get_bus_volume(sl_audio_bus_t bus);
+
+/**
+ * @brief Set the effects of a submix bus
+ *
+ * Each bus filters, then adds its reverb, then compresses the sum of the
+ * samples routed to it, before its volume and the master volume apply.
+ *
+ * @param bus Bus to change
+ * @param desc Effects description, NULL bypasses every effect
+ * @note Streams are always mixed on SL_AUDIO_BUS_MUSIC, after their own volume.
+ */
+SLAPI void sl_audio_set_bus_desc(sl_audio_bus_t bus, const sl_audio_bus_desc_t* desc);
+
+/**
+ * @brief Get the effects of a submix bus
+ * @param bus Bus to query
+ * @param desc Receives the resolved description, no field left to zero
+ */
+SLAPI void sl_audio_get_bus_desc(sl_audio_bus_t bus, sl_audio_bus_desc_t* desc);
+
+/**
+ * @brief Render the next frames of audio into memory
+ *
+ * Only available when initialized with SL_FLAG_AUDIO_OFFLINE. Samples and
+ * streams then advance only through this function, as fast as it is called,
+ * and the same calls always produce the same output.
+ *
+ * @param out Receives 'frames' interleaved stereo float frames at 48000 Hz
+ * @param frames Number of frames to render
+ * @return True on success, false if audio is not offline
+ */
+SLAPI bool sl_audio_render(float* out, int frames);
+
+/**
+ * @brief Render the next frames of audio into a WAV file
+ *
+ * Same as sl_audio_render() but written as a 32-bit float stereo WAV file.
+ *
+ * @param file_path Path of the WAV file to write
+ * @param frames Number of frames to render
+ * @return True on success, false on failure
+ */
+SLAPI bool sl_audio_render_wav(const char* file_path, int frames);
+
+/**
+ * @brief Get the number of asynchronous loads not finished yet
+ * @return Loads still running or waiting for the next sl_frame_step()
+ */
+SLAPI int sl_audio_get_pending_loads(void);
+
+/**
+ * @brief Wait for every asynchronous load to finish
+ *
+ * Blocks until the loader threads are done, then finishes the loads and
+ * calls their callbacks like sl_frame_step() would.
+ */
+SLAPI void sl_audio_wait_loads(void);
+
 /** @} */ // Audio
 
 /* === Sample Functions === */
 
 /** @defgroup Sample Sample Functions
  *  Sample effects with channel-based polyphony.
+ *  Samples are mixed in software from a global pool of voices; when
+ *  the pool is exhausted, the oldest voice of the lowest priority
+ *  not above the new one is stolen. Each voice is mixed into the
+ *  submix bus of its sample.
  *  @{
  */
 
@@ -1989,6 +2398,48 @@ SLAPI void sl_audio_set_volume_sample(float volume);
  */
 SLAPI sl_sample_id sl_sample_load(const char* file_path, int channel_count);
 
+/**
+ * @brief Load a sample from a file with a given storage
+ *
+ * ADPCM keeps a quarter of the PCM size in memory and is decoded block by
+ * block by the voices playing it. It suits long ambiences and voice banks,
+ * short and frequent effects are better kept as PCM.
+ *
+ * @param file_path Path to the sample file (supports WAV, FLAC, MP3, OGG)
+ * @param channel_count Number of channels for polyphony (must be > 0)
+ * @param storage How the decoded sample is kept in memory
+ * @return Sample ID on success, 0 on failure
+ */
+SLAPI sl_sample_id sl_sample_load_ex(const char* file_path, int channel_count, sl_sample_storage_t storage);
+
+/**
+ * @brief Load a sample on a loader thread
+ *
+ * The file is read, decoded and converted on one of the loader threads,
+ * one per CPU core beside the main one, so that many samples load in
+ * parallel. The returned ID is pending until a later sl_frame_step()
+ * finishes the load.
+ *
+ * A pending sample can have its volume, pan, priority and bus set, but
+ * does not play. If the load fails, the ID becomes invalid.
+ *
+ * @param file_path Path to the sample file (supports WAV, FLAC, MP3, OGG)
+ * @param channel_count Number of channels for polyphony (must be > 0)
+ * @param storage How the decoded sample is kept in memory
+ * @param callback Called by sl_frame_step() once loaded or failed, can be NULL
+ * @param user_data Passed to the callback
+ * @return Pending sample ID, 0 on immediate failure
+ */
+SLAPI sl_sample_id sl_sample_load_async(const char* file_path, int channel_count, sl_sample_storage_t storage,
+                                        sl_load_callback_t callback, void* user_data);
+
+/**
+ * @brief Get the loading state of a sample
+ * @param sample_id Sample ID
+ * @return SL_LOAD_READY for samples loaded synchronously or finished loading
+ */
+SLAPI sl_load_state_t sl_sample_get_load_state(sl_sample_id sample_id);
+
 /**
  * @brief Destroy a loaded sample and free all associated resources
  * @param sample_id Sample ID to destroy
@@ -2039,6 +2490,36 @@ SLAPI bool sl_sample_is_playing(sl_sample_id sample_id, int channel);
  */
 SLAPI int sl_sample_get_channel_count(sl_sample_id sample_id);
 
+/**
+ * @brief Set the volume of a sample on a specific channel or all channels
+ * @param sample_id Sample ID
+ * @param channel Channel index (>= 0) to set a specific channel, or negative value to set all channels
+ * @param volume Volume value (0.0 = mute, 1.0 = max)
+ */
+SLAPI void sl_sample_set_volume(sl_sample_id sample_id, int channel, float volume);
+
+/**
+ * @brief Set the stereo panning of a sample on a specific channel or all channels
+ * @param sample_id Sample ID
+ * @param channel Channel index (>= 0) to set a specific channel, or negative value to set all channels
+ * @param pan Balance from -1.0 (left) to 1.0 (right), 0.0 is centered
+ */
+SLAPI void sl_sample_set_pan(sl_sample_id sample_id, int channel, float pan);
+
+/**
+ * @brief Set the priority of a sample when voices have to be stolen
+ * @param sample_id Sample ID
+ * @param priority Priority applied to the next plays, higher is kept longer (default: 0)
+ */
+SLAPI void sl_sample_set_priority(sl_sample_id sample_id, int priority);
+
+/**
+ * @brief Route a sample to a submix bus
+ * @param sample_id Sample ID
+ * @param bus Bus applied to the next plays (default: SL_AUDIO_BUS_SFX)
+ */
+SLAPI void sl_sample_set_bus(sl_sample_id sample_id, sl_audio_bus_t bus);
+
 /** @} */ // Sample
 
 /* === Stream Functions === */
@@ -2055,6 +2536,40 @@ SLAPI int sl_sample_get_channel_count(sl_sample_id sample_id);
  */
 SLAPI sl_stream_id sl_stream_load(const char* file_path);
 
+/**
+ * @brief Load stream from a file with its own buffering
+ * @param file_path Path to the stream file
+ * @param desc Buffering description, NULL uses the global one (see sl_audio_set_stream_desc())
+ * @return Stream ID on success, 0 or invalid ID on failure
+ */
+SLAPI sl_stream_id sl_stream_load_ex(const char* file_path, const sl_stream_desc_t* desc);
+
+/**
+ * @brief Open a stream on a loader thread
+ *
+ * The file is opened and its decoder prepared on one of the loader
+ * threads, which includes building the seek table of MP3 files. The
+ * returned ID is pending until a later sl_frame_step() finishes the load.
+ *
+ * A pending stream can have its volume set, other calls on it are ignored.
+ * If the load fails, the ID becomes invalid.
+ *
+ * @param file_path Path to the stream file
+ * @param desc Buffering description, NULL uses the global one (see sl_audio_set_stream_desc())
+ * @param callback Called by sl_frame_step() once loaded or failed, can be NULL
+ * @param user_data Passed to the callback
+ * @return Pending stream ID, 0 on immediate failure
+ */
+SLAPI sl_stream_id sl_stream_load_async(const char* file_path, const sl_stream_desc_t* desc,
+                                        sl_load_callback_t callback, void* user_data);
+
+/**
+ * @brief Get the loading state of a stream
+ * @param stream Stream ID
+ * @return SL_LOAD_READY for streams loaded synchronously or finished loading
+ */
+SLAPI sl_load_state_t sl_stream_get_load_state(sl_stream_id stream);
+
 /**
  * @brief Destroy loaded stream
  * @param stream Stream ID
@@ -2085,6 +2600,14 @@ SLAPI void sl_stream_stop(sl_stream_id stream);
  */
 SLAPI void sl_stream_rewind(sl_stream_id stream);
 
+/**
+ * @brief Move stream playback to a given time
+ * @param stream Stream ID
+ * @param seconds Position from the beginning, clamped to the stream length
+ * @note The playing or paused state is kept. MP3 streams seek through a table built at load.
+ */
+SLAPI void sl_stream_seek(sl_stream_id stream, double seconds);
+
 /**
  * @brief Check if stream is currently playing
  * @param stream Stream ID
@@ -2099,6 +2622,15 @@ SLAPI bool sl_stream_is_playing(sl_stream_id stream);
  */
 SLAPI void sl_stream_loop(sl_stream_id stream, bool loop);
 
+/**
+ * @brief Set the part of the stream repeated when looping
+ * @param stream Stream ID
+ * @param start Loop start in seconds, what comes before plays only once
+ * @param end Loop end in seconds, 0 or less for the end of the stream
+ * @note Both points are rounded to the nearest sample frame, the loop is gapless.
+ */
+SLAPI void sl_stream_set_loop_points(sl_stream_id stream, double start, double end);
+
 /** @} */ // Stream
 
 /* === Text Functions === */
@@ -2161,11 +2693,12 @@ SLAPI char* sl_text_ends_with(const char* str, const char* suffix);
 SLAPI char* sl_text_contains(const char* str, const char* keyword);
 
 /**
- * @brief Format a string with printf-like syntax using a static buffer
+ * @brief Format a string with printf-like syntax using a thread-local buffer
  * @param text Format string (printf-style)
  * @param ... Arguments for format string
- * @return Formatted string (max 512 chars, truncated with "..." if needed)
- * @note Not thread-safe. Result is overwritten on next call.
+ * @return Formatted string, truncated with "..." only if its buffer fails to grow
+ * @note Each thread cycles through SL_TEXT_FORMAT_RING_SIZE buffers, a result
+ *       stays valid until as many other calls are made from the same thread.
  */
 SLAPI const char* sl_text_format(const char* text, ...);
 
@@ -2181,21 +2714,21 @@ SLAPI char* sl_text_format_dynamic(const char* text, ...);
 /**
  * @brief Format a timestamp as date and time (YYYY-MM-DD HH:MM:SS)
  * @param time Time in nanoseconds since epoch
- * @return Static formatted string (not thread-safe)
+ * @return Formatted string from the same thread-local ring as sl_text_format
  */
 SLAPI const char* sl_text_format_date_time(int64_t time);
 
 /**
  * @brief Format a timestamp as date (YYYY-MM-DD)
  * @param time Time in nanoseconds since epoch
- * @return Static formatted string (not thread-safe)
+ * @return Formatted string from the same thread-local ring as sl_text_format
  */
 SLAPI const char* sl_text_format_date(int64_t time);
 
 /**
  * @brief Format a timestamp as time (HH:MM:SS)
  * @param time Time in nanoseconds since epoch
- * @return Static formatted string (not thread-safe)
+ * @return Formatted string from the same thread-local ring as sl_text_format
  */
 SLAPI const char* sl_text_format_time(int64_t time);
 
@@ -2264,6 +2797,60 @@ SLAPI void sl_text_reverse(char* str);
  */
 SLAPI void sl_text_trim(char* str);
 
+/**
+ * @brief Create a text builder with an initial capacity
+ * @param builder Pointer to an sl_text_builder_t structure
+ * @param capacity Initial size in bytes, a zeroed builder also works without this call
+ * @return True on success, false on failure
+ */
+SLAPI bool sl_text_builder_create(sl_text_builder_t* builder, int capacity);
+
+/**
+ * @brief Destroy a text builder and free its memory
+ * @param builder Pointer to an sl_text_builder_t structure
+ */
+SLAPI void sl_text_builder_destroy(sl_text_builder_t* builder);
+
+/**
+ * @brief Empty a text builder while keeping its memory for reuse
+ * @param builder Pointer to an sl_text_builder_t structure
+ */
+SLAPI void sl_text_builder_clear(sl_text_builder_t* builder);
+
+/**
+ * @brief Append a string to a text builder
+ * @param builder Pointer to an sl_text_builder_t structure
+ * @param text String to append
+ * @return True on success, false if the builder could not grow
+ */
+SLAPI bool sl_text_builder_append(sl_text_builder_t* builder, const char* text);
+
+/**
+ * @brief Append the first bytes of a string to a text builder
+ * @param builder Pointer to an sl_text_builder_t structure
+ * @param text String to append
+ * @param length Number of bytes to append
+ * @return True on success, false if the builder could not grow
+ */
+SLAPI bool sl_text_builder_append_n(sl_text_builder_t* builder, const char* text, int length);
+
+/**
+ * @brief Append a formatted string to a text builder
+ * @param builder Pointer to an sl_text_builder_t structure
+ * @param format Format string (printf-style)
+ * @param ... Arguments for format string
+ * @return True on success, false if the builder could not grow
+ */
+SLAPI bool sl_text_builder_append_format(sl_text_builder_t* builder, const char* format, ...);
+
+/**
+ * @brief Append a codepoint encoded in UTF-8 to a text builder
+ * @param builder Pointer to an sl_text_builder_t structure
+ * @param codepoint Unicode codepoint
+ * @return True on success, false if the builder could not grow
+ */
+SLAPI bool sl_text_builder_append_codepoint(sl_text_builder_t* builder, int codepoint);
+
 /** @} */ // Text
 
 /* === Codepoint Functions === */
@@ -2296,6 +2883,26 @@ SLAPI int sl_codepoint_prev(const char* text, int* codepointSize);
  */
 SLAPI int sl_codepoint_count(const char* text);
 
+/**
+ * @brief Decode a UTF-8 string into an array of codepoints
+ * Pure ASCII runs are converted 16 bytes at a time, invalid bytes decode like sl_codepoint_next()
+ * Decoding stops at the end of the string or once the array is full, never inside a codepoint
+ * @param text Input string
+ * @param size Size of the string in bytes
+ * @param codepoints Output array of codepoints
+ * @param capacity Size of the output array, 'size' is always enough
+ * @param decoded_size Output number of bytes decoded (nullable)
+ * @return Number of codepoints decoded
+ */
+SLAPI int sl_codepoint_decode(const char* text, int size, int* codepoints, int capacity, int* decoded_size);
+
+/**
+ * @brief Check that a null-terminated string is well-formed UTF-8
+ * @param text Input string
+ * @return True if the string only holds valid sequences (RFC 3629)
+ */
+SLAPI bool sl_codepoint_validate(const char* text);
+
 /**
  * @brief Convert a codepoint to UTF-8 string
  * @param codepoint Unicode codepoint
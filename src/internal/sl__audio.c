@@ -18,6 +18,7 @@
  */
 
 #include "./sl__audio.h"
+#include "./sl__mixer.h"
 
 #include <SDL3/SDL_assert.h>
 #include <SDL3/SDL_timer.h>
@@ -74,60 +75,43 @@ struct sl__audio sl__audio = { 0 };
 
 /* === Module Functions === */
 
-bool sl__audio_init(void)
+bool sl__audio_init(bool offline)
 {
-    /* --- Initialize decode buffer pool --- */
-
-    sl__audio.decode_buffer_pool_size = SL__stream_BUFFER_SIZE;
-
-    if (!sl__audio_stream_ensure_buffer_pool_capacity(4)) {
-        sl_loge("AUDIO: Failed to initialize decode buffer pool");
-        return false;
-    }
-
-    /* --- Initialize active streams list --- */
-
-    sl__audio.active_streams_capacity = 8;
-    sl__audio.active_streams = SDL_malloc(sl__audio.active_streams_capacity * sizeof(sl_stream_id));
-
-    if (sl__audio.active_streams == NULL) {
-        sl_loge("AUDIO: Failed to initialize active streams list");
-        return false;
-    }
-
     /* --- Create registries --- */
 
-    sl__audio.reg_samples = sl__registry_create(16, sizeof(sl__sample_t));
-    sl__audio.reg_streams = sl__registry_create(8, sizeof(sl__stream_t));
+    sl__audio.reg_samples = sl__registry_create(16, sizeof(sl__sample_t*));
+    sl__audio.reg_streams = sl__registry_create(8, sizeof(sl__stream_t*));
 
-    /* --- Create the OpenAL context and device --- */
+    // NOTE: Offline, the mixer device is never opened and
+    //       sl_audio_render() runs the whole mixer instead
 
-    sl__audio.device = alcOpenDevice(NULL);
-    if (sl__audio.device == NULL) {
-        sl_loge("AUDIO: Failed to create OpenAL device; %s", SDL_GetError());
-        return false;
-    }
+    sl__audio.offline = offline;
+
+    /* --- Open the mixer, samples and streams both play through it --- */
 
-    sl__audio.context = alcCreateContext(sl__audio.device, NULL);
-    if (sl__audio.context == NULL) {
-        sl_loge("AUDIO: Failed to create OpenAL context; %s", SDL_GetError());
+    if (!sl__mixer_init()) {
+        sl_loge("AUDIO: Failed to initialize the mixer");
         return false;
     }
 
-    alcMakeContextCurrent(sl__audio.context);
-
     /* --- Set default global parameters --- */
 
     sl__audio.volume_master = 1.0f;
     sl__audio.volume_sample = 1.0f;
     sl__audio.volume_stream = 1.0f;
 
+    sl__audio_stream_desc_resolve(&sl__audio.stream_desc, NULL);
+
+    for (int i = 0; i < SL_AUDIO_BUS_COUNT; i++) {
+        sl__audio.bus_volumes[i] = 1.0f;
+        sl__mixer_bus_desc_resolve(&sl__audio.bus_descs[i], NULL);
+    }
+
     /* --- Initialize stream streaming state --- */
 
     sl__audio.stream_thread_initialized = false;
     sl__audio.stream_thread = NULL;
-    sl__audio.stream_mutex = NULL;
-    sl__audio.stream_condition = NULL;
+    sl__audio.stream_wakeup = NULL;
     SDL_SetAtomicInt(&sl__audio.stream_thread_should_stop, 0);
 
     return true;
@@ -135,9 +119,12 @@ bool sl__audio_init(void)
 
 void sl__audio_quit(void)
 {
-    /* --- Shutdown the stream decoder thread first --- */
+    /* --- Finish the asynchronous loads, then shutdown the stream thread and the mixer --- */
+
+    sl__audio_load_quit();
 
     sl__audio_stream_thread_shutdown();
+    sl__mixer_quit();
 
     /* --- Release non destroyed objects --- */
 
@@ -157,82 +144,14 @@ void sl__audio_quit(void)
 
     sl__registry_destroy(&sl__audio.reg_streams);
     sl__registry_destroy(&sl__audio.reg_samples);
-
-    /* --- Cleanup active streams list --- */
-
-    if (sl__audio.active_streams) {
-        SDL_free(sl__audio.active_streams);
-        sl__audio.active_streams = NULL;
-    }
-
-    /* --- Cleanup decode buffer pool --- */
-
-    if (sl__audio.decode_buffer_pool) {
-        for (size_t i = 0; i < sl__audio.decode_buffer_count; i++) {
-            if (sl__audio.decode_buffer_pool[i]) {
-                SDL_free(sl__audio.decode_buffer_pool[i]);
-            }
-        }
-        SDL_free(sl__audio.decode_buffer_pool);
-        sl__audio.decode_buffer_pool = NULL;
-    }
-    
-    if (sl__audio.decode_buffer_in_use) {
-        SDL_free(sl__audio.decode_buffer_in_use);
-        sl__audio.decode_buffer_in_use = NULL;
-    }
-
-    /* --- Close OpenAL device and context --- */
-
-    if (sl__audio.context) {
-        alcMakeContextCurrent(NULL);
-        alcDestroyContext(sl__audio.context);
-        sl__audio.context = NULL;
-    }
-
-    if (sl__audio.device) {
-        alcCloseDevice(sl__audio.device);
-        sl__audio.device = NULL;
-    }
 }
 
-/* === Helper Functions === */
-
-const char* sl__audio_get_format_name(ALenum format)
+void sl__audio_update(void)
 {
-    switch (format) {
-    case AL_FORMAT_MONO8:
-        return "Mono 8-Bit";
-    case AL_FORMAT_MONO16:
-        return "Mono 16-Bit";
-    case AL_FORMAT_STEREO8:
-        return "Stereo 8-Bit";
-    case AL_FORMAT_STEREO16:
-        return "Stereo 16-Bit";
-    default:
-        break;
-    }
-
-    return "Unknown";
+    sl__audio_load_update();
 }
 
-size_t sl__audio_get_sample_count(size_t pcm_date_size, ALenum format)
-{
-    switch (format) {
-    case AL_FORMAT_MONO8:
-        return pcm_date_size;
-    case AL_FORMAT_MONO16:
-        return pcm_date_size / 2;
-    case AL_FORMAT_STEREO8:
-        return pcm_date_size / 2;
-    case AL_FORMAT_STEREO16:
-        return pcm_date_size / 4;
-    default:
-        break;
-    }
-
-    return 0;
-}
+/* === Helper Functions === */
 
 sl__audio_format_t sl__audio_get_format(const uint8_t* data, size_t size)
 {
@@ -289,9 +208,87 @@ sl__audio_format_t sl__audio_get_format(const uint8_t* data, size_t size)
     return SL__AUDIO_UNKNOWN;
 }
 
+/* === Queue Functions === */
+
+bool sl__audio_queue_create(sl__audio_queue_t* queue, int capacity, int item_size)
+{
+    SDL_assert((capacity & (capacity - 1)) == 0);
+
+    queue->sequences = SDL_malloc(capacity * sizeof(SDL_AtomicInt));
+    queue->items = SDL_malloc(capacity * item_size);
+
+    if (!queue->sequences || !queue->items) {
+        sl__audio_queue_destroy(queue);
+        return false;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        SDL_SetAtomicInt(&queue->sequences[i], i);
+    }
+
+    queue->item_size = item_size;
+    queue->capacity = capacity;
+    SDL_SetAtomicInt(&queue->head, 0);
+    queue->tail = 0;
+
+    return true;
+}
+
+void sl__audio_queue_destroy(sl__audio_queue_t* queue)
+{
+    SDL_free(queue->sequences);
+    SDL_free(queue->items);
+    SDL_memset(queue, 0, sizeof(*queue));
+}
+
+bool sl__audio_queue_push(sl__audio_queue_t* queue, const void* item)
+{
+    uint32_t mask = (uint32_t)queue->capacity - 1;
+    uint32_t position = (uint32_t)SDL_GetAtomicInt(&queue->head);
+
+    /* --- Claim a cell --- */
+
+    while (true) {
+        int diff = (int)((uint32_t)SDL_GetAtomicInt(&queue->sequences[position & mask]) - position);
+        if (diff == 0) {
+            if (SDL_CompareAndSwapAtomicInt(&queue->head, (int)position, (int)(position + 1))) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            return false; // Full
+        }
+        position = (uint32_t)SDL_GetAtomicInt(&queue->head);
+    }
+
+    /* --- Write the item and hand it to the consumer --- */
+
+    SDL_memcpy(queue->items + (position & mask) * queue->item_size, item, queue->item_size);
+    SDL_SetAtomicInt(&queue->sequences[position & mask], (int)(position + 1));
+
+    return true;
+}
+
+bool sl__audio_queue_pop(sl__audio_queue_t* queue, void* item)
+{
+    uint32_t mask = (uint32_t)queue->capacity - 1;
+    uint32_t position = queue->tail;
+
+    int diff = (int)((uint32_t)SDL_GetAtomicInt(&queue->sequences[position & mask]) - (position + 1));
+    if (diff < 0) {
+        return false; // Empty
+    }
+
+    SDL_memcpy(item, queue->items + (position & mask) * queue->item_size, queue->item_size);
+    SDL_SetAtomicInt(&queue->sequences[position & mask], (int)(position + queue->capacity));
+    queue->tail = position + 1;
+
+    return true;
+}
+
 /* === Volume Functions === */
 
-static float sl__audio_linear_to_log(float linear_volume)
+float sl__audio_linear_to_log(float linear_volume)
 {
     if (linear_volume <= 0.0f) return 0.0f;
     if (linear_volume >= 1.0f) return 1.0f;
@@ -307,41 +304,62 @@ static float sl__audio_log_to_linear(float log_volume)
     return powf(log_volume, 1.0f / 3.0f);
 }
 
-float sl__audio_calculate_final_sample_volume(void)
+float sl__audio_calculate_stream_gain(float stream_volume)
 {
-    float master_log = sl__audio_linear_to_log(sl__audio.volume_master);
-    float sample_log = sl__audio_linear_to_log(sl__audio.volume_sample);
-    return master_log * sample_log;
+    // The master volume is applied by the mixer on its output
+    float stream_global_log = sl__audio_linear_to_log(sl__audio.volume_stream);
+    float stream_individual_log = sl__audio_linear_to_log(stream_volume);
+    return stream_global_log * stream_individual_log;
 }
 
-float sl__audio_calculate_final_stream_volume(float stream_volume)
+void sl__audio_update_master_volume(void)
 {
-    float master_log = sl__audio_linear_to_log(sl__audio.volume_master);
-    float stream_global_log = sl__audio_linear_to_log(sl__audio.volume_stream);
-    float stream_individual_log = sl__audio_linear_to_log(stream_volume);
-    return master_log * stream_global_log * stream_individual_log;
+    sl__mixer_command_t command = {
+        .type = SL__MIXER_CMD_MASTER_GAIN,
+        .value = sl__audio_linear_to_log(sl__audio.volume_master)
+    };
+
+    sl__mixer_post(&command);
 }
 
 void sl__audio_update_all_sample_volumes(void)
 {
-    float final_volume = sl__audio_calculate_final_sample_volume();
+    sl__mixer_command_t command = {
+        .type = SL__MIXER_CMD_GAIN,
+        .value = sl__audio_linear_to_log(sl__audio.volume_sample)
+    };
 
-    for (size_t i = 0; i < sl__audio.reg_samples.elements.count; i++) {
-        if (((bool*)sl__audio.reg_samples.valid_flags.data)[i]) {
-            sl__sample_t* sample = &((sl__sample_t*)sl__audio.reg_samples.elements.data)[i];
-            for (int j = 0; j < sample->source_count; j++) {
-                alSourcef(sample->sources[j], AL_GAIN, final_volume);
-            }
-        }
-    }
+    sl__mixer_post(&command);
+}
+
+void sl__audio_update_bus_volume(sl_audio_bus_t bus)
+{
+    sl__mixer_command_t command = {
+        .type = SL__MIXER_CMD_BUS_GAIN,
+        .bus = bus,
+        .value = sl__audio_linear_to_log(sl__audio.bus_volumes[bus])
+    };
+
+    sl__mixer_post(&command);
+}
+
+void sl__audio_update_stream_volume(sl__stream_t* stream)
+{
+    // NOTE: Published as float bits, the mixer reads it at each block
+
+    float gain = sl__audio_calculate_stream_gain(stream->volume);
+
+    Uint32 bits;
+    SDL_memcpy(&bits, &gain, sizeof(bits));
+    SDL_SetAtomicU32(&stream->gain, bits);
 }
 
 void sl__audio_update_all_stream_volumes(void)
 {
-    for (int i = 0; i < sl__audio.active_streams_count; i++) {
-        sl__stream_t* stream = sl__registry_get(&sl__audio.reg_streams, sl__audio.active_streams[i]);
-        float final_volume = sl__audio_calculate_final_stream_volume(stream->volume);
-        alSourcef(stream->source, AL_GAIN, final_volume);
+    for (size_t i = 0; i < sl__audio.reg_streams.elements.count; i++) {
+        if (((bool*)sl__audio.reg_streams.valid_flags.data)[i]) {
+            sl__audio_update_stream_volume(((sl__stream_t**)sl__audio.reg_streams.elements.data)[i]);
+        }
     }
 }
 
@@ -358,7 +376,8 @@ bool sl__audio_sample_load_wav(sl__sample_raw_t* out, const void* data, size_t d
 
     if (wav.channels == 1) {
         if (wav.bitsPerSample == 16) {
-            out->format = AL_FORMAT_MONO16;
+            out->channels = 1;
+            out->bits = 16;
         }
         else {
             sl_loge("AUDIO: Unsupported WAV format for mono audio (bits per sample: %u)", wav.bitsPerSample);
@@ -368,7 +387,8 @@ bool sl__audio_sample_load_wav(sl__sample_raw_t* out, const void* data, size_t d
     }
     else if (wav.channels == 2) {
         if (wav.bitsPerSample == 16) {
-            out->format = AL_FORMAT_STEREO16;
+            out->channels = 2;
+            out->bits = 16;
         }
         else {
             sl_loge("AUDIO: Unsupported WAV format for stereo audio (bits per sample: %u)", wav.bitsPerSample);
@@ -430,10 +450,12 @@ bool sl__audio_sample_load_flac(sl__sample_raw_t* out, const void* data, size_t
     }
 
     if (channels == 1) {
-        out->format = AL_FORMAT_MONO16;
+        out->channels = 1;
+        out->bits = 16;
     }
     else if (channels == 2) {
-        out->format = AL_FORMAT_STEREO16;
+        out->channels = 2;
+        out->bits = 16;
     }
     else {
         sl_loge("AUDIO: Unsupported number of channels (%u) in FLAC file", channels);
@@ -467,10 +489,12 @@ bool sl__audio_sample_load_mp3(sl__sample_raw_t* out, const void* data, size_t d
     }
 
     if (config.channels == 1) {
-        out->format = AL_FORMAT_MONO16;
+        out->channels = 1;
+        out->bits = 16;
     }
     else if (config.channels == 2) {
-        out->format = AL_FORMAT_STEREO16;
+        out->channels = 2;
+        out->bits = 16;
     }
     else {
         sl_loge("AUDIO: Unsupported number of channels (%u) in MP3 file", config.channels);
@@ -505,10 +529,12 @@ bool sl__audio_sample_load_ogg(sl__sample_raw_t* out, const void* data, size_t d
     }
 
     if (channels == 1) {
-        out->format = AL_FORMAT_MONO16;
+        out->channels = 1;
+        out->bits = 16;
     }
     else if (channels == 2) {
-        out->format = AL_FORMAT_STEREO16;
+        out->channels = 2;
+        out->bits = 16;
     }
     else {
         sl_loge("AUDIO: Unsupported number of channels (%d) in OGG file", channels);
@@ -523,483 +549,1652 @@ bool sl__audio_sample_load_ogg(sl__sample_raw_t* out, const void* data, size_t d
     return true;
 }
 
-/* === Stream Functions === */
+void sl__audio_sample_free(sl__sample_t* sample)
+{
+    SDL_free(sample->channels);
+    SDL_free(sample->adpcm);
+    SDL_free(sample->pcm);
+    SDL_free(sample);
+}
 
-bool sl__audio_stream_thread_init(void)
+/* === ADPCM Functions === */
+
+// NOTE: Blocks hold SL__ADPCM_BLOCK_FRAMES frames, planar by channel. Each
+//       channel starts with its decoder state (int16 predictor, uint8 step
+//       index, one pad byte) followed by two samples per byte, low nibble
+//       first. Blocks are independent, so voices can start or resume on
+//       any of them. The state carries over from one block to the next
+//       while encoding, so it does not drift.
+
+static const int16_t sl__adpcm_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+static const int8_t sl__adpcm_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static inline int16_t sl__adpcm_expand(int* predictor, int* index, int nibble)
 {
-    if (sl__audio.stream_thread_initialized) {
-        return true;
+    // NOTE: (2m+1)*step/8 with 'm' the 3-bit magnitude instead of the usual
+    //       shift and add form, without branches. It rounds slightly
+    //       differently, the encoder tracks this decoder so both agree.
+
+    int step = sl__adpcm_step_table[*index];
+    int diff = ((2 * (nibble & 7) + 1) * step) >> 3;
+    int sign = -((nibble >> 3) & 1);
+
+    *predictor = SL_CLAMP(*predictor + ((diff ^ sign) - sign), -32768, 32767);
+    *index = SL_CLAMP(*index + sl__adpcm_index_table[nibble], 0, 88);
+
+    return (int16_t)*predictor;
+}
+
+static inline int sl__adpcm_compress(int* predictor, int* index, int sample)
+{
+    int step = sl__adpcm_step_table[*index];
+    int diff = sample - *predictor;
+
+    int nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
     }
 
-    /* --- Create mutex and condition variable --- */
+    if (diff >= step) { nibble |= 4; diff -= step; }
+    if (diff >= step >> 1) { nibble |= 2; diff -= step >> 1; }
+    if (diff >= step >> 2) { nibble |= 1; }
 
-    sl__audio.stream_mutex = SDL_CreateMutex();
-    if (!sl__audio.stream_mutex) {
-        sl_loge("AUDIO: Failed to create stream mutex");
-        return false;
+    // Track the decoder so that the error does not accumulate
+    sl__adpcm_expand(predictor, index, nibble);
+
+    return nibble;
+}
+
+uint8_t* sl__audio_adpcm_encode(const int16_t* pcm, int frame_count, int channels, size_t* out_size)
+{
+    int block_count = (frame_count + SL__ADPCM_BLOCK_FRAMES - 1) / SL__ADPCM_BLOCK_FRAMES;
+    size_t size = (size_t)block_count * SL__ADPCM_BLOCK_SIZE(channels);
+
+    uint8_t* data = SDL_calloc(1, SL_MAX(size, 1));
+    if (data == NULL) {
+        return NULL;
     }
 
-    sl__audio.stream_condition = SDL_CreateCondition();
-    if (!sl__audio.stream_condition) {
-        sl_loge("AUDIO: Failed to create stream condition variable");
-        SDL_DestroyMutex(sl__audio.stream_mutex);
-        sl__audio.stream_mutex = NULL;
-        return false;
+    int predictor[2] = { 0 };
+    int index[2] = { 0 };
+
+    for (int b = 0; b < block_count; b++)
+    {
+        uint8_t* block = data + (size_t)b * SL__ADPCM_BLOCK_SIZE(channels);
+        int first = b * SL__ADPCM_BLOCK_FRAMES;
+        int count = SL_MIN(frame_count - first, SL__ADPCM_BLOCK_FRAMES);
+
+        for (int c = 0; c < channels; c++)
+        {
+            uint8_t* header = block + c * (4 + SL__ADPCM_BLOCK_FRAMES / 2);
+            uint8_t* nibbles = header + 4;
+
+            /* --- Store the state the decoder starts from --- */
+
+            header[0] = (uint8_t)(predictor[c] & 0xFF);
+            header[1] = (uint8_t)((predictor[c] >> 8) & 0xFF);
+            header[2] = (uint8_t)index[c];
+            header[3] = 0;
+
+            /* --- Encode the samples, the tail of the last block stays silent --- */
+
+            for (int i = 0; i < count; i++) {
+                int nibble = sl__adpcm_compress(&predictor[c], &index[c], pcm[(size_t)(first + i) * channels + c]);
+                nibbles[i >> 1] |= (uint8_t)(nibble << ((i & 1) << 2));
+            }
+        }
     }
 
-    /* --- Initialize atomic flag --- */
+    if (out_size) *out_size = size;
 
-    SDL_SetAtomicInt(&sl__audio.stream_thread_should_stop, 0);
+    return data;
+}
 
-    /* --- Create and start the thread --- */
+void sl__audio_adpcm_decode_block(const uint8_t* block, int channels, int16_t* out)
+{
+    // NOTE: Every sample depends on the previous one, so there is nothing
+    //       for SIMD here; stereo decodes both channels in the same loop
+    //       so that their two dependency chains overlap
 
-    sl__audio.stream_thread = SDL_CreateThread(sl__audio_stream_thread, "streamStreamThread", NULL);
-    if (!sl__audio.stream_thread) {
-        sl_loge("AUDIO: Failed to create stream streaming thread");
-        SDL_DestroyCondition(sl__audio.stream_condition);
-        SDL_DestroyMutex(sl__audio.stream_mutex);
-        sl__audio.stream_condition = NULL;
-        sl__audio.stream_mutex = NULL;
-        return false;
+    const int channel_size = 4 + SL__ADPCM_BLOCK_FRAMES / 2;
+
+    int predictor[2], index[2];
+    for (int c = 0; c < channels; c++) {
+        const uint8_t* header = block + c * channel_size;
+        predictor[c] = (int16_t)(header[0] | (header[1] << 8));
+        index[c] = SL_CLAMP((int)header[2], 0, 88);
     }
 
-    /* --- Ready to dance! --- */
+    if (channels == 1) {
+        const uint8_t* nibbles = block + 4;
+        for (int i = 0; i < SL__ADPCM_BLOCK_FRAMES / 2; i++) {
+            out[2 * i + 0] = sl__adpcm_expand(&predictor[0], &index[0], nibbles[i] & 0x0F);
+            out[2 * i + 1] = sl__adpcm_expand(&predictor[0], &index[0], nibbles[i] >> 4);
+        }
+        return;
+    }
 
-    sl__audio.stream_thread_initialized = true;
+    const uint8_t* nibbles_l = block + 4;
+    const uint8_t* nibbles_r = block + channel_size + 4;
+
+    for (int i = 0; i < SL__ADPCM_BLOCK_FRAMES / 2; i++) {
+        out[4 * i + 0] = sl__adpcm_expand(&predictor[0], &index[0], nibbles_l[i] & 0x0F);
+        out[4 * i + 1] = sl__adpcm_expand(&predictor[1], &index[1], nibbles_r[i] & 0x0F);
+        out[4 * i + 2] = sl__adpcm_expand(&predictor[0], &index[0], nibbles_l[i] >> 4);
+        out[4 * i + 3] = sl__adpcm_expand(&predictor[1], &index[1], nibbles_r[i] >> 4);
+    }
+}
+
+/* === Stream Functions === */
+
+// NOTE: The active list, the pause flag and the read side of the ring are
+//       read by the mixer, the stream thread changes them under its lock.
+
+static bool sl__audio_stream_activate(sl__stream_t* stream)
+{
+    if (stream->active_index >= 0) {
+        return true;
+    }
+
+    sl__mixer_lock();
+
+    if (sl__audio.active_streams_count >= sl__audio.active_streams_capacity) {
+        int new_capacity = 2 * sl__audio.active_streams_capacity;
+        sl__stream_t** new_array = SDL_realloc(sl__audio.active_streams, new_capacity * sizeof(sl__stream_t*));
+        if (!new_array) {
+            sl__mixer_unlock();
+            return false;
+        }
+
+        sl__audio.active_streams = new_array;
+        sl__audio.active_streams_capacity = new_capacity;
+    }
+
+    stream->active_index = sl__audio.active_streams_count;
+    sl__audio.active_streams[sl__audio.active_streams_count++] = stream;
+
+    sl__mixer_unlock();
 
     return true;
 }
 
-void sl__audio_stream_thread_shutdown(void)
+void sl__audio_stream_deactivate(sl__stream_t* stream)
 {
-    if (!sl__audio.stream_thread_initialized) {
+    int index = stream->active_index;
+    if (index < 0) {
         return;
     }
 
-    /* --- Signal the thread to stop --- */
+    sl__mixer_lock();
 
-    SDL_SetAtomicInt(&sl__audio.stream_thread_should_stop, 1);
+    // Swap with the last one, the order of the active list does not matter
+    sl__stream_t* last = sl__audio.active_streams[--sl__audio.active_streams_count];
+    sl__audio.active_streams[index] = last;
+    last->active_index = index;
 
-    /* --- Wake up the thread if it's waiting --- */
+    stream->active_index = -1;
 
-    if (sl__audio.stream_condition) {
-        SDL_LockMutex(sl__audio.stream_mutex);
-        sl__audio.active_streams_count = 0;
-        SDL_SignalCondition(sl__audio.stream_condition);
-        SDL_UnlockMutex(sl__audio.stream_mutex);
+    sl__mixer_unlock();
+}
+
+static void sl__audio_stream_set_paused(sl__stream_t* stream, bool paused)
+{
+    sl__mixer_lock();
+    stream->is_paused = paused;
+    sl__mixer_unlock();
+}
+
+/* --- Decoding, run by the decoder workers --- */
+
+static size_t sl__audio_stream_frames_to_read(const sl__stream_t* stream)
+{
+    size_t frames = (size_t)stream->buffer_frames;
+    size_t current = stream->decoder.current_sample;
+
+    // A slot never crosses the loop end, the next one starts back at the
+    // loop start, which keeps loops gapless and exact to the frame
+    if (stream->should_loop && stream->loop_end > stream->loop_start) {
+        frames = (current < stream->loop_end) ? SL_MIN(frames, stream->loop_end - current) : 0;
     }
 
-    /* --- Wait for thread to finish --*/
+    return frames;
+}
 
-    if (sl__audio.stream_thread) {
-        SDL_WaitThread(sl__audio.stream_thread, NULL);
-        sl__audio.stream_thread = NULL;
+static bool sl__audio_stream_decode(sl__stream_t* stream)
+{
+    sl__decoder_t* decoder = &stream->decoder;
+
+    if (decoder->is_finished || SDL_GetAtomicInt(&stream->ring_ready) >= stream->buffer_count) {
+        return false;
+    }
+
+    if (stream->seek_pending) {
+        decoder->seek_func(decoder->handle, stream->seek_frame);
+        stream->seek_pending = false;
     }
 
-    /* --- Clean up synchronization primitives --- */
+    int slot = stream->ring_write;
+    int16_t* pcm = stream->ring_pcm + (size_t)slot * stream->buffer_frames * decoder->channels;
+
+    size_t frames_to_read = sl__audio_stream_frames_to_read(stream);
+    size_t frames_read = (frames_to_read > 0) ? decoder->decode_func(decoder->handle, pcm, frames_to_read) : 0;
 
-    if (sl__audio.stream_condition) {
-        SDL_DestroyCondition(sl__audio.stream_condition);
-        sl__audio.stream_condition = NULL;
+    if (frames_read == 0 && stream->should_loop) {
+        decoder->seek_func(decoder->handle, stream->loop_start);
+        decoder->current_sample = stream->loop_start;
+        frames_to_read = sl__audio_stream_frames_to_read(stream);
+        frames_read = (frames_to_read > 0) ? decoder->decode_func(decoder->handle, pcm, frames_to_read) : 0;
     }
 
-    if (sl__audio.stream_mutex) {
-        SDL_DestroyMutex(sl__audio.stream_mutex);
-        sl__audio.stream_mutex = NULL;
+    if (frames_read == 0) {
+        decoder->is_finished = true;
+        return false;
     }
 
-    /* --- Completed!! --- */
+    decoder->current_sample += frames_read;
 
-    sl__audio.stream_thread_initialized = false;
+    stream->ring_frames[slot] = (int)frames_read;
+    stream->ring_write = (slot + 1) % stream->buffer_count;
+
+    // Publishes the slot, the stream thread only reads counted slots
+    SDL_AddAtomicInt(&stream->ring_ready, 1);
+
+    return SDL_GetAtomicInt(&stream->ring_ready) < stream->buffer_count;
 }
 
-int sl__audio_stream_thread(void* data)
+static void sl__audio_decode_push(sl__stream_t* stream)
 {
-    (void)data; // Unused parameter
+    // NOTE: The decode mutex must be held
 
-    while (!SDL_GetAtomicInt(&sl__audio.stream_thread_should_stop))
-    {
-        SDL_LockMutex(sl__audio.stream_mutex);
+    stream->decode_next = NULL;
+    stream->decode_pending = true;
 
-        /* --- Wait for work or shutdown signal --- */
-        while (sl__audio.active_streams_count == 0 && !SDL_GetAtomicInt(&sl__audio.stream_thread_should_stop)) {
-            SDL_WaitCondition(sl__audio.stream_condition, sl__audio.stream_mutex);
-        }
+    if (sl__audio.decode_tail) sl__audio.decode_tail->decode_next = stream;
+    else sl__audio.decode_head = stream;
 
-        /* --- Check if we should exit --- */
-        if (SDL_GetAtomicInt(&sl__audio.stream_thread_should_stop)) {
-            SDL_UnlockMutex(sl__audio.stream_mutex);
-            break;
-        }
+    sl__audio.decode_tail = stream;
+}
 
-        /* --- Process all active streams --- */
-        size_t streams_to_remove[sl__audio.active_streams_count];
-        size_t remove_count = 0;
+static sl__stream_t* sl__audio_decode_pop(void)
+{
+    // NOTE: The decode mutex must be held
 
-        for (size_t i = 0; i < sl__audio.active_streams_count; i++) {
-            sl_stream_id stream_id = sl__audio.active_streams[i];
-            sl__stream_t* stream = sl__registry_get(&sl__audio.reg_streams, stream_id);
+    sl__stream_t* stream = sl__audio.decode_head;
+    if (stream == NULL) {
+        return NULL;
+    }
 
-            if (!stream) {
-                streams_to_remove[remove_count++] = i;
-                continue;
-            }
+    sl__audio.decode_head = stream->decode_next;
+    if (sl__audio.decode_head == NULL) {
+        sl__audio.decode_tail = NULL;
+    }
 
-            /* --- Check if stream is paused --- */
-            if (stream->is_paused) {
-                continue;
-            }
+    stream->decode_next = NULL;
+    stream->decode_pending = false;
 
-            /* --- Ensure decode buffer is assigned --- */
-            if (stream->assigned_buffer_index < 0) {
-                stream->assigned_buffer_index = sl__audio_stream_acquire_decode_buffer();
-                if (stream->assigned_buffer_index < 0) {
-                    sl_loge("AUDIO: Failed to acquire decode buffer for stream ID %d", stream_id);
-                    continue;
-                }
-            }
+    return stream;
+}
 
-            int16_t* decode_buffer = sl__audio.decode_buffer_pool[stream->assigned_buffer_index];
-
-            /* --- Check OpenAL source state --- */
-            ALint state;
-            alGetSourcei(stream->source, AL_SOURCE_STATE, &state);
-
-            /* --- Check how many buffers have been processed --- */
-            ALint processed = 0;
-            alGetSourcei(stream->source, AL_BUFFERS_PROCESSED, &processed);
-
-            /* --- Process completed buffers --- */
-            while (processed > 0 && !SDL_GetAtomicInt(&sl__audio.stream_thread_should_stop)) {
-                ALuint buffer;
-                alSourceUnqueueBuffers(stream->source, 1, &buffer);
-
-                if (!stream->decoder.is_finished) {
-                    // Decode more data
-                    size_t samples_to_read = SL__stream_BUFFER_SIZE / (stream->decoder.channels * sizeof(int16_t));
-                    size_t sample_read = stream->decoder.decode_func(stream->decoder.handle, decode_buffer, samples_to_read);
-
-                    if (sample_read > 0) {
-                        size_t data_size = sample_read * stream->decoder.channels * sizeof(int16_t);
-                        alBufferData(buffer, stream->decoder.format, decode_buffer, 
-                                    data_size, stream->decoder.sample_rate);
-                        alSourceQueueBuffers(stream->source, 1, &buffer);
-                        stream->decoder.current_sample += sample_read;
-                    } else {
-                        // End of file
-                        if (stream->should_loop) {
-                            // Start from the beginning
-                            stream->decoder.seek_func(stream->decoder.handle, 0);
-                            stream->decoder.current_sample = 0;
-                            stream->decoder.is_finished = false;
-
-                            // Decode again
-                            sample_read = stream->decoder.decode_func(
-                                stream->decoder.handle,
-                                decode_buffer,
-                                samples_to_read
-                            );
-
-                            if (sample_read > 0) {
-                                size_t data_size = sample_read * stream->decoder.channels * sizeof(int16_t);
-                                alBufferData(
-                                    buffer, stream->decoder.format, decode_buffer, 
-                                    data_size, stream->decoder.sample_rate
-                                );
-                                alSourceQueueBuffers(stream->source, 1, &buffer);
-                                stream->decoder.current_sample += sample_read;
-                            }
-                        } else {
-                            stream->decoder.is_finished = true;
-                        }
-                    }
-                }
-
-                processed--;
-            }
+static void sl__audio_decode_remove(sl__stream_t* stream)
+{
+    // NOTE: The decode mutex must be held
+
+    if (!stream->decode_pending) {
+        return;
+    }
 
-            /* --- Check if the source has stopped naturally --- */
-            ALint queued = 0;
-            alGetSourcei(stream->source, AL_BUFFERS_QUEUED, &queued);
+    sl__stream_t* prev = NULL;
+    for (sl__stream_t* it = sl__audio.decode_head; it != NULL; prev = it, it = it->decode_next) {
+        if (it != stream) continue;
+        if (prev) prev->decode_next = it->decode_next;
+        else sl__audio.decode_head = it->decode_next;
+        if (sl__audio.decode_tail == it) sl__audio.decode_tail = prev;
+        break;
+    }
 
-            if (queued == 0 && stream->decoder.is_finished) {
-                // No more buffers and end of file reached - stop this stream
-                streams_to_remove[remove_count++] = i;
+    stream->decode_next = NULL;
+    stream->decode_pending = false;
+}
 
-                // Release the decode buffer since we're stopping
-                if (stream->assigned_buffer_index >= 0) {
-                    sl__audio_stream_release_decode_buffer(stream->assigned_buffer_index);
-                    stream->assigned_buffer_index = -1;
-                }
+static int sl__audio_decode_worker(void* data)
+{
+    (void)data; // Unused parameter
 
-                // Rewind the stream for potential future playback
-                stream->decoder.seek_func(stream->decoder.handle, 0);
-                stream->decoder.current_sample = 0;
-                stream->decoder.is_finished = false;
+    SDL_LockMutex(sl__audio.decode_mutex);
 
-                // Pre-fill buffers for next playback
-                sl__audio_stream_prepare_buffers(stream);
-            }
-            else if (state != AL_PLAYING && !stream->is_paused && queued > 0) {
-                // Check if the source has stopped unexpectedly and restart it
-                sl_logw("AUDIO: Stream ID %d source stopped unexpectedly, restarting...", stream_id);
-                alSourcePlay(stream->source);
-            }
+    for (;;)
+    {
+        while (!sl__audio.decode_quit && sl__audio.decode_head == NULL) {
+            SDL_WaitCondition(sl__audio.decode_cond_work, sl__audio.decode_mutex);
         }
 
-        /* --- Remove finished streams from active list (in reverse order to maintain indices) --- */
-        for (int i = (int)remove_count - 1; i >= 0; i--) {
-            size_t index_to_remove = streams_to_remove[i];
-            sl_stream_id stream_id = sl__audio.active_streams[index_to_remove];
-            
-            // Shift remaining elements
-            for (size_t j = index_to_remove; j < sl__audio.active_streams_count - 1; j++) {
-                sl__audio.active_streams[j] = sl__audio.active_streams[j + 1];
-            }
-            sl__audio.active_streams_count--;
+        if (sl__audio.decode_quit) {
+            break;
         }
 
-        SDL_UnlockMutex(sl__audio.stream_mutex);
+        sl__stream_t* stream = sl__audio_decode_pop();
+        stream->decode_busy = true;
+        SDL_UnlockMutex(sl__audio.decode_mutex);
+
+        // One slot per job, a stream with room left goes back to the end of
+        // the list so that the others are not waiting behind a whole ring
+        bool has_room = sl__audio_stream_decode(stream);
+        SDL_SignalSemaphore(sl__audio.stream_wakeup);
 
-        /* --- Sleep for a short time to avoid busy waiting --- */
-        SDL_Delay(16); // ~60 FPS
+        SDL_LockMutex(sl__audio.decode_mutex);
+        stream->decode_busy = false;
+        if (has_room) {
+            sl__audio_decode_push(stream);
+        }
+        SDL_BroadcastCondition(sl__audio.decode_cond_done);
     }
 
+    SDL_UnlockMutex(sl__audio.decode_mutex);
+
     return 0;
 }
 
-void sl__audio_stream_unqueue_all_buffers(sl__stream_t* stream)
+static void sl__audio_decode_init(void)
 {
-    ALuint buffers_to_remove[SL__stream_BUFFER_COUNT];
+    // NOTE: Without workers the stream thread decodes by itself
 
-    /* --- Unqueue all processed buffers --- */
+    sl__audio.decode_mutex = SDL_CreateMutex();
+    sl__audio.decode_cond_work = SDL_CreateCondition();
+    sl__audio.decode_cond_done = SDL_CreateCondition();
+    sl__audio.decode_quit = false;
 
-    ALint processed = 0;
-    alGetSourcei(stream->source, AL_BUFFERS_PROCESSED, &processed);
-    SDL_assert(processed <= SL__stream_BUFFER_COUNT); // should never happen
-    if (processed > 0) {
-        alSourceUnqueueBuffers(stream->source, processed, buffers_to_remove);
+    if (!sl__audio.decode_mutex || !sl__audio.decode_cond_work || !sl__audio.decode_cond_done) {
+        sl_logw("AUDIO: Failed to create stream decoder synchronization objects; Streams will be decoded on the stream thread");
+        return;
     }
 
-    /*  --- Unqueue any remaining buffer --- */
+    int thread_count = SL_CLAMP(SDL_GetNumLogicalCPUCores() - 1, 1, SL__STREAM_MAX_DECODERS);
 
-    ALint queued = 0;
-    alGetSourcei(stream->source, AL_BUFFERS_QUEUED, &queued);
-    SDL_assert(queued <= SL__stream_BUFFER_COUNT); // should never happen
-    if (queued > 0) {
-        alSourceUnqueueBuffers(stream->source, queued, buffers_to_remove);
+    for (int i = 0; i < thread_count; i++) {
+        sl__audio.decode_threads[i] = SDL_CreateThread(sl__audio_decode_worker, "sl_stream_decode", NULL);
+        if (sl__audio.decode_threads[i] == NULL) {
+            sl_logw("AUDIO: Failed to create stream decoder thread; %s", SDL_GetError());
+            break;
+        }
+        sl__audio.decode_thread_count++;
     }
 }
 
-void sl__audio_stream_prepare_buffers(sl__stream_t* stream)
+static void sl__audio_decode_quit(void)
 {
-    /* --- Ensure decode buffer is assigned --- */
+    /* --- Stop the worker threads --- */
 
-    if (stream->assigned_buffer_index < 0) {
-        stream->assigned_buffer_index = sl__audio_stream_acquire_decode_buffer();
-        if (stream->assigned_buffer_index < 0) {
-            sl_loge("AUDIO: Failed to acquire decode buffer for stream preparation");
-            return;
-        }
+    if (sl__audio.decode_mutex) {
+        SDL_LockMutex(sl__audio.decode_mutex);
+        sl__audio.decode_quit = true;
+        SDL_BroadcastCondition(sl__audio.decode_cond_work);
+        SDL_UnlockMutex(sl__audio.decode_mutex);
+    }
+
+    for (int i = 0; i < sl__audio.decode_thread_count; i++) {
+        SDL_WaitThread(sl__audio.decode_threads[i], NULL);
+        sl__audio.decode_threads[i] = NULL;
     }
 
-    int16_t* decode_buffer = sl__audio.decode_buffer_pool[stream->assigned_buffer_index];
+    sl__audio.decode_thread_count = 0;
 
-    /* --- Fill buffers with decoded audio data --- */
+    /* --- Drop the jobs left --- */
 
-    for (int i = 0; i < SL__stream_BUFFER_COUNT; i++)
-    {
-        size_t samples_to_read = SL__stream_BUFFER_SIZE / (stream->decoder.channels * sizeof(int16_t));
-        size_t sample_read = stream->decoder.decode_func(stream->decoder.handle, decode_buffer, samples_to_read);
-        if (sample_read == 0) {
-            break;
-        }
+    while (sl__audio_decode_pop() != NULL);
 
-        size_t data_size = sample_read * stream->decoder.channels * sizeof(int16_t);
-        alBufferData(
-            stream->buffers[i], stream->decoder.format,
-            decode_buffer, data_size,
-            stream->decoder.sample_rate
-        );
-        alSourceQueueBuffers(stream->source, 1, &stream->buffers[i]);
-        stream->decoder.current_sample += sample_read;
-    }
-}
+    /* --- Release synchronization objects --- */
 
-static size_t sl__decoder_wav_decode_samples(void* handle, void* buffer, size_t samples)
-{
-    drwav* wav = (drwav*)handle;
-    return drwav_read_pcm_frames_s16(wav, samples, (drwav_int16*)buffer);
+    if (sl__audio.decode_cond_done) SDL_DestroyCondition(sl__audio.decode_cond_done);
+    if (sl__audio.decode_cond_work) SDL_DestroyCondition(sl__audio.decode_cond_work);
+    if (sl__audio.decode_mutex) SDL_DestroyMutex(sl__audio.decode_mutex);
+
+    sl__audio.decode_cond_done = NULL;
+    sl__audio.decode_cond_work = NULL;
+    sl__audio.decode_mutex = NULL;
 }
 
-static void sl__decoder_wav_seek_sample(void* handle, size_t sample)
+/* --- Decoding requests, run by the stream thread --- */
+
+static bool sl__audio_stream_request_decode(sl__stream_t* stream)
 {
-    drwav* wav = (drwav*)handle;
-    drwav_seek_to_pcm_frame(wav, sample);
-}
+    /* --- No worker, decode here --- */
+
+    if (sl__audio.decode_thread_count == 0) {
+        while (sl__audio_stream_decode(stream));
+        return !stream->decoder.is_finished;
+    }
+
+    /* --- Queue a job if the ring has room --- */
+
+    // NOTE: Returns false once the decoder reached the end
+    //       and nothing else is going to be decoded
+
+    bool has_more = true;
+
+    SDL_LockMutex(sl__audio.decode_mutex);
+
+    if (!stream->decode_busy && !stream->decode_pending) {
+        if (stream->decoder.is_finished) {
+            has_more = false;
+        }
+        else if (SDL_GetAtomicInt(&stream->ring_ready) < stream->buffer_count) {
+            sl__audio_decode_push(stream);
+            SDL_SignalCondition(sl__audio.decode_cond_work);
+        }
+    }
+
+    SDL_UnlockMutex(sl__audio.decode_mutex);
+
+    return has_more;
+}
+
+static void sl__audio_stream_claim(sl__stream_t* stream)
+{
+    // Takes the decoder and the ring back from the workers,
+    // waiting for the slot being decoded if there is one
+
+    if (sl__audio.decode_thread_count == 0) {
+        return;
+    }
+
+    SDL_LockMutex(sl__audio.decode_mutex);
+
+    while (stream->decode_busy) {
+        SDL_WaitCondition(sl__audio.decode_cond_done, sl__audio.decode_mutex);
+    }
+
+    sl__audio_decode_remove(stream);
+
+    SDL_UnlockMutex(sl__audio.decode_mutex);
+}
+
+/* --- Playback state, run by the stream thread --- */
+
+static void sl__audio_stream_reset(sl__stream_t* stream, size_t frame)
+{
+    // NOTE: The seek itself can take a while, MP3 and OGG decode up to the
+    //       frame, it is left to the next decode which runs on a worker
+
+    sl__audio_stream_claim(stream);
+
+    stream->seek_frame = frame;
+    stream->seek_pending = true;
+    stream->decoder.current_sample = frame;
+    stream->decoder.is_finished = false;
+    stream->ring_write = 0;
+
+    sl__mixer_lock();
+
+    stream->ring_read = 0;
+    stream->ring_position = 0.0;
+    stream->ring_last[0] = 0;
+    stream->ring_last[1] = 0;
+    SDL_SetAtomicInt(&stream->ring_ready, 0);
+
+    sl__mixer_unlock();
+}
+
+static void sl__audio_stream_execute(const sl__stream_command_t* command)
+{
+    sl__stream_t* stream = command->stream;
+
+    // NOTE: The mixer starts reading once the decoders
+    //       filled slots, see sl__audio_stream_update()
+
+    switch (command->type) {
+    case SL__STREAM_CMD_PLAY:
+        if (stream->active_index < 0 && !sl__audio_stream_activate(stream)) {
+            sl_loge("AUDIO: Failed to add stream to active list");
+            SDL_SetAtomicInt(&stream->state, SL__STREAM_STOPPED);
+            break;
+        }
+        if (stream->is_paused) {
+            sl__audio_stream_set_paused(stream, false);
+        }
+        SDL_SetAtomicInt(&stream->state, SL__STREAM_PLAYING);
+        break;
+
+    case SL__STREAM_CMD_PAUSE:
+        if (stream->active_index >= 0 && !stream->is_paused) {
+            sl__audio_stream_set_paused(stream, true);
+            SDL_SetAtomicInt(&stream->state, SL__STREAM_PAUSED);
+        }
+        break;
+
+    case SL__STREAM_CMD_STOP:
+        sl__audio_stream_deactivate(stream);
+        sl__audio_stream_reset(stream, 0);
+        sl__audio_stream_request_decode(stream);  // Decode ahead for the next play
+        stream->is_paused = false;
+        SDL_SetAtomicInt(&stream->state, SL__STREAM_STOPPED);
+        break;
+
+    case SL__STREAM_CMD_REWIND:
+        sl__audio_stream_reset(stream, 0);
+        sl__audio_stream_request_decode(stream);
+        break;
+
+    case SL__STREAM_CMD_SEEK:
+        sl__audio_stream_reset(stream, command->frame);
+        sl__audio_stream_request_decode(stream);
+        break;
+
+    case SL__STREAM_CMD_LOOP:
+        sl__audio_stream_claim(stream);
+        stream->should_loop = command->flag;
+        sl__audio_stream_request_decode(stream);  // The claim dropped a queued decode
+        break;
+
+    case SL__STREAM_CMD_LOOP_POINTS:
+        sl__audio_stream_claim(stream);
+        stream->loop_start = command->frame;
+        stream->loop_end = command->frame_end;
+        sl__audio_stream_request_decode(stream);
+        break;
+
+    case SL__STREAM_CMD_DESTROY:
+        sl__audio_stream_deactivate(stream);
+        sl__audio_stream_free(stream);
+        break;
+    }
+}
+
+static bool sl__audio_stream_update(sl__stream_t* stream)
+{
+    if (stream->is_paused) {
+        return true;
+    }
+
+    /* --- Keep the decoders busy --- */
+
+    bool has_more = sl__audio_stream_request_decode(stream);
+
+    /* --- Stop once everything has been mixed --- */
+
+    if (!has_more && SDL_GetAtomicInt(&stream->ring_ready) == 0) {
+        sl__audio_stream_reset(stream, 0);  // Rewind for a future playback
+        SDL_CompareAndSwapAtomicInt(&stream->state, SL__STREAM_PLAYING, SL__STREAM_STOPPED);
+        return false;
+    }
+
+    return true;
+}
+
+bool sl__audio_stream_thread_init(void)
+{
+    if (sl__audio.stream_thread_initialized) {
+        return true;
+    }
+
+    /* --- Create the wake-up semaphore --- */
+
+    sl__audio.stream_wakeup = SDL_CreateSemaphore(0);
+    if (!sl__audio.stream_wakeup) {
+        sl_loge("AUDIO: Failed to create stream wake-up semaphore");
+        return false;
+    }
+
+    /* --- Allocate the thread owned state --- */
+
+    sl__audio.active_streams_capacity = 8;
+    sl__audio.active_streams_count = 0;
+    sl__audio.active_streams = SDL_malloc(sl__audio.active_streams_capacity * sizeof(sl__stream_t*));
+
+    if (!sl__audio.active_streams) {
+        sl_loge("AUDIO: Failed to allocate stream thread state");
+        sl__audio_stream_thread_shutdown();
+        return false;
+    }
+
+    /* --- Create the command queue --- */
+
+    if (!sl__audio_queue_create(&sl__audio.stream_commands, SL__STREAM_COMMAND_QUEUE_SIZE, sizeof(sl__stream_command_t))) {
+        sl_loge("AUDIO: Failed to create stream command queue");
+        sl__audio_stream_thread_shutdown();
+        return false;
+    }
+
+    /* --- Offline, sl_audio_render() runs the commands and decodes --- */
+
+    if (sl__audio.offline) {
+        sl__audio.stream_thread_initialized = true;
+        return true;
+    }
+
+    /* --- Start the decoder workers --- */
+
+    sl__audio_decode_init();
+
+    /* --- Initialize atomic flag --- */
+
+    SDL_SetAtomicInt(&sl__audio.stream_thread_should_stop, 0);
+
+    /* --- Create and start the thread --- */
+
+    sl__audio.stream_thread = SDL_CreateThread(sl__audio_stream_thread, "streamStreamThread", NULL);
+    if (!sl__audio.stream_thread) {
+        sl_loge("AUDIO: Failed to create stream streaming thread");
+        sl__audio_stream_thread_shutdown();
+        return false;
+    }
+
+    /* --- Ready to dance! --- */
+
+    sl__audio.stream_thread_initialized = true;
+
+    return true;
+}
+
+void sl__audio_stream_thread_shutdown(void)
+{
+    /* --- Signal the thread to stop and wait for it --- */
+
+    if (sl__audio.stream_thread) {
+        SDL_SetAtomicInt(&sl__audio.stream_thread_should_stop, 1);
+        SDL_SignalSemaphore(sl__audio.stream_wakeup);
+        SDL_WaitThread(sl__audio.stream_thread, NULL);
+        sl__audio.stream_thread = NULL;
+    }
+
+    /* --- Offline, the commands posted since the last render run here --- */
+
+    if (sl__audio.offline && sl__audio.stream_thread_initialized) {
+        sl__stream_command_t command;
+        while (sl__audio_queue_pop(&sl__audio.stream_commands, &command)) {
+            sl__audio_stream_execute(&command);
+        }
+    }
+
+    /* --- Stop the decoder workers, nothing schedules them anymore --- */
+
+    sl__audio_decode_quit();
+
+    /* --- Release the thread owned state --- */
+
+    if (sl__audio.stream_wakeup) {
+        SDL_DestroySemaphore(sl__audio.stream_wakeup);
+        sl__audio.stream_wakeup = NULL;
+    }
+
+    if (sl__audio.active_streams) {
+        sl__mixer_lock();
+        for (int i = 0; i < sl__audio.active_streams_count; i++) {
+            sl__audio.active_streams[i]->active_index = -1;
+        }
+        SDL_free(sl__audio.active_streams);
+        sl__audio.active_streams = NULL;
+        sl__audio.active_streams_count = 0;
+        sl__mixer_unlock();
+    }
+
+    sl__audio_queue_destroy(&sl__audio.stream_commands);
+
+    /* --- Completed!! --- */
+
+    sl__audio.stream_thread_initialized = false;
+}
+
+int sl__audio_stream_thread(void* data)
+{
+    (void)data; // Unused parameter
+
+    // Refills are due as soon as a buffer is played, short buffers
+    // leave little room for the scheduler to be late on this thread
+    SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    // NOTE: Nothing here is shared with the API under a lock. Commands are
+    //       received through the queue, streams are only touched here once
+    //       handed over, and the thread sleeps on the semaphore until either
+    //       a command is posted, a decoder worker has filled a slot, or the
+    //       mixer has emptied one. Decoding happens on the workers, this
+    //       thread only schedules them and ends the streams played through.
+
+    while (true)
+    {
+        /* --- Execute pending commands --- */
+
+        sl__stream_command_t command;
+        while (sl__audio_queue_pop(&sl__audio.stream_commands, &command)) {
+            sl__audio_stream_execute(&command);
+        }
+
+        if (SDL_GetAtomicInt(&sl__audio.stream_thread_should_stop)) {
+            break;
+        }
+
+        /* --- Nothing to stream, sleep until the next command --- */
+
+        if (sl__audio.active_streams_count == 0) {
+            SDL_WaitSemaphore(sl__audio.stream_wakeup);
+            continue;
+        }
+
+        /* --- Refill active streams --- */
+
+        for (int i = 0; i < sl__audio.active_streams_count;) {
+            sl__stream_t* stream = sl__audio.active_streams[i];
+            if (sl__audio_stream_update(stream)) i++;
+            else sl__audio_stream_deactivate(stream);
+        }
+
+        SDL_WaitSemaphoreTimeout(sl__audio.stream_wakeup, SL__STREAM_WAIT_MAX_MS);
+    }
+
+    return 0;
+}
+
+void sl__audio_stream_desc_resolve(sl_stream_desc_t* out, const sl_stream_desc_t* desc)
+{
+    sl_stream_latency_t latency = desc ? desc->latency : SL_STREAM_LATENCY_DEFAULT;
+
+    /* --- Start from the preset --- */
+
+    switch (latency) {
+    case SL_STREAM_LATENCY_LOW:
+        out->buffer_count = 4;
+        out->buffer_duration = 0.02f;
+        break;
+    case SL_STREAM_LATENCY_DEFAULT:
+    default:
+        latency = SL_STREAM_LATENCY_DEFAULT;
+        out->buffer_count = 3;
+        out->buffer_duration = 0.185f;
+        break;
+    }
+
+    out->latency = latency;
+
+    /* --- Override with the given values --- */
+
+    if (desc && desc->buffer_count > 0) {
+        out->buffer_count = SL_CLAMP(desc->buffer_count, SL__STREAM_MIN_BUFFERS, SL__STREAM_MAX_BUFFERS);
+    }
+
+    if (desc && desc->buffer_duration > 0.0f) {
+        out->buffer_duration = SL_CLAMP(desc->buffer_duration, SL__STREAM_MIN_DURATION, SL__STREAM_MAX_DURATION);
+    }
+}
+
+bool sl__audio_stream_post(sl__stream_command_type_t type, sl__stream_t* stream, bool flag)
+{
+    sl__stream_command_t command = {
+        .type = type,
+        .stream = stream,
+        .flag = flag
+    };
+
+    return sl__audio_stream_post_command(&command);
+}
+
+bool sl__audio_stream_post_command(const sl__stream_command_t* command)
+{
+    if (!sl__audio_stream_thread_init()) {
+        sl_loge("AUDIO: Failed to initialize stream streaming thread");
+        return false;
+    }
+
+    while (!sl__audio_queue_push(&sl__audio.stream_commands, command)) {
+        // Queue full, offline the commands are executed right away,
+        // otherwise let the stream thread catch up
+        if (sl__audio.offline) {
+            sl__stream_command_t pending;
+            while (sl__audio_queue_pop(&sl__audio.stream_commands, &pending)) {
+                sl__audio_stream_execute(&pending);
+            }
+            continue;
+        }
+        SDL_SignalSemaphore(sl__audio.stream_wakeup);
+        SDL_Delay(1);
+    }
+
+    SDL_SignalSemaphore(sl__audio.stream_wakeup);
+
+    return true;
+}
+
+void sl__audio_stream_free(sl__stream_t* stream)
+{
+    /* --- Take the decoder back from the workers --- */
+
+    // NOTE: The stream is out of the active list, the mixer no longer reads it
+
+    sl__audio_stream_claim(stream);
+
+    /* --- Close the decoder and its file --- */
+
+    sl__audio_stream_decoder_close(&stream->decoder);
+
+    SDL_free(stream->ring_pcm);
+    SDL_free(stream);
+}
+
+/* --- Mixing, run by the mixer --- */
+
+bool sl__audio_stream_render(sl__stream_t* stream, float* out, int frames)
+{
+    // NOTE: Decoded slots are resampled to the mixer rate and added to 'out'.
+    //       An empty ring is left to the stream thread, which tells an underrun
+    //       from the end. Offline, decoding and ending happen right here, so
+    //       that a render only depends on the calls made.
+
+    const sl__decoder_t* decoder = &stream->decoder;
+    int channels = decoder->channels;
+
+    Uint32 bits = SDL_GetAtomicU32(&stream->gain);
+    float gain;
+    SDL_memcpy(&gain, &bits, sizeof(gain));
+    gain *= 1.0f / 32768.0f;
+
+    double step = (double)decoder->sample_rate / SL__MIXER_SAMPLE_RATE;
+    double position = stream->ring_position;
+
+    for (int i = 0; i < frames;)
+    {
+        /* --- Wait for the decoders once the ring is empty --- */
+
+        if (SDL_GetAtomicInt(&stream->ring_ready) == 0) {
+            if (!sl__audio.offline) {
+                break;
+            }
+            sl__audio_stream_request_decode(stream);
+            if (SDL_GetAtomicInt(&stream->ring_ready) == 0) {
+                sl__audio_stream_reset(stream, 0);  // Rewind for a future playback
+                SDL_CompareAndSwapAtomicInt(&stream->state, SL__STREAM_PLAYING, SL__STREAM_STOPPED);
+                return false;
+            }
+        }
+
+        int slot = stream->ring_read;
+        int slot_frames = stream->ring_frames[slot];
+        const int16_t* pcm = stream->ring_pcm + (size_t)slot * stream->buffer_frames * channels;
+
+        /* --- Hand the slot back to the decoders once it is read --- */
+
+        if (position >= slot_frames) {
+            const int16_t* last = pcm + (size_t)(slot_frames - 1) * channels;
+            stream->ring_last[0] = last[0];
+            stream->ring_last[1] = last[channels - 1];
+            stream->ring_read = (slot + 1) % stream->buffer_count;
+            SDL_AddAtomicInt(&stream->ring_ready, -1);
+            if (!sl__audio.offline) SDL_SignalSemaphore(sl__audio.stream_wakeup);
+            position -= slot_frames;
+            continue;
+        }
+
+        /* --- Linear interpolation, one frame behind to never read ahead of the slot --- */
+
+        for (; i < frames && position < slot_frames; i++, position += step) {
+            int index = (int)position;
+            float t = (float)(position - index);
+            const int16_t* cur = pcm + (size_t)index * channels;
+            const int16_t* prev = (index > 0) ? cur - channels : stream->ring_last;
+            float l = (float)prev[0] + ((float)cur[0] - (float)prev[0]) * t;
+            float r = (float)prev[channels - 1] + ((float)cur[channels - 1] - (float)prev[channels - 1]) * t;
+            out[2 * i + 0] += l * gain;
+            out[2 * i + 1] += r * gain;
+        }
+    }
+
+    stream->ring_position = position;
+
+    return true;
+}
+
+/* === Decoder Functions === */
+
+// NOTE: Decoders read their file as they go through SDL_IOStream, with
+//       read callbacks for dr_libs and pushed blocks for stb_vorbis.
+//       Only the decoder state and its own read buffers stay in memory,
+//       whatever the length of the track.
+
+static size_t sl__decoder_io_read(void* user_data, void* buffer, size_t bytes)
+{
+    return SDL_ReadIO((SDL_IOStream*)user_data, buffer, bytes);
+}
+
+static bool sl__decoder_io_seek(void* user_data, int offset, bool from_start)
+{
+    return SDL_SeekIO((SDL_IOStream*)user_data, offset, from_start ? SDL_IO_SEEK_SET : SDL_IO_SEEK_CUR) >= 0;
+}
+
+static drwav_bool32 sl__decoder_wav_io_seek(void* user_data, int offset, drwav_seek_origin origin)
+{
+    return sl__decoder_io_seek(user_data, offset, origin == drwav_seek_origin_start);
+}
+
+static drflac_bool32 sl__decoder_flac_io_seek(void* user_data, int offset, drflac_seek_origin origin)
+{
+    return sl__decoder_io_seek(user_data, offset, origin == drflac_seek_origin_start);
+}
+
+static drmp3_bool32 sl__decoder_mp3_io_seek(void* user_data, int offset, drmp3_seek_origin origin)
+{
+    SDL_IOWhence whence = SDL_IO_SEEK_CUR;
+    if (origin == drmp3_seek_origin_start) whence = SDL_IO_SEEK_SET;
+    else if (origin == drmp3_seek_origin_end) whence = SDL_IO_SEEK_END;
+    return SDL_SeekIO((SDL_IOStream*)user_data, offset, whence) >= 0;
+}
+
+static drmp3_bool32 sl__decoder_mp3_io_tell(void* user_data, drmp3_int64* cursor)
+{
+    Sint64 position = SDL_TellIO((SDL_IOStream*)user_data);
+    if (position < 0) return DRMP3_FALSE;
+    *cursor = position;
+    return DRMP3_TRUE;
+}
+
+static size_t sl__decoder_wav_decode_samples(void* handle, void* buffer, size_t samples)
+{
+    drwav* wav = (drwav*)handle;
+    return drwav_read_pcm_frames_s16(wav, samples, (drwav_int16*)buffer);
+}
+
+static void sl__decoder_wav_seek_sample(void* handle, size_t sample)
+{
+    drwav* wav = (drwav*)handle;
+    drwav_seek_to_pcm_frame(wav, sample);
+}
 
 static void sl__decoder_wav_close(void* handle)
 {
-    drwav* wav = (drwav*)handle;
-    drwav_uninit(wav);
-    SDL_free(wav);
+    drwav* wav = (drwav*)handle;
+    drwav_uninit(wav);
+    SDL_free(wav);
+}
+
+static size_t sl__decoder_flac_decode_samples(void* handle, void* buffer, size_t samples)
+{
+    drflac* flac = (drflac*)handle;
+    return drflac_read_pcm_frames_s16(flac, samples, (drflac_int16*)buffer);
+}
+
+static void sl__decoder_flac_seek_sample(void* handle, size_t sample)
+{
+    drflac* flac = (drflac*)handle;
+    drflac_seek_to_pcm_frame(flac, sample);
+}
+
+static void sl__decoder_flac_close(void* handle)
+{
+    drflac* flac = (drflac*)handle;
+    drflac_close(flac);
+}
+
+/* --- MP3, with its own seek table --- */
+
+// NOTE: drmp3_calculate_seek_points() lands up to a few MP3 frames late,
+//       after a seek the decoder silently drops the first frames that
+//       borrow bits from frames it did not decode. The exact table built
+//       below reads dr_mp3 internals for that (its stream cursor, the
+//       frames left in the current MP3 frame and its header-only frame
+//       walk), so it is only built against the dr_mp3 release it was
+//       checked with, 0.7.0. Any other release, patch releases included,
+//       binds the public seek points as is.
+
+#if DRMP3_VERSION_MAJOR == 0 && DRMP3_VERSION_MINOR == 7 && DRMP3_VERSION_REVISION == 0
+#   define SL__DECODER_MP3_EXACT_SEEK
+#endif
+
+typedef struct {
+    drmp3 mp3;
+    drmp3_seek_point* seek_points;  ///< Bound to the decoder, NULL when seeks decode from the start
+    drmp3_uint32 seek_point_count;
+} sl__decoder_mp3_t;
+
+static size_t sl__decoder_mp3_decode_samples(void* handle, void* buffer, size_t samples)
+{
+    sl__decoder_mp3_t* mp3 = (sl__decoder_mp3_t*)handle;
+    return drmp3_read_pcm_frames_s16(&mp3->mp3, samples, (drmp3_int16*)buffer);
+}
+
+static void sl__decoder_mp3_seek_sample(void* handle, size_t sample)
+{
+    sl__decoder_mp3_t* mp3 = (sl__decoder_mp3_t*)handle;
+
+#ifdef SL__DECODER_MP3_EXACT_SEEK
+    // Seek points count the encoder delay that reading skips
+    drmp3_uint64 frame = sample + mp3->mp3.delayInPCMFrames;
+
+    if (mp3->seek_point_count == 0 || frame < mp3->seek_points[0].pcmFrameIndex) {
+        drmp3_seek_to_pcm_frame(&mp3->mp3, 0);
+        drmp3_read_pcm_frames_s16(&mp3->mp3, sample, NULL);
+        return;
+    }
+
+    drmp3_seek_to_pcm_frame(&mp3->mp3, frame);
+#else
+    drmp3_seek_to_pcm_frame(&mp3->mp3, sample);
+#endif
+}
+
+static void sl__decoder_mp3_close(void* handle)
+{
+    sl__decoder_mp3_t* mp3 = (sl__decoder_mp3_t*)handle;
+    drmp3_uninit(&mp3->mp3);
+    SDL_free(mp3->seek_points);
+    SDL_free(mp3);
+}
+
+/* --- OGG, fed to stb_vorbis through its pushdata API --- */
+
+// NOTE: stb_vorbis only pulls from memory or stdio, its pushdata API is
+//       fed from the SDL stream instead so OGG reads go through SDL like
+//       the other formats. It decodes one Vorbis frame at a time, kept
+//       here until the stream has taken all of its samples.
+
+typedef struct {
+    stb_vorbis* vorbis;
+    SDL_IOStream* io;               ///< Owned by the decoder, not closed here
+    uint8_t* data;                  ///< File bytes read but not consumed by stb_vorbis yet
+    Sint64 data_offset;             ///< File offset of the first byte of 'data'
+    int data_size;
+    int data_capacity;
+    bool end_of_file;
+    Sint64 data_start;              ///< File offset of the first audio page
+    Sint64 file_size;
+    int channels;
+    int sample_rate;
+    size_t total_samples;
+    float** frame;                  ///< Last decoded frame, one buffer per channel, owned by stb_vorbis
+    int frame_count;
+    int frame_offset;               ///< Samples of the frame already returned
+} sl__decoder_ogg_t;
+
+static bool sl__decoder_ogg_fill(sl__decoder_ogg_t* ogg)
+{
+    if (ogg->end_of_file) return false;
+
+    if (ogg->data_capacity - ogg->data_size < SL__DECODER_OGG_READ_SIZE) {
+        int capacity = SL_MAX(2 * ogg->data_capacity, ogg->data_size + SL__DECODER_OGG_READ_SIZE);
+        void* data = SDL_realloc(ogg->data, capacity);
+        if (!data) return false;
+        ogg->data = data;
+        ogg->data_capacity = capacity;
+    }
+
+    size_t read = SDL_ReadIO(ogg->io, ogg->data + ogg->data_size, SL__DECODER_OGG_READ_SIZE);
+    ogg->data_size += (int)read;
+    ogg->end_of_file = (read == 0);
+
+    return read > 0;
+}
+
+static bool sl__decoder_ogg_require(sl__decoder_ogg_t* ogg, int bytes)
+{
+    while (ogg->data_size < bytes) {
+        if (!sl__decoder_ogg_fill(ogg)) return false;
+    }
+    return true;
+}
+
+static void sl__decoder_ogg_consume(sl__decoder_ogg_t* ogg, int bytes)
+{
+    ogg->data_offset += bytes;
+    ogg->data_size -= bytes;
+    SDL_memmove(ogg->data, ogg->data + bytes, ogg->data_size);
+}
+
+static bool sl__decoder_ogg_next_frame(sl__decoder_ogg_t* ogg)
+{
+    ogg->frame_count = ogg->frame_offset = 0;
+
+    // Bytes are used without output while stb_vorbis resyncs or skips
+    // the first frame, and none are used until a whole packet is there
+    while (true) {
+        int samples = 0;
+        int used = stb_vorbis_decode_frame_pushdata(ogg->vorbis, ogg->data, ogg->data_size, NULL, &ogg->frame, &samples);
+        sl__decoder_ogg_consume(ogg, used);
+
+        if (samples > 0) {
+            ogg->frame_count = samples;
+            return true;
+        }
+
+        if (used == 0 && !sl__decoder_ogg_fill(ogg)) {
+            return false;
+        }
+    }
+}
+
+static bool sl__decoder_ogg_restart(sl__decoder_ogg_t* ogg)
+{
+    if (ogg->vorbis) {
+        stb_vorbis_close(ogg->vorbis);
+        ogg->vorbis = NULL;
+    }
+
+    if (SDL_SeekIO(ogg->io, 0, SDL_IO_SEEK_SET) < 0) {
+        return false;
+    }
+
+    ogg->data_offset = 0;
+    ogg->data_size = 0;
+    ogg->end_of_file = false;
+    ogg->frame_count = ogg->frame_offset = 0;
+
+    // Headers can carry large comments, the file is read until they fit
+    while (sl__decoder_ogg_fill(ogg)) {
+        int consumed = 0, error = 0;
+        ogg->vorbis = stb_vorbis_open_pushdata(ogg->data, ogg->data_size, &consumed, &error, NULL);
+        if (ogg->vorbis) {
+            sl__decoder_ogg_consume(ogg, consumed);
+            ogg->data_start = consumed;
+            return true;
+        }
+        if (error != VORBIS_need_more_data) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+static int sl__decoder_ogg_page_size(const uint8_t* page)
+{
+    int size = 27 + page[26];
+    for (int i = 0; i < page[26]; i++) {
+        size += page[27 + i];
+    }
+    return size;
+}
+
+static bool sl__decoder_ogg_is_page(const uint8_t* data)
+{
+    return SDL_memcmp(data, "OggS", 4) == 0 && data[4] == 0;
+}
+
+static bool sl__decoder_ogg_resync(sl__decoder_ogg_t* ogg, Sint64 offset, size_t* position)
+{
+    // NOTE: After a flush stb_vorbis takes the position of the first page
+    //       it finds as is, which is off by up to a quarter of a long block
+    //       when that page ends on a long block followed by a short one.
+    //       It recomputes it at the end of each following page, so the
+    //       position is only trusted once a page ending a packet is passed.
+
+    if (SDL_SeekIO(ogg->io, offset, SDL_IO_SEEK_SET) < 0) {
+        return false;
+    }
+
+    ogg->data_offset = offset;
+    ogg->data_size = 0;
+    ogg->end_of_file = false;
+
+    /* --- Align the data on the next page --- */
+
+    while (true) {
+        if (!sl__decoder_ogg_require(ogg, 5)) return false;
+
+        int i = 0;
+        while (i + 5 <= ogg->data_size && !sl__decoder_ogg_is_page(ogg->data + i)) i++;
+
+        if (i + 5 <= ogg->data_size) {
+            sl__decoder_ogg_consume(ogg, i);
+            break;
+        }
+
+        // The last bytes are kept, a capture pattern can straddle two reads
+        sl__decoder_ogg_consume(ogg, ogg->data_size - 4);
+    }
+
+    /* --- Find the end of the first page after it that ends a packet --- */
+
+    Sint64 trusted_offset = 0;
+
+    for (int page = 0; trusted_offset == 0; ) {
+        if (!sl__decoder_ogg_require(ogg, page + 27) ||
+            !sl__decoder_ogg_require(ogg, page + 27 + ogg->data[page + 26])) {
+            return false;
+        }
+
+        const uint8_t* header = ogg->data + page;
+        if (!sl__decoder_ogg_is_page(header)) return false;
+
+        // A granule position of -1 marks a page on which no packet ends
+        bool ends_packet = false;
+        for (int i = 6; i < 14; i++) {
+            ends_packet |= (header[i] != 0xFF);
+        }
+
+        int size = sl__decoder_ogg_page_size(header);
+        if (page > 0 && ends_packet) {
+            trusted_offset = ogg->data_offset + page + size;
+        }
+
+        page += size;
+    }
+
+    /* --- Decode up to it --- */
+
+    stb_vorbis_flush_pushdata(ogg->vorbis);
+
+    while (sl__decoder_ogg_next_frame(ogg)) {
+        int next = stb_vorbis_get_sample_offset(ogg->vorbis);
+        if (ogg->data_offset >= trusted_offset && next >= ogg->frame_count) {
+            *position = next - ogg->frame_count;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static size_t sl__decoder_ogg_read_length(sl__decoder_ogg_t* ogg)
+{
+    // NOTE: The length is the granule position of the last page, found
+    //       from the end of the file as the page that ends exactly there
+
+    Sint64 tail_size = SL_MIN(ogg->file_size, (Sint64)SL__DECODER_OGG_TAIL_SIZE);
+    if (tail_size < 27) return 0;
+
+    uint8_t* tail = SDL_malloc(tail_size);
+    if (!tail) return 0;
+
+    size_t length = 0;
+
+    if (SDL_SeekIO(ogg->io, ogg->file_size - tail_size, SDL_IO_SEEK_SET) >= 0 &&
+        SDL_ReadIO(ogg->io, tail, tail_size) == (size_t)tail_size) {
+        for (Sint64 i = tail_size - 27; i >= 0; i--) {
+            if (!sl__decoder_ogg_is_page(tail + i) || i + 27 + tail[i + 26] > tail_size) continue;
+            if (i + sl__decoder_ogg_page_size(tail + i) == tail_size) {
+                length = tail[i + 6] | (tail[i + 7] << 8) | (tail[i + 8] << 16) | ((uint32_t)tail[i + 9] << 24);
+                break;
+            }
+        }
+    }
+
+    SDL_free(tail);
+
+    return length;
+}
+
+static size_t sl__decoder_ogg_decode_samples(void* handle, void* buffer, size_t samples)
+{
+    sl__decoder_ogg_t* ogg = (sl__decoder_ogg_t*)handle;
+    int16_t* out = (int16_t*)buffer;
+    size_t written = 0;
+
+    while (written < samples) {
+        if (ogg->frame_offset == ogg->frame_count && !sl__decoder_ogg_next_frame(ogg)) {
+            break;
+        }
+
+        int count = (int)SL_MIN((size_t)(ogg->frame_count - ogg->frame_offset), samples - written);
+
+        for (int i = 0; i < count; i++) {
+            for (int c = 0; c < ogg->channels; c++) {
+                int value = (int)lrintf(ogg->frame[c][ogg->frame_offset + i] * 32768.0f);  // Rounded like stb_vorbis does
+                *out++ = (int16_t)SL_CLAMP(value, -32768, 32767);
+            }
+        }
+
+        ogg->frame_offset += count;
+        written += count;
+    }
+
+    return written;
+}
+
+static void sl__decoder_ogg_seek_sample(void* handle, size_t sample)
+{
+    sl__decoder_ogg_t* ogg = (sl__decoder_ogg_t*)handle;
+
+    /* --- Land on a page a little before the target --- */
+
+    // NOTE: Probes interpolate between the nearest known positions on
+    //       each side, until one lands less than a second before the
+    //       target. The start is never probed, a resync there would skip
+    //       the first page, the decoder is reopened instead.
+
+    Sint64 low_offset = ogg->data_start, high_offset = ogg->file_size;
+    size_t low_sample = 0, high_sample = SL_MAX(ogg->total_samples, sample + 1);
+    size_t position = 0;
+    bool on_low = false;
+
+    for (int i = 0; i < SL__DECODER_OGG_SEEK_PROBES && sample - low_sample > (size_t)ogg->sample_rate; i++) {
+        double ratio = (double)(sample - low_sample) / (double)(high_sample - low_sample);
+        Sint64 offset = low_offset + (Sint64)(ratio * (double)(high_offset - low_offset)) - SL__DECODER_OGG_PAGE_SIZE;
+        if (offset <= low_offset) break;
+
+        on_low = sl__decoder_ogg_resync(ogg, offset, &position) && position <= sample;
+        if (on_low) {
+            low_offset = offset;
+            low_sample = position;
+        }
+        else {
+            high_offset = offset;
+            high_sample = SL_MAX(SL_MIN(position, high_sample), sample + 1);
+        }
+    }
+
+    if (!on_low) {
+        position = low_sample;
+        if (low_offset == ogg->data_start) {
+            if (!sl__decoder_ogg_restart(ogg)) return;
+        }
+        else if (!sl__decoder_ogg_resync(ogg, low_offset, &position)) {
+            return;
+        }
+    }
+
+    /* --- Decode up to the exact sample --- */
+
+    while (position + (ogg->frame_count - ogg->frame_offset) <= sample) {
+        position += ogg->frame_count - ogg->frame_offset;
+        if (!sl__decoder_ogg_next_frame(ogg)) return;
+    }
+
+    ogg->frame_offset += (int)(sample - position);
 }
 
-static size_t sl__decoder_flac_decode_samples(void* handle, void* buffer, size_t samples)
+static void sl__decoder_ogg_close(void* handle)
 {
-    drflac* flac = (drflac*)handle;
-    return drflac_read_pcm_frames_s16(flac, samples, (drflac_int16*)buffer);
+    sl__decoder_ogg_t* ogg = (sl__decoder_ogg_t*)handle;
+    if (ogg->vorbis) stb_vorbis_close(ogg->vorbis);
+    SDL_free(ogg->data);
+    SDL_free(ogg);
 }
 
-static void sl__decoder_flac_seek_sample(void* handle, size_t sample)
+static bool sl__decoder_open_wav(sl__decoder_t* decoder)
 {
-    drflac* flac = (drflac*)handle;
-    drflac_seek_to_pcm_frame(flac, sample);
+    drwav* wav = (drwav*)SDL_malloc(sizeof(drwav));
+    if (!wav) return false;
+
+    if (!drwav_init(wav, sl__decoder_io_read, sl__decoder_wav_io_seek, decoder->io, NULL)) {
+        SDL_free(wav);
+        return false;
+    }
+
+    decoder->handle = wav;
+    decoder->channels = wav->channels;
+    decoder->sample_rate = wav->sampleRate;
+    decoder->total_samples = wav->totalPCMFrameCount;
+    decoder->decode_func = sl__decoder_wav_decode_samples;
+    decoder->seek_func = sl__decoder_wav_seek_sample;
+    decoder->close_func = sl__decoder_wav_close;
+
+    return true;
 }
 
-static void sl__decoder_flac_close(void* handle)
+static bool sl__decoder_open_flac(sl__decoder_t* decoder)
 {
-    drflac* flac = (drflac*)handle;
-    drflac_close(flac);
+    drflac* flac = drflac_open(sl__decoder_io_read, sl__decoder_flac_io_seek, decoder->io, NULL);
+    if (!flac) return false;
+
+    decoder->handle = flac;
+    decoder->channels = flac->channels;
+    decoder->sample_rate = flac->sampleRate;
+    decoder->total_samples = flac->totalPCMFrameCount;
+    decoder->decode_func = sl__decoder_flac_decode_samples;
+    decoder->seek_func = sl__decoder_flac_seek_sample;
+    decoder->close_func = sl__decoder_flac_close;
+
+    return true;
 }
 
-static size_t sl__decoder_mp3_decode_samples(void* handle, void* buffer, size_t samples)
+#ifdef SL__DECODER_MP3_EXACT_SEEK
+
+static drmp3_uint64 sl__decoder_mp3_frame_pos(const drmp3* mp3)
 {
-    drmp3* mp3 = (drmp3*)handle;
-    return drmp3_read_pcm_frames_s16(mp3, samples, (drmp3_int16*)buffer);
+    return mp3->streamCursor - mp3->dataSize;  //< Byte position of the next MP3 frame
 }
 
-static void sl__decoder_mp3_seek_sample(void* handle, size_t sample)
+static drmp3_uint64 sl__decoder_mp3_read_frame(drmp3* mp3)
 {
-    drmp3* mp3 = (drmp3*)handle;
-    drmp3_seek_to_pcm_frame(mp3, sample);
+    // Reads up to the end of the current MP3 frame, decoding the next one if none is pending
+    drmp3_uint64 read = (mp3->pcmFramesRemainingInMP3Frame == 0) ? drmp3_read_pcm_frames_s16(mp3, 1, NULL) : 0;
+    return read + drmp3_read_pcm_frames_s16(mp3, mp3->pcmFramesRemainingInMP3Frame, NULL);
 }
 
-static void sl__decoder_mp3_close(void* handle)
+static void sl__decoder_mp3_build_seek_table(sl__decoder_mp3_t* decoder)
 {
-    drmp3* mp3 = (drmp3*)handle;
-    drmp3_uninit(mp3);
-    SDL_free(mp3);
+    // NOTE: Points are taken with the same header walk as
+    //       drmp3_calculate_seek_points(), then each one is replayed
+    //       once to read where it really lands.
+
+    drmp3* mp3 = &decoder->mp3;
+
+    struct { drmp3_uint64 pos, frame; } history[6] = { 0 }, *refs = NULL;
+    drmp3_seek_point* points = NULL;
+    drmp3_uint32 point_count = 0;
+    drmp3_uint32 point_capacity = 0;
+    drmp3_uint64 next_point = mp3->sampleRate;
+    drmp3_uint64 frame = 0;
+    bool failed = false;
+
+    /* --- Walk the frame headers, one point per second --- */
+
+    drmp3_seek_to_pcm_frame(mp3, 0);
+
+    for (int frame_count = 1; ; frame_count++) {
+        SDL_memmove(history, history + 1, sizeof(history) - sizeof(history[0]));
+        history[5].pos = sl__decoder_mp3_frame_pos(mp3);
+        history[5].frame = frame;
+
+        // A point restarts the decoder on history[0], history[5] is the
+        // reference frame used to check where the point really lands
+        if (frame_count >= 6 && history[1].frame >= next_point) {
+            if (point_count == point_capacity) {
+                point_capacity = (point_capacity > 0) ? 2 * point_capacity : 64;
+                void* new_points = SDL_realloc(points, point_capacity * sizeof(*points));
+                void* new_refs = SDL_realloc(refs, point_capacity * sizeof(*refs));
+                if (new_points) points = new_points;
+                if (new_refs) refs = new_refs;
+                failed = !new_points || !new_refs;
+                if (failed) break;
+            }
+            points[point_count] = (drmp3_seek_point) {
+                .seekPosInBytes = history[0].pos,
+                .pcmFrameIndex = history[1].frame,
+                .mp3FramesToDiscard = 2,
+                .pcmFramesToDiscard = 0
+            };
+            refs[point_count].pos = history[5].pos;
+            refs[point_count].frame = history[5].frame;
+            next_point += mp3->sampleRate;
+            point_count++;
+        }
+
+        // Parses the header only, nothing is synthesized
+        drmp3_uint32 frame_size = drmp3_decode_next_frame_ex(mp3, NULL, NULL, NULL);
+        if (frame_size == 0) break;
+
+        frame += frame_size;
+    }
+
+    /* --- Replay each point and fix where it lands --- */
+
+    // NOTE: The frame a point restarts on can still miss bits from the
+    //       frames before it, so it is decoded but never output, a point
+    //       only serves targets from the frame after it
+
+    if (!failed && point_count > 0) {
+        drmp3_bind_seek_table(mp3, point_count, points);
+
+        drmp3_uint32 valid_count = 0;
+        for (drmp3_uint32 i = 0; i < point_count; i++) {
+            drmp3_seek_to_pcm_frame(mp3, points[i].pcmFrameIndex);
+            drmp3_uint64 restart_size = sl__decoder_mp3_read_frame(mp3);
+            drmp3_uint64 read = restart_size;
+            for (int j = 0; j < 8 && sl__decoder_mp3_frame_pos(mp3) != refs[i].pos; j++) {
+                read += sl__decoder_mp3_read_frame(mp3);
+            }
+            if (sl__decoder_mp3_frame_pos(mp3) == refs[i].pos && read <= refs[i].frame) {
+                points[valid_count] = points[i];
+                points[valid_count].pcmFrameIndex = refs[i].frame - read + restart_size;
+                points[valid_count].pcmFramesToDiscard = (drmp3_uint16)restart_size;
+                valid_count++;
+            }
+        }
+
+        drmp3_bind_seek_table(mp3, valid_count, (valid_count > 0) ? points : NULL);
+
+        if (valid_count > 0) {
+            decoder->seek_points = points;
+            decoder->seek_point_count = valid_count;
+        }
+    }
+
+    if (decoder->seek_point_count == 0) {
+        if (failed || point_count > 0) {
+            sl_logw("AUDIO: Failed to build MP3 seek table, seeking will decode from the start");
+        }
+        SDL_free(points);
+    }
+
+    SDL_free(refs);
+
+    drmp3_seek_to_pcm_frame(mp3, 0);
 }
 
-static size_t sl__decoder_ogg_decode_samples(void* handle, void* buffer, size_t samples)
+#else
+
+static void sl__decoder_mp3_build_seek_table(sl__decoder_mp3_t* decoder)
 {
-    stb_vorbis* vorbis = (stb_vorbis*)handle;
-    int sample_read = stb_vorbis_get_samples_short_interleaved(
-        vorbis, vorbis->channels, buffer,
-        samples * vorbis->channels
-    );
-    return sample_read;
+    drmp3* mp3 = &decoder->mp3;
+
+    // One point per second, as the exact table
+    drmp3_uint32 point_count = (drmp3_uint32)(drmp3_get_pcm_frame_count(mp3) / mp3->sampleRate) + 1;
+    drmp3_seek_point* points = SDL_malloc(point_count * sizeof(*points));
+
+    if (points && drmp3_calculate_seek_points(mp3, &point_count, points) &&
+        drmp3_bind_seek_table(mp3, point_count, points)) {
+        decoder->seek_points = points;
+        decoder->seek_point_count = point_count;
+    }
+    else {
+        sl_logw("AUDIO: Failed to build MP3 seek table, seeking will decode from the start");
+        SDL_free(points);
+    }
+
+    drmp3_seek_to_pcm_frame(mp3, 0);
 }
 
-static void sl__decoder_ogg_seek_sample(void* handle, size_t sample)
+#endif // SL__DECODER_MP3_EXACT_SEEK
+
+static bool sl__decoder_open_mp3(sl__decoder_t* decoder)
 {
-    stb_vorbis* vorbis = (stb_vorbis*)handle;
-    stb_vorbis_seek(vorbis, sample);
+    sl__decoder_mp3_t* mp3 = (sl__decoder_mp3_t*)SDL_calloc(1, sizeof(sl__decoder_mp3_t));
+    if (!mp3) return false;
+
+    if (!drmp3_init(&mp3->mp3, sl__decoder_io_read, sl__decoder_mp3_io_seek, sl__decoder_mp3_io_tell, NULL, decoder->io, NULL)) {
+        SDL_free(mp3);
+        return false;
+    }
+
+    // NOTE: Counting the frames and building the seek table both walk the
+    //       whole file once, the decoder is brought back to the start afterwards
+
+    decoder->handle = mp3;
+    decoder->channels = mp3->mp3.channels;
+    decoder->sample_rate = mp3->mp3.sampleRate;
+    decoder->total_samples = drmp3_get_pcm_frame_count(&mp3->mp3);
+    decoder->decode_func = sl__decoder_mp3_decode_samples;
+    decoder->seek_func = sl__decoder_mp3_seek_sample;
+    decoder->close_func = sl__decoder_mp3_close;
+
+    sl__decoder_mp3_build_seek_table(mp3);
+
+    return true;
 }
 
-static void sl__decoder_ogg_close(void* handle)
+static bool sl__decoder_open_ogg(sl__decoder_t* decoder)
 {
-    stb_vorbis* vorbis = (stb_vorbis*)handle;
-    stb_vorbis_close(vorbis);
+    sl__decoder_ogg_t* ogg = (sl__decoder_ogg_t*)SDL_calloc(1, sizeof(sl__decoder_ogg_t));
+    if (!ogg) return false;
+
+    ogg->io = decoder->io;
+    ogg->file_size = SDL_GetIOSize(decoder->io);
+    ogg->total_samples = sl__decoder_ogg_read_length(ogg);
+
+    if (ogg->file_size <= 0 || !sl__decoder_ogg_restart(ogg)) {
+        sl__decoder_ogg_close(ogg);
+        return false;
+    }
+
+    stb_vorbis_info info = stb_vorbis_get_info(ogg->vorbis);
+    ogg->channels = info.channels;
+    ogg->sample_rate = info.sample_rate;
+
+    decoder->handle = ogg;
+    decoder->channels = info.channels;
+    decoder->sample_rate = info.sample_rate;
+    decoder->total_samples = ogg->total_samples;
+    decoder->decode_func = sl__decoder_ogg_decode_samples;
+    decoder->seek_func = sl__decoder_ogg_seek_sample;
+    decoder->close_func = sl__decoder_ogg_close;
+
+    return true;
 }
 
-bool sl__audio_stream_decoder_init(sl__decoder_t* decoder, const void* data, size_t data_size, sl__audio_format_t format)
+bool sl__audio_stream_decoder_open(sl__decoder_t* decoder, const char* file_path)
 {
-    void* dataCopy = SDL_malloc(data_size);
-    if (!dataCopy) return false;
+    SDL_memset(decoder, 0, sizeof(*decoder));
+
+    /* --- Open the file and detect its format --- */
 
-    SDL_memcpy(dataCopy, data, data_size);
+    decoder->io = SDL_IOFromFile(file_path, "rb");
+    if (!decoder->io) {
+        sl_loge("AUDIO: Failed to open stream file '%s'; %s", file_path, SDL_GetError());
+        return false;
+    }
+
+    uint8_t header[64];
+    size_t header_size = SDL_ReadIO(decoder->io, header, sizeof(header));
+    sl__audio_format_t format = sl__audio_get_format(header, header_size);
+
+    if (format == SL__AUDIO_UNKNOWN || SDL_SeekIO(decoder->io, 0, SDL_IO_SEEK_SET) < 0) {
+        sl_loge("AUDIO: Unknown or unsupported audio format in file: %s", file_path);
+        SDL_CloseIO(decoder->io);
+        decoder->io = NULL;
+        return false;
+    }
+
+    /* --- Open the decoder on top of it --- */
+
+    bool opened = false;
 
     switch (format) {
     case SL__AUDIO_WAV:
-        {
-            drwav* wav = (drwav*)SDL_malloc(sizeof(drwav));
-            if (!drwav_init_memory(wav, dataCopy, data_size, NULL)) {
-                SDL_free(wav);
-                SDL_free(dataCopy);
-                return false;
-            }
-
-            decoder->handle = wav;
-            decoder->channels = wav->channels;
-            decoder->sample_rate = wav->sampleRate;
-            decoder->total_samples = wav->totalPCMFrameCount;
-            decoder->decode_func = sl__decoder_wav_decode_samples;
-            decoder->seek_func = sl__decoder_wav_seek_sample;
-            decoder->close_func = sl__decoder_wav_close;
-        }
+        opened = sl__decoder_open_wav(decoder);
         break;
     case SL__AUDIO_FLAC:
-        {
-            drflac* flac = drflac_open_memory(dataCopy, data_size, NULL);
-            if (!flac) {
-                SDL_free(dataCopy);
-                return false;
-            }
-
-            decoder->handle = flac;
-            decoder->channels = flac->channels;
-            decoder->sample_rate = flac->sampleRate;
-            decoder->total_samples = flac->totalPCMFrameCount;
-            decoder->decode_func = sl__decoder_flac_decode_samples;
-            decoder->seek_func = sl__decoder_flac_seek_sample;
-            decoder->close_func = sl__decoder_flac_close;
-        }
+        opened = sl__decoder_open_flac(decoder);
         break;
-        
     case SL__AUDIO_MP3:
-        {
-            drmp3* mp3 = (drmp3*)SDL_malloc(sizeof(drmp3));
-            if (!drmp3_init_memory(mp3, dataCopy, data_size, NULL)) {
-                SDL_free(mp3);
-                SDL_free(dataCopy);
-                return false;
-            }
-
-            decoder->handle = mp3;
-            decoder->channels = mp3->channels;
-            decoder->sample_rate = mp3->sampleRate;
-            decoder->total_samples = drmp3_get_pcm_frame_count(mp3);
-            decoder->decode_func = sl__decoder_mp3_decode_samples;
-            decoder->seek_func = sl__decoder_mp3_seek_sample;
-            decoder->close_func = sl__decoder_mp3_close;
-        }
+        opened = sl__decoder_open_mp3(decoder);
         break;
-        
     case SL__AUDIO_OGG:
-        {
-            int error;
-            stb_vorbis* vorbis = stb_vorbis_open_memory(dataCopy, data_size, &error, NULL);
-            if (!vorbis) {
-                SDL_free(dataCopy);
-                return false;
-            }
-
-            decoder->handle = vorbis;
-            decoder->channels = vorbis->channels;
-            decoder->sample_rate = vorbis->sample_rate;
-            decoder->total_samples = stb_vorbis_stream_length_in_samples(vorbis);
-            decoder->decode_func = sl__decoder_ogg_decode_samples;
-            decoder->seek_func = sl__decoder_ogg_seek_sample;
-            decoder->close_func = sl__decoder_ogg_close;
-        }
+        opened = sl__decoder_open_ogg(decoder);
         break;
-        
     default:
-        SDL_free(dataCopy);
-        return false;
+        break;
     }
 
-    if (decoder->channels == 1) {
-        decoder->format = AL_FORMAT_MONO16;
-    }
-    else if (decoder->channels == 2) {
-        decoder->format = AL_FORMAT_STEREO16;
+    if (!opened) {
+        sl_loge("AUDIO: Failed to initialize decoder for file: %s", file_path);
+        if (decoder->io) SDL_CloseIO(decoder->io);
+        decoder->io = NULL;
+        return false;
     }
-    else {
-        decoder->close_func(decoder->handle);
-        SDL_free(dataCopy);
+
+    /* --- Only mono and stereo are streamed --- */
+
+    if (decoder->channels != 1 && decoder->channels != 2) {
+        sl_loge("AUDIO: Unsupported channel count %d for stream file: %s", decoder->channels, file_path);
+        sl__audio_stream_decoder_close(decoder);
         return false;
     }
 
@@ -1009,114 +2204,307 @@ bool sl__audio_stream_decoder_init(sl__decoder_t* decoder, const void* data, siz
     return true;
 }
 
-int sl__audio_stream_acquire_decode_buffer(void)
+void sl__audio_stream_decoder_close(sl__decoder_t* decoder)
+{
+    if (decoder->handle) {
+        decoder->close_func(decoder->handle);
+        decoder->handle = NULL;
+    }
+
+    if (decoder->io) {
+        SDL_CloseIO(decoder->io);
+        decoder->io = NULL;
+    }
+}
+
+/* === Loader Functions === */
+
+// NOTE: Loader threads are started on the first asynchronous load, one per
+//       core left by the main thread. They take the jobs in submission order
+//       and hand them back to the main thread, which finishes them during
+//       sl_frame_step(), the only place objects are completed or released.
+
+static void sl__audio_load_push(sl__load_job_t** head, sl__load_job_t** tail, sl__load_job_t* job)
+{
+    // NOTE: The load mutex must be held
+
+    job->next = NULL;
+
+    if (*tail) (*tail)->next = job;
+    else *head = job;
+
+    *tail = job;
+}
+
+static sl__load_job_t* sl__audio_load_pop(sl__load_job_t** head, sl__load_job_t** tail)
+{
+    // NOTE: The load mutex must be held
+
+    sl__load_job_t* job = *head;
+    if (job == NULL) {
+        return NULL;
+    }
+
+    *head = job->next;
+    if (*head == NULL) {
+        *tail = NULL;
+    }
+
+    job->next = NULL;
+
+    return job;
+}
+
+static int sl__audio_load_worker(void* data)
 {
-    // Find available buffer
-    for (size_t i = 0; i < sl__audio.decode_buffer_count; i++) {
-        if (!sl__audio.decode_buffer_in_use[i]) {
-            sl__audio.decode_buffer_in_use[i] = true;
-            return (int)i;
+    (void)data; // Unused parameter
+
+    SDL_LockMutex(sl__audio.load_mutex);
+
+    for (;;)
+    {
+        while (!sl__audio.load_quit && sl__audio.load_head == NULL) {
+            SDL_WaitCondition(sl__audio.load_cond_work, sl__audio.load_mutex);
         }
+
+        if (sl__audio.load_quit) {
+            break;
+        }
+
+        sl__load_job_t* job = sl__audio_load_pop(&sl__audio.load_head, &sl__audio.load_tail);
+        sl__audio.load_busy++;
+        SDL_UnlockMutex(sl__audio.load_mutex);
+
+        job->success = job->work(job);
+
+        SDL_LockMutex(sl__audio.load_mutex);
+        sl__audio.load_busy--;
+        sl__audio_load_push(&sl__audio.done_head, &sl__audio.done_tail, job);
+        SDL_BroadcastCondition(sl__audio.load_cond_done);
+    }
+
+    SDL_UnlockMutex(sl__audio.load_mutex);
+
+    return 0;
+}
+
+static void sl__audio_load_init(void)
+{
+    // NOTE: Without threads the loads are run on the calling thread
+
+    if (sl__audio.load_mutex) {
+        return;
+    }
+
+    sl__audio.load_mutex = SDL_CreateMutex();
+    sl__audio.load_cond_work = SDL_CreateCondition();
+    sl__audio.load_cond_done = SDL_CreateCondition();
+    sl__audio.load_quit = false;
+
+    if (!sl__audio.load_mutex || !sl__audio.load_cond_work || !sl__audio.load_cond_done) {
+        sl_logw("AUDIO: Failed to create loader synchronization objects; Asynchronous loads will be synchronous");
+        if (sl__audio.load_cond_done) SDL_DestroyCondition(sl__audio.load_cond_done);
+        if (sl__audio.load_cond_work) SDL_DestroyCondition(sl__audio.load_cond_work);
+        if (sl__audio.load_mutex) SDL_DestroyMutex(sl__audio.load_mutex);
+        sl__audio.load_cond_done = NULL;
+        sl__audio.load_cond_work = NULL;
+        sl__audio.load_mutex = NULL;
+        return;
     }
-    
-    // Need to create new buffer
-    if (sl__audio.decode_buffer_count >= sl__audio.decode_buffer_capacity) {
-        if (!sl__audio_stream_ensure_buffer_pool_capacity(sl__audio.decode_buffer_capacity * 2)) {
-            return -1;
+
+    int thread_count = SL_CLAMP(SDL_GetNumLogicalCPUCores() - 1, 1, SL__LOAD_MAX_THREADS);
+
+    for (int i = 0; i < thread_count; i++) {
+        sl__audio.load_threads[i] = SDL_CreateThread(sl__audio_load_worker, "sl_audio_load", NULL);
+        if (sl__audio.load_threads[i] == NULL) {
+            sl_logw("AUDIO: Failed to create loader thread; %s", SDL_GetError());
+            break;
         }
+        sl__audio.load_thread_count++;
     }
-    
-    // Allocate new buffer
-    int16_t* new_buffer = SDL_malloc(sl__audio.decode_buffer_pool_size);
-    if (!new_buffer) return -1;
-    
-    int index = (int)sl__audio.decode_buffer_count;
-    sl__audio.decode_buffer_pool[index] = new_buffer;
-    sl__audio.decode_buffer_in_use[index] = true;
-    sl__audio.decode_buffer_count++;
-    
-    return index;
 }
 
-void sl__audio_stream_release_decode_buffer(int buffer_index)
+static void sl__audio_load_finish(sl__load_job_t* job, bool notify)
 {
-    if (buffer_index >= 0 && buffer_index < (int)sl__audio.decode_buffer_count) {
-        sl__audio.decode_buffer_in_use[buffer_index] = false;
+    job->finish(job);
+
+    if (notify && job->callback && !job->cancelled) {
+        job->callback(job->id, job->success, job->user_data);
     }
+
+    SDL_free(job->file_path);
+    SDL_free(job);
+
+    sl__audio.load_pending--;
 }
 
-bool sl__audio_stream_ensure_buffer_pool_capacity(size_t needed_capacity)
+void sl__audio_load_update(void)
 {
-    if (needed_capacity <= sl__audio.decode_buffer_capacity) {
-        return true;
+    if (sl__audio.load_pending == 0) {
+        return;
+    }
+
+    /* --- Take the finished jobs --- */
+
+    // NOTE: Detached first, callbacks may submit new loads
+
+    if (sl__audio.load_mutex) SDL_LockMutex(sl__audio.load_mutex);
+
+    sl__load_job_t* job = sl__audio.done_head;
+    sl__audio.done_head = NULL;
+    sl__audio.done_tail = NULL;
+
+    if (sl__audio.load_mutex) SDL_UnlockMutex(sl__audio.load_mutex);
+
+    /* --- Complete or release their objects --- */
+
+    while (job != NULL) {
+        sl__load_job_t* next = job->next;
+        sl__audio_load_finish(job, true);
+        job = next;
     }
-    
-    // Reallocate arrays
-    int16_t** new_pool = SDL_realloc(sl__audio.decode_buffer_pool, 
-                                     needed_capacity * sizeof(int16_t*));
-    if (!new_pool) return false;
-    
-    bool* new_in_use = SDL_realloc(sl__audio.decode_buffer_in_use, 
-                                   needed_capacity * sizeof(bool));
-    if (!new_in_use) return false;
-    
-    sl__audio.decode_buffer_pool = new_pool;
-    sl__audio.decode_buffer_in_use = new_in_use;
-    
-    // Initialize new slots
-    for (size_t i = sl__audio.decode_buffer_capacity; i < needed_capacity; i++) {
-        sl__audio.decode_buffer_pool[i] = NULL;
-        sl__audio.decode_buffer_in_use[i] = false;
-    }
-    
-    sl__audio.decode_buffer_capacity = needed_capacity;
-    return true;
 }
 
-bool sl__audio_stream_add_active(sl_stream_id stream_id)
+void sl__audio_load_quit(void)
 {
-    // Vérifier si déjà présente
-    for (size_t i = 0; i < sl__audio.active_streams_count; i++) {
-        if (sl__audio.active_streams[i] == stream_id) {
-            return true; // Déjà active
-        }
+    /* --- Stop the loader threads, the running jobs are completed --- */
+
+    if (sl__audio.load_mutex) {
+        SDL_LockMutex(sl__audio.load_mutex);
+        sl__audio.load_quit = true;
+        SDL_BroadcastCondition(sl__audio.load_cond_work);
+        SDL_UnlockMutex(sl__audio.load_mutex);
     }
-    
-    // Agrandir si nécessaire
-    if (sl__audio.active_streams_count >= sl__audio.active_streams_capacity) {
-        size_t new_capacity = sl__audio.active_streams_capacity * 2;
-        sl_stream_id* new_array = SDL_realloc(sl__audio.active_streams, 
-                                             new_capacity * sizeof(sl_stream_id));
-        if (!new_array) return false;
-        
-        sl__audio.active_streams = new_array;
-        sl__audio.active_streams_capacity = new_capacity;
+
+    for (int i = 0; i < sl__audio.load_thread_count; i++) {
+        SDL_WaitThread(sl__audio.load_threads[i], NULL);
+        sl__audio.load_threads[i] = NULL;
     }
-    
-    sl__audio.active_streams[sl__audio.active_streams_count++] = stream_id;
-    return true;
+
+    sl__audio.load_thread_count = 0;
+
+    /* --- Finish every job, those not run as failed, without callbacks --- */
+
+    sl__load_job_t* job = NULL;
+
+    while ((job = sl__audio_load_pop(&sl__audio.load_head, &sl__audio.load_tail)) != NULL) {
+        job->success = false;
+        sl__audio_load_push(&sl__audio.done_head, &sl__audio.done_tail, job);
+    }
+
+    while ((job = sl__audio_load_pop(&sl__audio.done_head, &sl__audio.done_tail)) != NULL) {
+        sl__audio_load_finish(job, false);
+    }
+
+    /* --- Release synchronization objects --- */
+
+    if (sl__audio.load_cond_done) SDL_DestroyCondition(sl__audio.load_cond_done);
+    if (sl__audio.load_cond_work) SDL_DestroyCondition(sl__audio.load_cond_work);
+    if (sl__audio.load_mutex) SDL_DestroyMutex(sl__audio.load_mutex);
+
+    sl__audio.load_cond_done = NULL;
+    sl__audio.load_cond_work = NULL;
+    sl__audio.load_mutex = NULL;
 }
 
-void sl__audio_stream_remove_active(sl_stream_id stream_id)
+void sl__audio_load_submit(sl__load_job_t* job)
 {
-    for (size_t i = 0; i < sl__audio.active_streams_count; i++) {
-        if (sl__audio.active_streams[i] == stream_id) {
-            // Décaler les éléments suivants
-            for (size_t j = i; j < sl__audio.active_streams_count - 1; j++) {
-                sl__audio.active_streams[j] = sl__audio.active_streams[j + 1];
-            }
-            sl__audio.active_streams_count--;
-            break;
+    sl__audio.load_pending++;
+
+    sl__audio_load_init();
+
+    /* --- No loader thread, load here and finish with the others --- */
+
+    if (sl__audio.load_thread_count == 0) {
+        job->success = job->work(job);
+        sl__audio_load_push(&sl__audio.done_head, &sl__audio.done_tail, job);
+        return;
+    }
+
+    /* --- Hand it to a loader thread --- */
+
+    SDL_LockMutex(sl__audio.load_mutex);
+    sl__audio_load_push(&sl__audio.load_head, &sl__audio.load_tail, job);
+    SDL_SignalCondition(sl__audio.load_cond_work);
+    SDL_UnlockMutex(sl__audio.load_mutex);
+}
+
+void sl__audio_load_wait(void)
+{
+    if (sl__audio.load_thread_count > 0) {
+        SDL_LockMutex(sl__audio.load_mutex);
+        while (sl__audio.load_head != NULL || sl__audio.load_busy > 0) {
+            SDL_WaitCondition(sl__audio.load_cond_done, sl__audio.load_mutex);
         }
+        SDL_UnlockMutex(sl__audio.load_mutex);
     }
+
+    sl__audio_load_update();
 }
 
-bool sl__audio_stream_is_active(sl_stream_id stream_id)
+/* === Offline Functions === */
+
+void sl__audio_render(float* out, int frames)
 {
-    for (size_t i = 0; i < sl__audio.active_streams_count; i++) {
-        if (sl__audio.active_streams[i] == stream_id) {
-            return true;
+    // NOTE: Offline, the stream commands run here before each render,
+    //       then the mixer decodes and mixes the streams by itself
+
+    if (sl__audio.stream_thread_initialized) {
+        sl__stream_command_t command;
+        while (sl__audio_queue_pop(&sl__audio.stream_commands, &command)) {
+            sl__audio_stream_execute(&command);
         }
     }
-    return false;
+
+    sl__mixer_render(out, frames);
+}
+
+static size_t sl__audio_wav_io_write(void* user_data, const void* data, size_t bytes)
+{
+    return SDL_WriteIO((SDL_IOStream*)user_data, data, bytes);
+}
+
+bool sl__audio_render_wav(const char* file_path, int frames)
+{
+    SDL_IOStream* io = SDL_IOFromFile(file_path, "wb");
+    if (io == NULL) {
+        sl_loge("AUDIO: Failed to open '%s' for writing; %s", file_path, SDL_GetError());
+        return false;
+    }
+
+    drwav_data_format format = {
+        .container = drwav_container_riff,
+        .format = DR_WAVE_FORMAT_IEEE_FLOAT,
+        .channels = SL__MIXER_CHANNELS,
+        .sampleRate = SL__MIXER_SAMPLE_RATE,
+        .bitsPerSample = 32
+    };
+
+    drwav wav;
+    if (!drwav_init_write(&wav, &format, sl__audio_wav_io_write, sl__decoder_wav_io_seek, io, NULL)) {
+        sl_loge("AUDIO: Failed to write WAV header to '%s'", file_path);
+        SDL_CloseIO(io);
+        return false;
+    }
+
+    /* --- Render and write one block at a time --- */
+
+    float block[SL__MIXER_BLOCK_FRAMES * SL__MIXER_CHANNELS];
+    bool success = true;
+
+    while (frames > 0 && success) {
+        int count = SL_MIN(frames, SL__MIXER_BLOCK_FRAMES);
+        sl__audio_render(block, count);
+        success = (drwav_write_pcm_frames(&wav, count, block) == (drwav_uint64)count);
+        frames -= count;
+    }
+
+    drwav_uninit(&wav);
+
+    if (!SDL_CloseIO(io) || !success) {
+        sl_loge("AUDIO: Failed to write rendered audio to '%s'", file_path);
+        return false;
+    }
+
+    return true;
 }
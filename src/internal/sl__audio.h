@@ -25,14 +25,30 @@
 #include "./sl__registry.h"
 
 #include <SDL3/SDL_thread.h>
+#include <SDL3/SDL_atomic.h>
 #include <SDL3/SDL_mutex.h>
-#include <alc.h>
-#include <al.h>
+#include <SDL3/SDL_iostream.h>
 
 /* === Constants === */
 
-#define SL__stream_BUFFER_COUNT 3
-#define SL__stream_BUFFER_SIZE ((256 /* frames */) * (32 /* blocks */) * 2 /* ch */ * 2 /* bytes/sample */)
+#define SL__STREAM_MAX_BUFFERS 16
+#define SL__STREAM_MIN_BUFFERS 2
+#define SL__STREAM_MIN_DURATION 0.005f
+#define SL__STREAM_MAX_DURATION 2.0f
+
+#define SL__ADPCM_BLOCK_FRAMES 256          //< Frames per channel in an ADPCM block, must be even
+#define SL__ADPCM_BLOCK_SIZE(channels) ((channels) * (4 + SL__ADPCM_BLOCK_FRAMES / 2))
+
+#define SL__STREAM_MAX_DECODERS 4           //< Upper bound of decoder worker threads
+#define SL__LOAD_MAX_THREADS 8              //< Upper bound of asynchronous loader threads
+
+#define SL__STREAM_COMMAND_QUEUE_SIZE 256   //< Must be a power of two
+#define SL__STREAM_WAIT_MAX_MS 100          //< Upper bound of a stream thread sleep with streams playing
+
+#define SL__DECODER_OGG_READ_SIZE 4096      //< Bytes read from an OGG file each time stb_vorbis needs more
+#define SL__DECODER_OGG_PAGE_SIZE 8192      //< Typical OGG page size, seek probes start that much earlier
+#define SL__DECODER_OGG_TAIL_SIZE 65536     //< Bytes searched from the end of an OGG file for the last page
+#define SL__DECODER_OGG_SEEK_PROBES 8       //< Upper bound of resyncs tried by an OGG seek
 
 /* === Internal Enums === */
 
@@ -44,27 +60,96 @@ typedef enum {
     SL__AUDIO_OGG,
 } sl__audio_format_t;
 
+typedef enum {
+    SL__VOICE_STOPPED,
+    SL__VOICE_PLAYING,
+    SL__VOICE_PAUSED,
+} sl__voice_state_t;
+
+typedef enum {
+    SL__STREAM_STOPPED,
+    SL__STREAM_PLAYING,
+    SL__STREAM_PAUSED,
+} sl__stream_state_t;
+
+typedef enum {
+    SL__STREAM_CMD_PLAY,
+    SL__STREAM_CMD_PAUSE,
+    SL__STREAM_CMD_STOP,
+    SL__STREAM_CMD_REWIND,
+    SL__STREAM_CMD_LOOP,
+    SL__STREAM_CMD_LOOP_POINTS,
+    SL__STREAM_CMD_SEEK,
+    SL__STREAM_CMD_DESTROY,
+} sl__stream_command_type_t;
+
 /* === Internal Structs === */
 
+// NOTE: An asynchronous load registers its object right away, marked
+//       pending by its job. The job runs 'work' on a loader thread, which
+//       only writes the object fields loaded from the file, then 'finish'
+//       on the main thread, which completes or releases the object.
+
+typedef struct sl__load_job {
+
+    bool (*work)(struct sl__load_job* job);     ///< Loader thread, returns the success
+    void (*finish)(struct sl__load_job* job);   ///< Main thread, once 'work' is done
+
+    void* object;                   ///< sl__sample_t or sl__stream_t being loaded
+    uint32_t id;
+    char* file_path;
+
+    sl_sample_storage_t storage;    ///< Samples only
+    sl_stream_desc_t buffering;     ///< Streams only, resolved
+
+    sl_load_callback_t callback;
+    void* user_data;
+
+    bool success;                   ///< Written by the loader thread
+    bool cancelled;                 ///< Object destroyed while loading, main thread only
+
+    struct sl__load_job* next;
+
+} sl__load_job_t;
+
 typedef struct {
-    ALenum format;
+    int channels;                   ///< 1 or 2, interleaved
+    int bits;                       ///< Bits per sample, always 16 once decoded
     size_t sample_rate;
     size_t pcm_data_size;
     void* pcm_data;
 } sl__sample_raw_t;
 
 typedef struct {
-    ALuint buffer;
-    ALuint* sources;
-    int source_count;
+    float gain;                     ///< Individual volume on the logarithmic scale
+    float pan;                      ///< Balance from -1.0 (left) to 1.0 (right)
+    int voice;                      ///< Index of the mixer voice playing it, -1 if none
+    SDL_AtomicInt state;            ///< sl__voice_state_t published for the API
+} sl__sample_channel_t;
+
+// NOTE: Samples are registered by pointer, the mixer holds them while their
+//       voices play. Only 'priority' and 'bus' are written by the API after
+//       loading, they are passed along with each play command. The channels
+//       are owned by the mixer except for their published state.
+
+typedef struct {
+    int16_t* pcm;                   ///< Interleaved PCM at the mixer rate, NULL if encoded
+    uint8_t* adpcm;                 ///< IMA ADPCM blocks at the mixer rate, NULL if PCM
+    int pcm_channels;               ///< 1 (mono) or 2 (stereo)
+    int frame_count;
+    int priority;                   ///< Voice stealing priority, higher is kept longer
+    sl_audio_bus_t bus;             ///< Submix bus the voices are mixed into
+    sl__sample_channel_t* channels;
+    int channel_count;
+    sl__load_job_t* load_job;       ///< Asynchronous load in progress, main thread only
 } sl__sample_t;
 
 typedef struct {
 
     void* handle;
+    SDL_IOStream* io;               ///< File read by the decoder
     int channels;
     int sample_rate;
-    ALenum format;
     size_t total_samples;
     size_t current_sample;
     bool is_finished;
@@ -75,28 +160,81 @@ typedef struct {
 
 } sl__decoder_t;
 
-typedef struct {
+// NOTE: Streams are registered by pointer so the stream thread can keep
+//       them while the registry grows. Everything below 'state' is owned
+//       by the stream thread once it runs, the API only talks to it through
+//       the command queue and reads back the published 'state'.
+//       The decoder and the write side of the ring are lent to a decoder
+//       worker while 'decode_busy' is set, the stream thread claims them
+//       back before resetting or releasing the stream. Seeks are left to
+//       the next decode, so that they run on a worker too.
+//       The read side of the ring is consumed by the mixer, on the music
+//       bus. The stream thread only changes it, the pause flag and the
+//       active list while holding the mixer lock, see sl__mixer_lock().
+
+typedef struct sl__stream {
+
+    int buffer_count;
+    int buffer_frames;                              ///< Frames decoded per ring slot
 
-    ALuint source;
-    ALuint buffers[SL__stream_BUFFER_COUNT];
+    float volume;                                   ///< Individual volume, written by the API only
+    SDL_AtomicU32 gain;                             ///< Float bits of the gain applied by the mixer
+    SDL_AtomicInt state;                            ///< sl__stream_state_t published for the API
 
     sl__decoder_t decoder;
+    size_t seek_frame;                              ///< Frame the next decode seeks to first
+    bool seek_pending;                              ///< Set when 'seek_frame' has not been applied yet
+
+    int16_t* ring_pcm;                              ///< 'buffer_count' slots of 'buffer_frames' frames
+    int ring_frames[SL__STREAM_MAX_BUFFERS];        ///< Frames decoded in each slot
+    int ring_read;                                  ///< Next slot mixed, mixer side
+    int ring_write;                                 ///< Next slot decoded, worker side
+    SDL_AtomicInt ring_ready;                       ///< Slots decoded and not mixed yet
+
+    double ring_position;                           ///< Frames mixed from the slot at 'ring_read'
+    int16_t ring_last[2];                           ///< Last frame of the previous slot, for interpolation
+
+    struct sl__stream* decode_next;                 ///< Next stream in the decode job list
+    bool decode_pending;                            ///< In the job list, guarded by the decode mutex
+    bool decode_busy;                               ///< Lent to a worker, guarded by the decode mutex
 
+    int active_index;                               ///< Index in the active list, -1 if not active
     bool is_paused;
     bool should_loop;
-    float volume;
 
-    // Index of the assigned buffer in the pool (-1 if none)
-    int assigned_buffer_index;
+    size_t loop_start;                              ///< First frame repeated when looping
+    size_t loop_end;                                ///< Frame where looping goes back, 0 for the end
+
+    sl__load_job_t* load_job;                       ///< Asynchronous load in progress, main thread only
 
 } sl__stream_t;
 
+typedef struct {
+    sl__stream_command_type_t type;
+    sl__stream_t* stream;
+    bool flag;
+    size_t frame;                   ///< Seek target or loop start
+    size_t frame_end;               ///< Loop end, 0 for the end of the stream
+} sl__stream_command_t;
+
+// NOTE: Bounded multi-producer/single-consumer queue, every cell carries a
+//       sequence number telling the producers and the consumer whose turn it is.
+
+typedef struct {
+    SDL_AtomicInt* sequences;
+    uint8_t* items;
+    int item_size;
+    int capacity;                   ///< Power of two
+    SDL_AtomicInt head;
+    uint32_t tail;
+} sl__audio_queue_t;
+
 /* === Global State === */
 
 extern struct sl__audio {
 
-    ALCcontext* context;
-    ALCdevice* device;
+    // No device nor thread, everything is run by sl_audio_render()
+    bool offline;
 
     sl__registry_t reg_samples;
     sl__registry_t reg_streams;
@@ -106,43 +244,78 @@ extern struct sl__audio {
     float volume_sample;
     float volume_stream;
 
-    // Buffer pool for stream decoding
-    int16_t** decode_buffer_pool;
-    size_t decode_buffer_pool_size;
-    bool* decode_buffer_in_use;
-    size_t decode_buffer_count;
-    size_t decode_buffer_capacity;
-
-    // List of currently playing stream
-    sl_stream_id* active_streams;
-    size_t active_streams_count;
-    size_t active_streams_capacity;
+    // Submix bus settings as set by the API, the mixer keeps its own copy
+    float bus_volumes[SL_AUDIO_BUS_COUNT];
+    sl_audio_bus_desc_t bus_descs[SL_AUDIO_BUS_COUNT];
+
+    // Command queue from the API to the stream thread
+    sl__audio_queue_t stream_commands;
+
+    // Streams currently playing or paused, owned by the stream thread
+    sl__stream_t** active_streams;
+    int active_streams_count;
+    int active_streams_capacity;
+
+    // Decoder workers filling the stream rings
+    SDL_Thread* decode_threads[SL__STREAM_MAX_DECODERS];
+    int decode_thread_count;
+    SDL_Mutex* decode_mutex;
+    SDL_Condition* decode_cond_work;
+    SDL_Condition* decode_cond_done;
+    sl__stream_t* decode_head;
+    sl__stream_t* decode_tail;
+    bool decode_quit;
+
+    // Buffering of the streams loaded without description
+    sl_stream_desc_t stream_desc;
+
+    // Loader threads of the asynchronous loads
+    SDL_Thread* load_threads[SL__LOAD_MAX_THREADS];
+    int load_thread_count;
+    SDL_Mutex* load_mutex;
+    SDL_Condition* load_cond_work;
+    SDL_Condition* load_cond_done;
+    sl__load_job_t* load_head;      ///< Jobs waiting for a loader thread
+    sl__load_job_t* load_tail;
+    sl__load_job_t* done_head;      ///< Jobs waiting for sl_frame_step()
+    sl__load_job_t* done_tail;
+    int load_busy;                  ///< Jobs being run by a loader thread
+    int load_pending;               ///< Jobs submitted and not finished, main thread only
+    bool load_quit;
 
     // Stream streaming thread
     SDL_Thread* stream_thread;
     SDL_AtomicInt stream_thread_should_stop;
-    SDL_Mutex* stream_mutex;
-    SDL_Condition* stream_condition;
+    SDL_Semaphore* stream_wakeup;
     bool stream_thread_initialized;
 
 } sl__audio;
 
 /* === Module Functions === */
 
-bool sl__audio_init(void);
+bool sl__audio_init(bool offline);
 void sl__audio_quit(void);
+void sl__audio_update(void);   // Called in sl_frame_step()
 
 /* === Helper Functions === */
 
-const char* sl__audio_get_format_name(ALenum format);
-size_t sl__audio_get_sample_count(size_t pcm_date_size, ALenum format);
 sl__audio_format_t sl__audio_get_format(const uint8_t* data, size_t size);
 
+/* === Queue Functions === */
+
+bool sl__audio_queue_create(sl__audio_queue_t* queue, int capacity, int item_size);
+void sl__audio_queue_destroy(sl__audio_queue_t* queue);
+bool sl__audio_queue_push(sl__audio_queue_t* queue, const void* item);    // Any thread, false when full
+bool sl__audio_queue_pop(sl__audio_queue_t* queue, void* item);           // Consumer thread only
+
 /* === Volume Functions === */
 
-float sl__audio_calculate_final_sample_volume(void);
-float sl__audio_calculate_final_stream_volume(float stream_volume);
+float sl__audio_linear_to_log(float linear_volume);
+float sl__audio_calculate_stream_gain(float stream_volume);
+void sl__audio_update_master_volume(void);
 void sl__audio_update_all_sample_volumes(void);
+void sl__audio_update_bus_volume(sl_audio_bus_t bus);
+void sl__audio_update_stream_volume(sl__stream_t* stream);
 void sl__audio_update_all_stream_volumes(void);
 
 /* === Sample Functions === */
@@ -152,23 +325,41 @@ bool sl__audio_sample_load_flac(sl__sample_raw_t* out, const void* data, size_t
 bool sl__audio_sample_load_mp3(sl__sample_raw_t* out, const void* data, size_t data_size);
 bool sl__audio_sample_load_ogg(sl__sample_raw_t* out, const void* data, size_t data_size);
 
+void sl__audio_sample_free(sl__sample_t* sample);
+
+/* === ADPCM Functions === */
+
+uint8_t* sl__audio_adpcm_encode(const int16_t* pcm, int frame_count, int channels, size_t* out_size);
+void sl__audio_adpcm_decode_block(const uint8_t* block, int channels, int16_t* out);
+
 /* === Stream Functions === */
 
-bool sl__audio_stream_thread_init(void);       // Called on first sl_stream_play()
+bool sl__audio_stream_thread_init(void);       // Called on first command posted
 void sl__audio_stream_thread_shutdown(void);   // Called in sl__audio_quit()
 int sl__audio_stream_thread(void* data);
 
-void sl__audio_stream_unqueue_all_buffers(sl__stream_t* stream);
-void sl__audio_stream_prepare_buffers(sl__stream_t* stream);
+void sl__audio_stream_desc_resolve(sl_stream_desc_t* out, const sl_stream_desc_t* desc);
+
+bool sl__audio_stream_post(sl__stream_command_type_t type, sl__stream_t* stream, bool flag);
+bool sl__audio_stream_post_command(const sl__stream_command_t* command);
+void sl__audio_stream_free(sl__stream_t* stream);
+
+void sl__audio_stream_deactivate(sl__stream_t* stream);
+bool sl__audio_stream_render(sl__stream_t* stream, float* out, int frames);   // Mixer side, false once finished offline
+
+bool sl__audio_stream_decoder_open(sl__decoder_t* decoder, const char* file_path);
+void sl__audio_stream_decoder_close(sl__decoder_t* decoder);
+
+/* === Loader Functions === */
 
-bool sl__audio_stream_decoder_init(sl__decoder_t* decoder, const void* data, size_t data_size, sl__audio_format_t format);
+void sl__audio_load_submit(sl__load_job_t* job);
+void sl__audio_load_wait(void);
+void sl__audio_load_update(void);   // Called in sl__audio_update()
+void sl__audio_load_quit(void);     // Called in sl__audio_quit()
 
-int sl__audio_stream_acquire_decode_buffer(void);
-void sl__audio_stream_release_decode_buffer(int buffer_index);
-bool sl__audio_stream_ensure_buffer_pool_capacity(size_t needed_capacity);
+/* === Offline Functions === */
 
-bool sl__audio_stream_add_active(sl_stream_id stream_id);
-void sl__audio_stream_remove_active(sl_stream_id stream_id);
-bool sl__audio_stream_is_active(sl_stream_id stream_id);
+void sl__audio_render(float* out, int frames);
+bool sl__audio_render_wav(const char* file_path, int frames);
 
 #endif // SL__AUDIO_H
@@ -68,11 +68,20 @@ bool sl__core_init(const char* title, int w, int h, const sl_app_desc_t* desc)
         return false;
     }
 
+#ifndef SL_BACKEND_SOFTWARE
+
     /* --- Define OpenGL attributes --- */
 
+#ifdef SL_BACKEND_GL33
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+#else
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+#endif
 
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
@@ -89,6 +98,8 @@ bool sl__core_init(const char* title, int w, int h, const sl_app_desc_t* desc)
         SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
     }
 
+#endif // SL_BACKEND_SOFTWARE
+
     /* --- Create the SDL window --- */
 
     SDL_WindowFlags windowFlags = 0;
@@ -110,7 +121,13 @@ bool sl__core_init(const char* title, int w, int h, const sl_app_desc_t* desc)
     if (desc->flags & SL_FLAG_KEYBOARD_GRABBED) windowFlags |= SDL_WINDOW_KEYBOARD_GRABBED;
     if (desc->flags & SL_FLAG_HIGH_PIXEL_DENSITY) windowFlags |= SDL_WINDOW_HIGH_PIXEL_DENSITY;
 
-    sl__core.window = SDL_CreateWindow(title, w, h, SDL_WINDOW_OPENGL | windowFlags);
+    // NOTE: The software backend presents through the window surface,
+    //       so no OpenGL context is created for it.
+#ifndef SL_BACKEND_SOFTWARE
+    windowFlags |= SDL_WINDOW_OPENGL;
+#endif
+
+    sl__core.window = SDL_CreateWindow(title, w, h, windowFlags);
     if (!sl__core.window) {
         sl_loge("CORE: Failed to create window; %s", SDL_GetError());
         return false;
@@ -118,17 +135,22 @@ bool sl__core_init(const char* title, int w, int h, const sl_app_desc_t* desc)
 
     SDL_SetWindowPosition(sl__core.window, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
 
-    /* --- Create GLES2 context --- */
+#ifndef SL_BACKEND_SOFTWARE
+
+    /* --- Create OpenGL context --- */
 
     sl__core.gl = SDL_GL_CreateContext(sl__core.window);
     if (!sl__core.gl) {
-        sl_loge("CORE: Failed to create GLES2 context: %s", SDL_GetError());
+        sl_loge("CORE: Failed to create OpenGL context: %s", SDL_GetError());
         SDL_DestroyWindow(sl__core.window);
         return false;
     }
 
     /* --- Load GLES2 functions --- */
 
+    // NOTE: The GL 3.3 backend also goes through this loader, the few
+    //       ES2-only entry points it may miss are never used by that backend.
+
     if (gladLoadGLES2(SDL_GL_GetProcAddress) < 0) {
         sl_loge("CORE: Failed to load GLES2 functions");
         SDL_GL_DestroyContext(sl__core.gl);
@@ -145,6 +167,8 @@ bool sl__core_init(const char* title, int w, int h, const sl_app_desc_t* desc)
     sl_logd("CORE: GL Shading Language Version : %s", glGetString(GL_SHADING_LANGUAGE_VERSION));
 #endif
 
+#endif // SL_BACKEND_SOFTWARE
+
     /* --- Yayyy! --- */
 
     return true;
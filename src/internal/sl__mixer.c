@@ -0,0 +1,966 @@
+/**
+ * Copyright (c) 2025 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "./sl__mixer.h"
+#include "./sl__simd.h"
+
+#include <SDL3/SDL_init.h>
+
+/* === Global State === */
+
+struct sl__mixer sl__mixer = { 0 };
+
+/* === SIMD Selection === */
+
+#if defined(SL__HAS_SSE2)
+#   define SL__MIXER_SSE2
+#elif (defined(SL__HAS_NEON) || defined(SL__HAS_NEON_FMA)) && defined(__aarch64__)
+#   define SL__MIXER_NEON
+#endif
+
+/* === Mixing Functions === */
+
+// NOTE: Gains are expected to include the 1/32768 int16 normalization.
+//       The output is always interleaved stereo.
+
+static void sl__mixer_mix_mono(float* out, const int16_t* in, int frames, float gain_l, float gain_r)
+{
+    int i = 0;
+
+#if defined(SL__MIXER_SSE2)
+    __m128 gain = _mm_setr_ps(gain_l, gain_r, gain_l, gain_r);
+    for (; i + 4 <= frames; i += 4) {
+        __m128i s16 = _mm_loadl_epi64((const __m128i*)(in + i));
+        __m128 s = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16));
+        __m128 lo = _mm_unpacklo_ps(s, s);
+        __m128 hi = _mm_unpackhi_ps(s, s);
+        _mm_storeu_ps(out + 2 * i + 0, _mm_add_ps(_mm_loadu_ps(out + 2 * i + 0), _mm_mul_ps(lo, gain)));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_add_ps(_mm_loadu_ps(out + 2 * i + 4), _mm_mul_ps(hi, gain)));
+    }
+#elif defined(SL__MIXER_NEON)
+    const float gains[4] = { gain_l, gain_r, gain_l, gain_r };
+    float32x4_t gain = vld1q_f32(gains);
+    for (; i + 4 <= frames; i += 4) {
+        float32x4_t s = vcvtq_f32_s32(vmovl_s16(vld1_s16(in + i)));
+        float32x4x2_t z = vzipq_f32(s, s);
+        vst1q_f32(out + 2 * i + 0, vmlaq_f32(vld1q_f32(out + 2 * i + 0), z.val[0], gain));
+        vst1q_f32(out + 2 * i + 4, vmlaq_f32(vld1q_f32(out + 2 * i + 4), z.val[1], gain));
+    }
+#endif
+
+    for (; i < frames; i++) {
+        float s = (float)in[i];
+        out[2 * i + 0] += s * gain_l;
+        out[2 * i + 1] += s * gain_r;
+    }
+}
+
+static void sl__mixer_mix_stereo(float* out, const int16_t* in, int frames, float gain_l, float gain_r)
+{
+    int i = 0;
+
+#if defined(SL__MIXER_SSE2)
+    __m128 gain = _mm_setr_ps(gain_l, gain_r, gain_l, gain_r);
+    for (; i + 4 <= frames; i += 4) {
+        __m128i s16 = _mm_loadu_si128((const __m128i*)(in + 2 * i));
+        __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16));
+        __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s16, s16), 16));
+        _mm_storeu_ps(out + 2 * i + 0, _mm_add_ps(_mm_loadu_ps(out + 2 * i + 0), _mm_mul_ps(lo, gain)));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_add_ps(_mm_loadu_ps(out + 2 * i + 4), _mm_mul_ps(hi, gain)));
+    }
+#elif defined(SL__MIXER_NEON)
+    const float gains[4] = { gain_l, gain_r, gain_l, gain_r };
+    float32x4_t gain = vld1q_f32(gains);
+    for (; i + 4 <= frames; i += 4) {
+        int16x8_t s16 = vld1q_s16(in + 2 * i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s16)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s16)));
+        vst1q_f32(out + 2 * i + 0, vmlaq_f32(vld1q_f32(out + 2 * i + 0), lo, gain));
+        vst1q_f32(out + 2 * i + 4, vmlaq_f32(vld1q_f32(out + 2 * i + 4), hi, gain));
+    }
+#endif
+
+    for (; i < frames; i++) {
+        out[2 * i + 0] += (float)in[2 * i + 0] * gain_l;
+        out[2 * i + 1] += (float)in[2 * i + 1] * gain_r;
+    }
+}
+
+static void sl__mixer_mix_voice(float* out, sl__voice_t* voice, int index, int frames, float gain_l, float gain_r)
+{
+    const sl__sample_t* sample = voice->sample;
+    int channels = sample->pcm_channels;
+
+    /* --- PCM is mixed in place --- */
+
+    if (sample->pcm != NULL) {
+        const int16_t* pcm = sample->pcm + voice->position * channels;
+        if (channels == 1) sl__mixer_mix_mono(out, pcm, frames, gain_l, gain_r);
+        else sl__mixer_mix_stereo(out, pcm, frames, gain_l, gain_r);
+        return;
+    }
+
+    /* --- ADPCM goes through the voice cache one block at a time --- */
+
+    int16_t* cache = sl__mixer.block_cache[index];
+    int position = voice->position;
+
+    while (frames > 0)
+    {
+        int block = position / SL__ADPCM_BLOCK_FRAMES;
+        int offset = position % SL__ADPCM_BLOCK_FRAMES;
+
+        if (voice->cached_block != block) {
+            const uint8_t* data = sample->adpcm + (size_t)block * SL__ADPCM_BLOCK_SIZE(channels);
+            sl__audio_adpcm_decode_block(data, channels, cache);
+            voice->cached_block = block;
+        }
+
+        int count = SL_MIN(frames, SL__ADPCM_BLOCK_FRAMES - offset);
+        const int16_t* pcm = cache + offset * channels;
+
+        if (channels == 1) sl__mixer_mix_mono(out, pcm, count, gain_l, gain_r);
+        else sl__mixer_mix_stereo(out, pcm, count, gain_l, gain_r);
+
+        out += count * SL__MIXER_CHANNELS;
+        position += count;
+        frames -= count;
+    }
+}
+
+static void sl__mixer_clip(float* out, int count)
+{
+    int i = 0;
+
+#if defined(SL__MIXER_SSE2)
+    __m128 lo = _mm_set1_ps(-1.0f);
+    __m128 hi = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(out + i), lo), hi));
+    }
+#elif defined(SL__MIXER_NEON)
+    float32x4_t lo = vdupq_n_f32(-1.0f);
+    float32x4_t hi = vdupq_n_f32(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vminq_f32(vmaxq_f32(vld1q_f32(out + i), lo), hi));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] = SL_CLAMP(out[i], -1.0f, 1.0f);
+    }
+}
+
+static void sl__mixer_ramp(float* buffer, int frames, float from, float to)
+{
+    // NOTE: The gain goes linearly from 'from' to 'to', reached on the last frame
+
+    if (from == to && to == 1.0f) {
+        return;
+    }
+
+    float step = (to - from) / (float)frames;
+    int i = 0;
+
+#if defined(SL__MIXER_SSE2)
+    __m128 gain = _mm_setr_ps(from + step, from + step, from + 2.0f * step, from + 2.0f * step);
+    __m128 increment = _mm_set1_ps(2.0f * step);
+    for (; i + 2 <= frames; i += 2) {
+        _mm_storeu_ps(buffer + 2 * i, _mm_mul_ps(_mm_loadu_ps(buffer + 2 * i), gain));
+        gain = _mm_add_ps(gain, increment);
+    }
+#elif defined(SL__MIXER_NEON)
+    const float gains[4] = { from + step, from + step, from + 2.0f * step, from + 2.0f * step };
+    float32x4_t gain = vld1q_f32(gains);
+    float32x4_t increment = vdupq_n_f32(2.0f * step);
+    for (; i + 2 <= frames; i += 2) {
+        vst1q_f32(buffer + 2 * i, vmulq_f32(vld1q_f32(buffer + 2 * i), gain));
+        gain = vaddq_f32(gain, increment);
+    }
+#endif
+
+    for (; i < frames; i++) {
+        float gain_i = from + step * (float)(i + 1);
+        buffer[2 * i + 0] *= gain_i;
+        buffer[2 * i + 1] *= gain_i;
+    }
+}
+
+static void sl__mixer_accumulate(float* out, const float* in, int count)
+{
+    int i = 0;
+
+#if defined(SL__MIXER_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_loadu_ps(in + i)));
+    }
+#elif defined(SL__MIXER_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vaddq_f32(vld1q_f32(out + i), vld1q_f32(in + i)));
+    }
+#endif
+
+    for (; i < count; i++) {
+        out[i] += in[i];
+    }
+}
+
+static float sl__mixer_peak(const float* in, int count)
+{
+    float peak = 0.0f;
+    int i = 0;
+
+#if defined(SL__MIXER_SSE2)
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 peak4 = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        peak4 = _mm_max_ps(peak4, _mm_andnot_ps(sign, _mm_loadu_ps(in + i)));
+    }
+    peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+    peak4 = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, 1));
+    peak = _mm_cvtss_f32(peak4);
+#elif defined(SL__MIXER_NEON)
+    float32x4_t peak4 = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        peak4 = vmaxq_f32(peak4, vabsq_f32(vld1q_f32(in + i)));
+    }
+    peak = vmaxvq_f32(peak4);
+#endif
+
+    for (; i < count; i++) {
+        peak = SL_MAX(peak, fabsf(in[i]));
+    }
+
+    return peak;
+}
+
+static float sl__mixer_smooth(float current, float target, int frames)
+{
+    float coef = expf(-(float)frames / (SL__MIXER_GAIN_SMOOTHING * SL__MIXER_SAMPLE_RATE));
+    float next = target + (current - target) * coef;
+    return (fabsf(next - target) < 1e-4f) ? target : next;
+}
+
+/* === Bus Effects === */
+
+// NOTE: Effects run in place on the interleaved stereo block of a bus.
+//       Recursive filters can't be vectorized over time, the biquad
+//       runs both channels in one vector instead.
+
+static void sl__mixer_biquad_process(sl__biquad_t* filter, float* buffer, int frames)
+{
+    int i = 0;
+
+#if defined(SL__MIXER_SSE2)
+    __m128 b0 = _mm_set1_ps(filter->b0), b1 = _mm_set1_ps(filter->b1), b2 = _mm_set1_ps(filter->b2);
+    __m128 a1 = _mm_set1_ps(filter->a1), a2 = _mm_set1_ps(filter->a2);
+    __m128 z1 = _mm_setr_ps(filter->z1[0], filter->z1[1], 0.0f, 0.0f);
+    __m128 z2 = _mm_setr_ps(filter->z2[0], filter->z2[1], 0.0f, 0.0f);
+    for (; i < frames; i++) {
+        __m128 x = _mm_castpd_ps(_mm_load_sd((const double*)(buffer + 2 * i)));
+        __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+        z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+        z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+        _mm_store_sd((double*)(buffer + 2 * i), _mm_castps_pd(y));
+    }
+    float state[4];
+    _mm_storeu_ps(state, z1);
+    filter->z1[0] = state[0], filter->z1[1] = state[1];
+    _mm_storeu_ps(state, z2);
+    filter->z2[0] = state[0], filter->z2[1] = state[1];
+#elif defined(SL__MIXER_NEON)
+    float32x2_t b0 = vdup_n_f32(filter->b0), b1 = vdup_n_f32(filter->b1), b2 = vdup_n_f32(filter->b2);
+    float32x2_t a1 = vdup_n_f32(filter->a1), a2 = vdup_n_f32(filter->a2);
+    float32x2_t z1 = vld1_f32(filter->z1);
+    float32x2_t z2 = vld1_f32(filter->z2);
+    for (; i < frames; i++) {
+        float32x2_t x = vld1_f32(buffer + 2 * i);
+        float32x2_t y = vmla_f32(z1, b0, x);
+        z1 = vmls_f32(vmla_f32(z2, b1, x), a1, y);
+        z2 = vmls_f32(vmul_f32(b2, x), a2, y);
+        vst1_f32(buffer + 2 * i, y);
+    }
+    vst1_f32(filter->z1, z1);
+    vst1_f32(filter->z2, z2);
+#else
+    for (; i < frames; i++) {
+        for (int c = 0; c < 2; c++) {
+            float x = buffer[2 * i + c];
+            float y = filter->b0 * x + filter->z1[c];
+            filter->z1[c] = filter->b1 * x - filter->a1 * y + filter->z2[c];
+            filter->z2[c] = filter->b2 * x - filter->a2 * y;
+            buffer[2 * i + c] = y;
+        }
+    }
+#endif
+
+    // Flush the state once it has decayed, denormals are slow to compute
+    for (int c = 0; c < 2; c++) {
+        if (fabsf(filter->z1[c]) < 1e-20f) filter->z1[c] = 0.0f;
+        if (fabsf(filter->z2[c]) < 1e-20f) filter->z2[c] = 0.0f;
+    }
+}
+
+static void sl__mixer_reverb_process(sl__reverb_t* reverb, float* buffer, int frames)
+{
+    // NOTE: Schroeder reverb from a mono sum, four parallel combs with a
+    //       damped feedback then two allpasses in series per channel.
+    //       The right channel uses slightly longer delays for width.
+
+    int comb_pos[SL__REVERB_COMBS][2];
+    int allpass_pos[SL__REVERB_ALLPASSES][2];
+    SDL_memcpy(comb_pos, reverb->comb_pos, sizeof(comb_pos));
+    SDL_memcpy(allpass_pos, reverb->allpass_pos, sizeof(allpass_pos));
+
+    float feedback = reverb->feedback;
+    float damping = reverb->damping;
+    float wet = reverb->wet;
+
+    for (int i = 0; i < frames; i++)
+    {
+        float input = (buffer[2 * i + 0] + buffer[2 * i + 1]) * 0.015f;
+
+        for (int c = 0; c < 2; c++)
+        {
+            float sum = 0.0f;
+
+            for (int k = 0; k < SL__REVERB_COMBS; k++) {
+                float* line = reverb->comb[k][c];
+                int pos = comb_pos[k][c];
+                float y = line[pos];
+                float store = y + (reverb->comb_store[k][c] - y) * damping;
+                reverb->comb_store[k][c] = store;
+                line[pos] = input + store * feedback;
+                comb_pos[k][c] = (pos + 1 < reverb->comb_length[k][c]) ? pos + 1 : 0;
+                sum += y;
+            }
+
+            for (int k = 0; k < SL__REVERB_ALLPASSES; k++) {
+                float* line = reverb->allpass[k][c];
+                int pos = allpass_pos[k][c];
+                float delayed = line[pos];
+                line[pos] = sum + delayed * 0.5f;
+                allpass_pos[k][c] = (pos + 1 < reverb->allpass_length[k][c]) ? pos + 1 : 0;
+                sum = delayed - sum;
+            }
+
+            buffer[2 * i + c] += sum * wet;
+        }
+    }
+
+    SDL_memcpy(reverb->comb_pos, comb_pos, sizeof(comb_pos));
+    SDL_memcpy(reverb->allpass_pos, allpass_pos, sizeof(allpass_pos));
+
+    for (int k = 0; k < SL__REVERB_COMBS; k++) {
+        for (int c = 0; c < 2; c++) {
+            if (fabsf(reverb->comb_store[k][c]) < 1e-20f) reverb->comb_store[k][c] = 0.0f;
+        }
+    }
+}
+
+static void sl__mixer_compressor_process(sl__compressor_t* compressor, float* buffer, int frames)
+{
+    // NOTE: The level is the peak of each chunk, the gain moves once per
+    //       chunk and is ramped across it, which keeps the costly dB
+    //       conversions out of the per-sample loop.
+
+    for (int i = 0; i < frames; i += SL__MIXER_COMPRESSOR_CHUNK)
+    {
+        int count = SL_MIN(SL__MIXER_COMPRESSOR_CHUNK, frames - i);
+        float* chunk = buffer + 2 * i;
+
+        float level = 20.0f * log10f(sl__mixer_peak(chunk, count * SL__MIXER_CHANNELS) + 1e-9f);
+        float coef = (level > compressor->envelope) ? compressor->attack : compressor->release;
+        compressor->envelope = level + (compressor->envelope - level) * coef;
+
+        float over = compressor->envelope - compressor->threshold;
+        float gain = (over > 0.0f) ? powf(10.0f, -over * compressor->slope / 20.0f) : 1.0f;
+
+        sl__mixer_ramp(chunk, count, compressor->gain, gain);
+        compressor->gain = gain;
+    }
+}
+
+static void sl__mixer_bus_init(sl__bus_t* bus)
+{
+    // Freeverb delays at 44.1 kHz, scaled to the mixer rate
+    static const int comb_lengths[SL__REVERB_COMBS] = { 1116, 1188, 1277, 1356 };
+    static const int allpass_lengths[SL__REVERB_ALLPASSES] = { 556, 441 };
+    static const int stereo_spread = 23;
+
+    SDL_memset(bus, 0, sizeof(*bus));
+
+    for (int c = 0; c < 2; c++) {
+        for (int k = 0; k < SL__REVERB_COMBS; k++) {
+            int length = (comb_lengths[k] + c * stereo_spread) * SL__MIXER_SAMPLE_RATE / 44100;
+            bus->reverb.comb_length[k][c] = SL_MIN(length, SL__REVERB_COMB_MAX);
+        }
+        for (int k = 0; k < SL__REVERB_ALLPASSES; k++) {
+            int length = (allpass_lengths[k] + c * stereo_spread) * SL__MIXER_SAMPLE_RATE / 44100;
+            bus->reverb.allpass_length[k][c] = SL_MIN(length, SL__REVERB_ALLPASS_MAX);
+        }
+    }
+
+    bus->compressor.envelope = -120.0f;
+    bus->compressor.gain = 1.0f;
+    bus->gain = 1.0f;
+    bus->gain_target = 1.0f;
+}
+
+static void sl__mixer_bus_configure(sl__bus_t* bus, const sl_audio_bus_desc_t* desc)
+{
+    /* --- Filter, RBJ cookbook coefficients --- */
+
+    sl__biquad_t* filter = &bus->filter;
+    filter->enabled = (desc->filter != SL_AUDIO_FILTER_NONE);
+
+    if (filter->enabled) {
+        float w0 = 2.0f * SL_PI * desc->filter_cutoff / SL__MIXER_SAMPLE_RATE;
+        float cos_w0 = cosf(w0);
+        float alpha = sinf(w0) / (2.0f * desc->filter_q);
+        float a0 = 1.0f + alpha;
+        float side = (desc->filter == SL_AUDIO_FILTER_LOWPASS) ? 1.0f - cos_w0 : 1.0f + cos_w0;
+        float center = (desc->filter == SL_AUDIO_FILTER_LOWPASS) ? side : -side;
+        filter->b0 = 0.5f * side / a0;
+        filter->b1 = center / a0;
+        filter->b2 = 0.5f * side / a0;
+        filter->a1 = -2.0f * cos_w0 / a0;
+        filter->a2 = (1.0f - alpha) / a0;
+    }
+    else {
+        SDL_memset(filter->z1, 0, sizeof(filter->z1));
+        SDL_memset(filter->z2, 0, sizeof(filter->z2));
+    }
+
+    /* --- Reverb --- */
+
+    sl__reverb_t* reverb = &bus->reverb;
+    reverb->enabled = (desc->reverb_mix > 0.0f);
+    reverb->wet = 3.0f * desc->reverb_mix;
+    reverb->feedback = 0.7f + 0.28f * desc->reverb_room_size;
+    reverb->damping = 0.4f * desc->reverb_damping;
+    reverb->tail = (int)(SL__REVERB_COMB_MAX * 3.0f / -log10f(reverb->feedback));
+
+    /* --- Compressor --- */
+
+    float chunk_duration = (float)SL__MIXER_COMPRESSOR_CHUNK / SL__MIXER_SAMPLE_RATE;
+
+    sl__compressor_t* compressor = &bus->compressor;
+    compressor->enabled = (desc->compressor_ratio > 1.0f);
+    compressor->threshold = desc->compressor_threshold;
+    compressor->slope = (desc->compressor_ratio >= 20.0f) ? 1.0f : 1.0f - 1.0f / desc->compressor_ratio;
+    compressor->attack = expf(-chunk_duration / desc->compressor_attack);
+    compressor->release = expf(-chunk_duration / desc->compressor_release);
+
+    if (!compressor->enabled) {
+        compressor->envelope = -120.0f;
+        compressor->gain = 1.0f;
+    }
+}
+
+static void sl__mixer_bus_process(sl__bus_t* bus, float* out, int frames)
+{
+    if (bus->filter.enabled) {
+        sl__mixer_biquad_process(&bus->filter, bus->buffer, frames);
+    }
+
+    if (bus->reverb.enabled) {
+        sl__mixer_reverb_process(&bus->reverb, bus->buffer, frames);
+    }
+
+    if (bus->compressor.enabled) {
+        sl__mixer_compressor_process(&bus->compressor, bus->buffer, frames);
+    }
+
+    float gain = sl__mixer_smooth(bus->gain, bus->gain_target, frames);
+    sl__mixer_ramp(bus->buffer, frames, bus->gain, gain);
+    bus->gain = gain;
+
+    sl__mixer_accumulate(out, bus->buffer, frames * SL__MIXER_CHANNELS);
+}
+
+/* === Voice Functions === */
+
+static void sl__mixer_voice_release(int index)
+{
+    sl__voice_t* voice = &sl__mixer.voices[index];
+    sl__sample_channel_t* channel = &voice->sample->channels[voice->channel];
+
+    channel->voice = -1;
+    SDL_SetAtomicInt(&channel->state, SL__VOICE_STOPPED);
+    voice->sample = NULL;
+
+    int last = sl__mixer.active_voices[--sl__mixer.active_count];
+    sl__mixer.active_voices[voice->active_index] = last;
+    sl__mixer.voices[last].active_index = voice->active_index;
+
+    sl__mixer.free_voices[sl__mixer.free_count++] = index;
+}
+
+static int sl__mixer_voice_acquire(int priority)
+{
+    /* --- Take a free voice if any --- */
+
+    if (sl__mixer.free_count > 0) {
+        int index = sl__mixer.free_voices[--sl__mixer.free_count];
+        sl__mixer.voices[index].active_index = sl__mixer.active_count;
+        sl__mixer.active_voices[sl__mixer.active_count++] = index;
+        return index;
+    }
+
+    /* --- Otherwise steal the oldest voice of the lowest priority --- */
+
+    int victim = -1;
+
+    for (int i = 0; i < SL__MIXER_VOICE_COUNT; i++) {
+        const sl__voice_t* voice = &sl__mixer.voices[i];
+        if (voice->priority > priority) continue;
+        if (victim < 0 || voice->priority < sl__mixer.voices[victim].priority ||
+            (voice->priority == sl__mixer.voices[victim].priority && voice->start < sl__mixer.voices[victim].start)) {
+            victim = i;
+        }
+    }
+
+    if (victim < 0) {
+        return -1;
+    }
+
+    sl__mixer_voice_release(victim);
+
+    return sl__mixer_voice_acquire(priority);
+}
+
+/* === Command Functions === */
+
+static void sl__mixer_execute_channel(const sl__mixer_command_t* command, int channel_index)
+{
+    sl__sample_t* sample = command->sample;
+    sl__sample_channel_t* channel = &sample->channels[channel_index];
+
+    switch (command->type) {
+    case SL__MIXER_CMD_PLAY:
+        if (channel->voice < 0) {
+            channel->voice = sl__mixer_voice_acquire(command->priority);
+            if (channel->voice < 0) {
+                SDL_SetAtomicInt(&channel->state, SL__VOICE_STOPPED);
+                break;
+            }
+        }
+        {
+            sl__voice_t* voice = &sl__mixer.voices[channel->voice];
+            voice->sample = sample;
+            voice->channel = channel_index;
+            voice->position = 0;
+            voice->cached_block = -1;
+            voice->priority = command->priority;
+            voice->bus = command->bus;
+            voice->start = sl__mixer.play_counter++;
+            voice->is_paused = false;
+        }
+        SDL_SetAtomicInt(&channel->state, SL__VOICE_PLAYING);
+        break;
+
+    case SL__MIXER_CMD_PAUSE:
+        if (channel->voice >= 0) {
+            sl__mixer.voices[channel->voice].is_paused = true;
+            SDL_SetAtomicInt(&channel->state, SL__VOICE_PAUSED);
+        }
+        break;
+
+    case SL__MIXER_CMD_STOP:
+        if (channel->voice >= 0) {
+            sl__mixer_voice_release(channel->voice);
+        }
+        break;
+
+    case SL__MIXER_CMD_VOLUME:
+        channel->gain = sl__audio_linear_to_log(command->value);
+        break;
+
+    case SL__MIXER_CMD_PAN:
+        channel->pan = command->value;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void sl__mixer_execute(const sl__mixer_command_t* command)
+{
+    switch (command->type) {
+    case SL__MIXER_CMD_GAIN:
+        sl__mixer.sample_gain = command->value;
+        break;
+
+    case SL__MIXER_CMD_MASTER_GAIN:
+        sl__mixer.master_gain = command->value;
+        break;
+
+    case SL__MIXER_CMD_BUS_GAIN:
+        sl__mixer.buses[command->bus].gain_target = command->value;
+        break;
+
+    case SL__MIXER_CMD_BUS_DESC:
+        sl__mixer_bus_configure(&sl__mixer.buses[command->bus], &command->bus_desc);
+        break;
+
+    case SL__MIXER_CMD_DESTROY:
+        for (int i = 0; i < command->sample->channel_count; i++) {
+            if (command->sample->channels[i].voice >= 0) {
+                sl__mixer_voice_release(command->sample->channels[i].voice);
+            }
+        }
+        sl__audio_sample_free(command->sample);
+        break;
+
+    default:
+        if (command->channel >= 0) {
+            sl__mixer_execute_channel(command, command->channel);
+        }
+        else for (int i = 0; i < command->sample->channel_count; i++) {
+            sl__mixer_execute_channel(command, i);
+        }
+        break;
+    }
+}
+
+static void sl__mixer_process_commands(void)
+{
+    sl__mixer_command_t command;
+    while (sl__audio_queue_pop(&sl__mixer.commands, &command)) {
+        sl__mixer_execute(&command);
+    }
+}
+
+/* === Render Functions === */
+
+static void sl__mixer_render_block(float* out, int frames)
+{
+    bool bus_used[SL_AUDIO_BUS_COUNT] = { 0 };
+
+    /* --- Sum the voices into their bus --- */
+
+    for (int i = 0; i < sl__mixer.active_count;)
+    {
+        int index = sl__mixer.active_voices[i];
+        sl__voice_t* voice = &sl__mixer.voices[index];
+
+        if (voice->is_paused) {
+            i++;
+            continue;
+        }
+
+        sl__bus_t* bus = &sl__mixer.buses[voice->bus];
+        if (!bus_used[voice->bus]) {
+            SDL_memset(bus->buffer, 0, frames * SL__MIXER_CHANNELS * sizeof(float));
+            bus_used[voice->bus] = true;
+        }
+
+        const sl__sample_t* sample = voice->sample;
+        const sl__sample_channel_t* channel = &sample->channels[voice->channel];
+
+        float gain = channel->gain * (1.0f / 32768.0f);
+        float gain_l = gain * SL_MIN(1.0f, 1.0f - channel->pan);
+        float gain_r = gain * SL_MIN(1.0f, 1.0f + channel->pan);
+
+        int count = SL_MIN(frames, sample->frame_count - voice->position);
+        sl__mixer_mix_voice(bus->buffer, voice, index, count, gain_l, gain_r);
+        voice->position += count;
+
+        if (voice->position >= sample->frame_count) {
+            sl__mixer_voice_release(index);
+        }
+        else {
+            i++;
+        }
+    }
+
+    /* --- Apply the sample volume to the voices --- */
+
+    float voice_gain = sl__mixer_smooth(sl__mixer.voice_gain, sl__mixer.sample_gain, frames);
+
+    for (int i = 0; i < SL_AUDIO_BUS_COUNT; i++) {
+        if (bus_used[i]) sl__mixer_ramp(sl__mixer.buses[i].buffer, frames, sl__mixer.voice_gain, voice_gain);
+    }
+
+    sl__mixer.voice_gain = voice_gain;
+
+    /* --- Add the streams to the music bus --- */
+
+    sl__bus_t* music = &sl__mixer.buses[SL_AUDIO_BUS_MUSIC];
+
+    for (int i = 0; i < sl__audio.active_streams_count;)
+    {
+        sl__stream_t* stream = sl__audio.active_streams[i];
+
+        if (stream->is_paused) {
+            i++;
+            continue;
+        }
+
+        if (!bus_used[SL_AUDIO_BUS_MUSIC]) {
+            SDL_memset(music->buffer, 0, frames * SL__MIXER_CHANNELS * sizeof(float));
+            bus_used[SL_AUDIO_BUS_MUSIC] = true;
+        }
+
+        // Only offline streams end here, the stream thread ends the others
+        if (sl__audio_stream_render(stream, music->buffer, frames)) i++;
+        else sl__audio_stream_deactivate(stream);
+    }
+
+    /* --- Run the buses into the output --- */
+
+    // NOTE: A bus left without input keeps running until its reverb tail
+    //       and gain ramps have faded, silent buses cost nothing after that.
+
+    SDL_memset(out, 0, frames * SL__MIXER_CHANNELS * sizeof(float));
+
+    for (int i = 0; i < SL_AUDIO_BUS_COUNT; i++)
+    {
+        sl__bus_t* bus = &sl__mixer.buses[i];
+
+        if (bus_used[i]) {
+            bus->tail = bus->reverb.enabled ? bus->reverb.tail : 2 * SL__MIXER_BLOCK_FRAMES;
+        }
+        else if (bus->tail > 0) {
+            SDL_memset(bus->buffer, 0, frames * SL__MIXER_CHANNELS * sizeof(float));
+            bus->tail -= frames;
+        }
+        else {
+            bus->gain = bus->gain_target;
+            continue;
+        }
+
+        sl__mixer_bus_process(bus, out, frames);
+    }
+
+    /* --- Master gain and clipping --- */
+
+    float gain = sl__mixer_smooth(sl__mixer.output_gain, sl__mixer.master_gain, frames);
+    sl__mixer_ramp(out, frames, sl__mixer.output_gain, gain);
+    sl__mixer.output_gain = gain;
+
+    sl__mixer_clip(out, frames * SL__MIXER_CHANNELS);
+}
+
+/* === Device Callback === */
+
+static void SDLCALL sl__mixer_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount)
+{
+    (void)userdata;
+    (void)total_amount;
+
+    const int frame_size = SL__MIXER_CHANNELS * sizeof(float);
+    float block[SL__MIXER_BLOCK_FRAMES * SL__MIXER_CHANNELS];
+
+    int frames = (additional_amount + frame_size - 1) / frame_size;
+
+    while (frames > 0) {
+        int count = SL_MIN(frames, SL__MIXER_BLOCK_FRAMES);
+        sl__mixer_render(block, count);
+        SDL_PutAudioStreamData(stream, block, count * frame_size);
+        frames -= count;
+    }
+}
+
+/* === Module Functions === */
+
+bool sl__mixer_init(void)
+{
+    /* --- Setup the voice pool --- */
+
+    for (int i = 0; i < SL__MIXER_VOICE_COUNT; i++) {
+        sl__mixer.free_voices[i] = SL__MIXER_VOICE_COUNT - 1 - i;
+    }
+
+    sl__mixer.free_count = SL__MIXER_VOICE_COUNT;
+    sl__mixer.active_count = 0;
+    sl__mixer.sample_gain = 1.0f;
+    sl__mixer.voice_gain = 1.0f;
+    sl__mixer.master_gain = 1.0f;
+    sl__mixer.output_gain = 1.0f;
+    sl__mixer.play_counter = 0;
+
+    for (int i = 0; i < SL_AUDIO_BUS_COUNT; i++) {
+        sl__mixer_bus_init(&sl__mixer.buses[i]);
+    }
+
+    /* --- Create the command queue --- */
+
+    if (!sl__audio_queue_create(&sl__mixer.commands, SL__MIXER_COMMAND_QUEUE_SIZE, sizeof(sl__mixer_command_t))) {
+        sl_loge("AUDIO: Failed to create mixer command queue");
+        return false;
+    }
+
+    /* --- Open the device stream, offline renders are pulled by the API --- */
+
+    if (sl__audio.offline) {
+        sl__mixer.is_running = true;
+        return true;
+    }
+
+    if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+        sl_loge("AUDIO: Failed to initialize SDL audio; %s", SDL_GetError());
+        sl__audio_queue_destroy(&sl__mixer.commands);
+        return false;
+    }
+
+    SDL_AudioSpec spec = {
+        .format = SDL_AUDIO_F32,
+        .channels = SL__MIXER_CHANNELS,
+        .freq = SL__MIXER_SAMPLE_RATE
+    };
+
+    sl__mixer.device_stream = SDL_OpenAudioDeviceStream(
+        SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec,
+        sl__mixer_callback, NULL
+    );
+
+    if (!sl__mixer.device_stream) {
+        sl_loge("AUDIO: Failed to open mixer device stream; %s", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        sl__audio_queue_destroy(&sl__mixer.commands);
+        return false;
+    }
+
+    SDL_ResumeAudioStreamDevice(sl__mixer.device_stream);
+
+    sl__mixer.is_running = true;
+
+    return true;
+}
+
+void sl__mixer_quit(void)
+{
+    if (!sl__mixer.is_running) {
+        return;
+    }
+
+    sl__mixer.is_running = false;
+
+    /* --- Stop the callback, the commands left are executed here --- */
+
+    if (sl__mixer.device_stream) {
+        SDL_DestroyAudioStream(sl__mixer.device_stream);
+        sl__mixer.device_stream = NULL;
+    }
+
+    sl__mixer_process_commands();
+
+    /* --- Detach voices still playing --- */
+
+    while (sl__mixer.active_count > 0) {
+        sl__mixer_voice_release(sl__mixer.active_voices[0]);
+    }
+
+    sl__audio_queue_destroy(&sl__mixer.commands);
+
+    if (!sl__audio.offline) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+}
+
+/* === Mixer Functions === */
+
+bool sl__mixer_post(const sl__mixer_command_t* command)
+{
+    if (!sl__mixer.is_running) {
+        return false;
+    }
+
+    while (!sl__audio_queue_push(&sl__mixer.commands, command)) {
+        // NOTE: Queue full, the commands are executed here instead of waiting
+        //       for the callback, which may not run while the device is paused.
+        //       Offline, this thread is the one executing the commands anyway.
+        sl__mixer_lock();
+        sl__mixer_process_commands();
+        sl__mixer_unlock();
+    }
+
+    return true;
+}
+
+void sl__mixer_lock(void)
+{
+    // NOTE: The stream lock is held by SDL during the callback,
+    //       so holding it keeps the mixer state to this thread.
+
+    if (sl__mixer.device_stream) {
+        SDL_LockAudioStream(sl__mixer.device_stream);
+    }
+}
+
+void sl__mixer_unlock(void)
+{
+    if (sl__mixer.device_stream) {
+        SDL_UnlockAudioStream(sl__mixer.device_stream);
+    }
+}
+
+void sl__mixer_render(float* out, int frames)
+{
+    sl__mixer_process_commands();
+
+#if defined(SL__MIXER_SSE2)
+    // Flush denormals to zero, decaying filters and reverb tails produce them
+    unsigned int csr = _mm_getcsr();
+    _mm_setcsr(csr | 0x8040);
+#endif
+
+    while (frames > 0) {
+        int count = SL_MIN(frames, SL__MIXER_BLOCK_FRAMES);
+        sl__mixer_render_block(out, count);
+        out += count * SL__MIXER_CHANNELS;
+        frames -= count;
+    }
+
+#if defined(SL__MIXER_SSE2)
+    _mm_setcsr(csr);
+#endif
+}
+
+void sl__mixer_bus_desc_resolve(sl_audio_bus_desc_t* out, const sl_audio_bus_desc_t* desc)
+{
+    sl_audio_bus_desc_t resolved = { 0 };
+    if (desc != NULL) {
+        resolved = *desc;
+    }
+
+    if (resolved.filter < SL_AUDIO_FILTER_NONE || resolved.filter > SL_AUDIO_FILTER_HIGHPASS) {
+        sl_logw("AUDIO: Unknown bus filter %d, filter bypassed", resolved.filter);
+        resolved.filter = SL_AUDIO_FILTER_NONE;
+    }
+
+    if (resolved.filter_q <= 0.0f) resolved.filter_q = 0.707f;
+    if (resolved.compressor_ratio < 1.0f) resolved.compressor_ratio = 1.0f;
+    if (resolved.compressor_attack <= 0.0f) resolved.compressor_attack = 0.005f;
+    if (resolved.compressor_release <= 0.0f) resolved.compressor_release = 0.1f;
+
+    resolved.filter_cutoff = SL_CLAMP(resolved.filter_cutoff, 10.0f, 0.45f * SL__MIXER_SAMPLE_RATE);
+    resolved.filter_q = SL_CLAMP(resolved.filter_q, 0.1f, 20.0f);
+    resolved.reverb_mix = SL_CLAMP(resolved.reverb_mix, 0.0f, 1.0f);
+    resolved.reverb_room_size = SL_CLAMP(resolved.reverb_room_size, 0.0f, 1.0f);
+    resolved.reverb_damping = SL_CLAMP(resolved.reverb_damping, 0.0f, 1.0f);
+    resolved.compressor_threshold = SL_CLAMP(resolved.compressor_threshold, -60.0f, 0.0f);
+    resolved.compressor_attack = SL_CLAMP(resolved.compressor_attack, 0.0001f, 1.0f);
+    resolved.compressor_release = SL_CLAMP(resolved.compressor_release, 0.001f, 5.0f);
+
+    *out = resolved;
+}
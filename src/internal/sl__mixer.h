@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2025 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SL__MIXER_H
+#define SL__MIXER_H
+
+#include <smol.h>
+
+#include "./sl__audio.h"
+
+#include <SDL3/SDL_audio.h>
+
+/* === Constants === */
+
+#define SL__MIXER_SAMPLE_RATE 48000
+#define SL__MIXER_CHANNELS 2
+#define SL__MIXER_BLOCK_FRAMES 256
+#define SL__MIXER_VOICE_COUNT 256
+#define SL__MIXER_COMMAND_QUEUE_SIZE 1024  //< Must be a power of two
+
+#define SL__MIXER_GAIN_SMOOTHING 0.01f      //< Time constant of the gain ramps in seconds
+#define SL__MIXER_COMPRESSOR_CHUNK 16       //< Frames sharing one compressor gain step
+
+#define SL__REVERB_COMBS 4
+#define SL__REVERB_ALLPASSES 2
+#define SL__REVERB_COMB_MAX 1536            //< Longest comb delay in frames, stereo spread included
+#define SL__REVERB_ALLPASS_MAX 640
+
+/* === Internal Enums === */
+
+typedef enum {
+    SL__MIXER_CMD_PLAY,
+    SL__MIXER_CMD_PAUSE,
+    SL__MIXER_CMD_STOP,
+    SL__MIXER_CMD_VOLUME,
+    SL__MIXER_CMD_PAN,
+    SL__MIXER_CMD_GAIN,
+    SL__MIXER_CMD_MASTER_GAIN,
+    SL__MIXER_CMD_BUS_GAIN,
+    SL__MIXER_CMD_BUS_DESC,
+    SL__MIXER_CMD_DESTROY,
+} sl__mixer_command_type_t;
+
+/* === Internal Structs === */
+
+typedef struct {
+    sl__mixer_command_type_t type;
+    sl__sample_t* sample;
+    int channel;                    ///< Sample channel, negative for all of them
+    int priority;
+    sl_audio_bus_t bus;             ///< Bus to play on or to change
+    float value;
+    sl_audio_bus_desc_t bus_desc;   ///< Resolved effects, SL__MIXER_CMD_BUS_DESC only
+} sl__mixer_command_t;
+
+typedef struct {
+    sl__sample_t* sample;           ///< NULL when the voice is free
+    int channel;
+    int position;                   ///< Next frame to mix
+    int cached_block;               ///< ADPCM block held in the voice cache, -1 if none
+    int priority;
+    sl_audio_bus_t bus;
+    uint64_t start;                 ///< Play order, the oldest voice is stolen first
+    int active_index;
+    bool is_paused;
+} sl__voice_t;
+
+typedef struct {
+    bool enabled;
+    float b0, b1, b2, a1, a2;       ///< Coefficients normalized by a0
+    float z1[2], z2[2];             ///< Transposed direct form II state, per channel
+} sl__biquad_t;
+
+typedef struct {
+    bool enabled;
+    float threshold;                ///< dBFS
+    float slope;                    ///< Gain reduction per dB above the threshold
+    float attack;                   ///< Envelope coefficients per compressor chunk
+    float release;
+    float envelope;                 ///< Smoothed peak level in dBFS
+    float gain;                     ///< Gain applied at the end of the last chunk
+} sl__compressor_t;
+
+typedef struct {
+    bool enabled;
+    float wet;
+    float feedback;
+    float damping;
+    int tail;                       ///< Frames for the tail to fade under -60 dB
+    int comb_length[SL__REVERB_COMBS][2];
+    int comb_pos[SL__REVERB_COMBS][2];
+    float comb_store[SL__REVERB_COMBS][2];
+    float comb[SL__REVERB_COMBS][2][SL__REVERB_COMB_MAX];
+    int allpass_length[SL__REVERB_ALLPASSES][2];
+    int allpass_pos[SL__REVERB_ALLPASSES][2];
+    float allpass[SL__REVERB_ALLPASSES][2][SL__REVERB_ALLPASS_MAX];
+} sl__reverb_t;
+
+typedef struct {
+    float buffer[SL__MIXER_BLOCK_FRAMES * SL__MIXER_CHANNELS];
+    sl__biquad_t filter;
+    sl__reverb_t reverb;
+    sl__compressor_t compressor;
+    float gain;                     ///< Gain reached at the end of the last block
+    float gain_target;
+    int tail;                       ///< Frames left to process once the bus gets no input
+} sl__bus_t;
+
+/* === Global State === */
+
+// NOTE: Everything here except the command queue and the stream handle is
+//       owned by the audio callback once the device runs, the API only
+//       posts commands and reads back the sample channel states.
+//       The active streams are mixed on the music bus from their ring,
+//       the stream thread changes them under sl__mixer_lock().
+
+extern struct sl__mixer {
+
+    SDL_AudioStream* device_stream;
+    sl__audio_queue_t commands;
+    bool is_running;                ///< Commands are executed, by the device or by offline renders
+
+    sl__voice_t voices[SL__MIXER_VOICE_COUNT];
+    int active_voices[SL__MIXER_VOICE_COUNT];
+    int free_voices[SL__MIXER_VOICE_COUNT];
+    int active_count;
+    int free_count;
+
+    // One decoded ADPCM block per voice
+    int16_t block_cache[SL__MIXER_VOICE_COUNT][SL__ADPCM_BLOCK_FRAMES * SL__MIXER_CHANNELS];
+
+    // Voices are summed per bus, then the buses into the output
+    sl__bus_t buses[SL_AUDIO_BUS_COUNT];
+
+    float sample_gain;              ///< Sample volume, applied to the voices before their bus
+    float voice_gain;               ///< Gain reached toward 'sample_gain' at the end of the last block
+    float master_gain;              ///< Master volume, applied to the output
+    float output_gain;              ///< Gain reached toward 'master_gain' at the end of the last block
+    uint64_t play_counter;
+
+} sl__mixer;
+
+/* === Module Functions === */
+
+bool sl__mixer_init(void);
+void sl__mixer_quit(void);
+
+/* === Mixer Functions === */
+
+bool sl__mixer_post(const sl__mixer_command_t* command);
+void sl__mixer_render(float* out, int frames);
+
+void sl__mixer_lock(void);      // Keeps the callback out, no-op offline
+void sl__mixer_unlock(void);
+
+void sl__mixer_bus_desc_resolve(sl_audio_bus_desc_t* out, const sl_audio_bus_desc_t* desc);
+
+#endif // SL__MIXER_H
@@ -0,0 +1,1190 @@
+/**
+ * Copyright (c) 2025 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "./sl__raster.h"
+#include "./sl__simd.h"
+
+#include <SDL3/SDL_surface.h>
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_thread.h>
+#include <SDL3/SDL_mutex.h>
+
+#include <math.h>
+
+/* === Helper Functions === */
+
+// NOTE: Pixels are shaded four at a time along a row, the lanes
+//       hold a 1x4 span with every attribute stored per channel.
+
+static inline uint32_t sl__raster_pack_color(sl_color_t color)
+{
+    return (uint32_t)color.r | ((uint32_t)color.g << 8) | ((uint32_t)color.b << 16) | ((uint32_t)color.a << 24);
+}
+
+/* === Internal Structs === */
+
+typedef struct {
+    float x, y, z, w;           ///< Clip space position
+    float u, v;
+    float r, g, b, a;
+} sl__raster_vertex_t;
+
+typedef struct {
+    float x, y;                 ///< Window position, bottom-left origin
+    float inv_w;
+    float u, v;                 ///< Divided by w
+    float c[4];                 ///< Divided by w
+    bool valid;                 ///< False when in front of the near plane, the primitive is clipped
+    bool affine;                ///< True when w is one, skips the perspective divide
+} sl__raster_point_t;
+
+typedef struct {
+    const uint32_t* pixels;
+    int w, h;
+    sl_filter_mode_t filter;
+    sl_wrap_mode_t wrap;
+    sl_blend_mode_t blend_mode;
+    bool constant;              ///< 1x1 texture, sampled once
+    float texel[4];
+} sl__raster_state_t;
+
+typedef struct {
+    float a[3], b[3], c[3];     ///< Edge functions, edge i gives the weight of vertex i
+    bool top_left[3];
+    float inv_area;
+    float inv_w[3];
+    float u[3], v[3];
+    float col[4][3];
+    int x0, y0, x1, y1;         ///< Inclusive bounds, already clipped
+    int state;
+    bool affine;
+} sl__raster_triangle_t;
+
+/* === Pipeline State === */
+
+struct sl__raster sl__raster = { 0 };
+
+static struct {
+
+    sl__texture_t* target;
+    sl__raster_rect_t clip;
+
+    sl__raster_vertex_t* vertices;  ///< Clip space copies of the points, used by the near plane clipping
+    sl__raster_point_t* points;
+    int vertex_capacity;
+    int point_count;
+    int point_capacity;
+
+    sl__raster_triangle_t* triangles;
+    int triangle_count;
+    int triangle_capacity;
+
+    sl__raster_state_t* states;
+    int state_count;
+    int state_capacity;
+
+    int* tile_counts;
+    int* tile_offsets;
+    int* tile_cursors;
+    int* jobs;
+    int tile_capacity;
+    int tiles_x;
+    int job_count;
+
+    int* items;
+    int item_capacity;
+
+    SDL_Thread* threads[SL__RASTER_MAX_THREADS];
+    int thread_count;
+
+    SDL_Mutex* mutex;
+    SDL_Condition* cond_work;
+    SDL_Condition* cond_done;
+    SDL_AtomicInt next_job;
+    int generation;
+    int busy;
+    bool quit;
+
+} sl__pipeline = { 0 };
+
+/* === Internal Functions === */
+
+static bool sl__raster_reserve(void** buffer, int* capacity, int needed, size_t elem_size)
+{
+    if (needed <= *capacity) {
+        return true;
+    }
+
+    int new_capacity = SL_MAX(*capacity * 2, needed);
+    void* new_buffer = SDL_realloc(*buffer, new_capacity * elem_size);
+    if (new_buffer == NULL) {
+        sl_loge("RENDER: Software rasterizer out of memory");
+        return false;
+    }
+
+    *buffer = new_buffer;
+    *capacity = new_capacity;
+
+    return true;
+}
+
+static bool sl__raster_reserve_points(int count)
+{
+    return sl__raster_reserve((void**)&sl__pipeline.points, &sl__pipeline.point_capacity, count, sizeof(sl__raster_point_t))
+        && sl__raster_reserve((void**)&sl__pipeline.vertices, &sl__pipeline.vertex_capacity, count, sizeof(sl__raster_vertex_t));
+}
+
+static bool sl__raster_reserve_tiles(int count)
+{
+    if (count <= sl__pipeline.tile_capacity) {
+        return true;
+    }
+
+    int* buffers[4] = {
+        sl__pipeline.tile_counts, sl__pipeline.tile_offsets,
+        sl__pipeline.tile_cursors, sl__pipeline.jobs
+    };
+
+    bool ok = true;
+    for (int i = 0; i < 4; i++) {
+        int* buffer = SDL_realloc(buffers[i], count * sizeof(int));
+        if (buffer != NULL) buffers[i] = buffer;
+        else ok = false;
+    }
+
+    sl__pipeline.tile_counts = buffers[0];
+    sl__pipeline.tile_offsets = buffers[1];
+    sl__pipeline.tile_cursors = buffers[2];
+    sl__pipeline.jobs = buffers[3];
+
+    if (!ok) {
+        sl_loge("RENDER: Software rasterizer out of memory");
+        return false;
+    }
+
+    sl__pipeline.tile_capacity = count;
+
+    return true;
+}
+
+static inline int sl__raster_wrap(int i, int size, sl_wrap_mode_t wrap)
+{
+    if (wrap == SL_WRAP_REPEAT) {
+        i %= size;
+        return (i < 0) ? i + size : i;
+    }
+    return (i < 0) ? 0 : (i >= size ? size - 1 : i);
+}
+
+static inline uint32_t sl__raster_fetch(const sl__raster_state_t* state, int x, int y)
+{
+    x = sl__raster_wrap(x, state->w, state->wrap);
+    y = sl__raster_wrap(y, state->h, state->wrap);
+    return state->pixels[y * state->w + x];
+}
+
+static void sl__raster_sample(const sl__raster_state_t* state, sl__f4 u, sl__f4 v, int bits, sl__f4 out[4])
+{
+    if (state->constant) {
+        for (int i = 0; i < 4; i++) {
+            out[i] = sl__f4_set1(state->texel[i]);
+        }
+        return;
+    }
+
+    float us[4], vs[4];
+    sl__f4_store(us, u);
+    sl__f4_store(vs, v);
+
+    if (state->filter == SL_FILTER_NEAREST) {
+        uint32_t t[4] = { 0 };
+        for (int i = 0; i < 4; i++) {
+            if (bits & (1 << i)) {
+                t[i] = sl__raster_fetch(state, (int)floorf(us[i] * state->w), (int)floorf(vs[i] * state->h));
+            }
+        }
+        sl__u4 texels = sl__u4_set(t);
+        for (int c = 0; c < 4; c++) {
+            out[c] = sl__u4_channel(texels, c * 8);
+        }
+        return;
+    }
+
+    uint32_t t00[4] = { 0 }, t10[4] = { 0 }, t01[4] = { 0 }, t11[4] = { 0 };
+    float fx[4] = { 0 }, fy[4] = { 0 };
+
+    for (int i = 0; i < 4; i++) {
+        if (bits & (1 << i)) {
+            float x = us[i] * state->w - 0.5f;
+            float y = vs[i] * state->h - 0.5f;
+            float x0 = floorf(x), y0 = floorf(y);
+            fx[i] = x - x0, fy[i] = y - y0;
+            int ix = (int)x0, iy = (int)y0;
+            t00[i] = sl__raster_fetch(state, ix, iy);
+            t10[i] = sl__raster_fetch(state, ix + 1, iy);
+            t01[i] = sl__raster_fetch(state, ix, iy + 1);
+            t11[i] = sl__raster_fetch(state, ix + 1, iy + 1);
+        }
+    }
+
+    sl__u4 q00 = sl__u4_set(t00), q10 = sl__u4_set(t10);
+    sl__u4 q01 = sl__u4_set(t01), q11 = sl__u4_set(t11);
+    sl__f4 wx = sl__f4_set(fx[0], fx[1], fx[2], fx[3]);
+    sl__f4 wy = sl__f4_set(fy[0], fy[1], fy[2], fy[3]);
+
+    for (int c = 0; c < 4; c++) {
+        sl__f4 c00 = sl__u4_channel(q00, c * 8), c10 = sl__u4_channel(q10, c * 8);
+        sl__f4 c01 = sl__u4_channel(q01, c * 8), c11 = sl__u4_channel(q11, c * 8);
+        sl__f4 top = sl__f4_add(c00, sl__f4_mul(sl__f4_sub(c10, c00), wx));
+        sl__f4 bot = sl__f4_add(c01, sl__f4_mul(sl__f4_sub(c11, c01), wx));
+        out[c] = sl__f4_add(top, sl__f4_mul(sl__f4_sub(bot, top), wy));
+    }
+}
+
+static sl__u4 sl__raster_blend(sl_blend_mode_t mode, const sl__f4 src[4], sl__u4 dst_px)
+{
+    if (mode == SL_BLEND_OPAQUE) {
+        return sl__u4_pack(src[0], src[1], src[2], src[3]);
+    }
+
+    const sl__f4 one = sl__f4_set1(1.0f);
+
+    sl__f4 dst[4];
+    for (int c = 0; c < 4; c++) {
+        dst[c] = sl__u4_channel(dst_px, c * 8);
+    }
+
+    sl__f4 out[4];
+    sl__f4 sa = src[3];
+    sl__f4 inv_sa = sl__f4_sub(one, sa);
+
+    // Same factors as the glBlendFunc() calls of the GL backends,
+    // they also apply to the alpha channel
+    for (int c = 0; c < 4; c++) {
+        switch (mode) {
+        case SL_BLEND_PREMUL:
+            out[c] = sl__f4_add(src[c], sl__f4_mul(dst[c], inv_sa));
+            break;
+        case SL_BLEND_ALPHA:
+            out[c] = sl__f4_add(sl__f4_mul(src[c], sa), sl__f4_mul(dst[c], inv_sa));
+            break;
+        case SL_BLEND_MUL:
+            out[c] = sl__f4_mul(src[c], dst[c]);
+            break;
+        case SL_BLEND_ADD:
+            out[c] = sl__f4_add(sl__f4_mul(src[c], sa), dst[c]);
+            break;
+        default:
+            out[c] = src[c];
+            break;
+        }
+    }
+
+    return sl__u4_pack(out[0], out[1], out[2], out[3]);
+}
+
+static void sl__raster_shade(const sl__raster_triangle_t* tri, const sl__raster_state_t* state,
+                             uint32_t* dst, sl__f4 e[3], sl__m4 mask, int bits, bool full)
+{
+    /* --- Barycentric weights --- */
+
+    sl__f4 inv_area = sl__f4_set1(tri->inv_area);
+    sl__f4 w0 = sl__f4_mul(e[0], inv_area);
+    sl__f4 w1 = sl__f4_mul(e[1], inv_area);
+    sl__f4 w2 = sl__f4_mul(e[2], inv_area);
+
+#   define INTERP(arr) sl__f4_add(sl__f4_add(sl__f4_mul(w0, sl__f4_set1((arr)[0])), \
+                                              sl__f4_mul(w1, sl__f4_set1((arr)[1]))), \
+                                              sl__f4_mul(w2, sl__f4_set1((arr)[2])))
+
+    /* --- Interpolate attributes --- */
+
+    sl__f4 u = INTERP(tri->u);
+    sl__f4 v = INTERP(tri->v);
+
+    sl__f4 color[4];
+    for (int c = 0; c < 4; c++) {
+        color[c] = INTERP(tri->col[c]);
+    }
+
+    if (!tri->affine) {
+        sl__f4 w = sl__f4_div(sl__f4_set1(1.0f), INTERP(tri->inv_w));
+        u = sl__f4_mul(u, w);
+        v = sl__f4_mul(v, w);
+        for (int c = 0; c < 4; c++) {
+            color[c] = sl__f4_mul(color[c], w);
+        }
+    }
+
+#   undef INTERP
+
+    /* --- Default shader: color * texture --- */
+
+    sl__f4 src[4];
+    sl__raster_sample(state, u, v, bits, src);
+    for (int c = 0; c < 4; c++) {
+        src[c] = sl__f4_mul(src[c], color[c]);
+    }
+
+    /* --- Blend and write covered pixels --- */
+
+    if (full) {
+        sl__u4 old_px = sl__u4_load(dst);
+        sl__u4 new_px = sl__raster_blend(state->blend_mode, src, old_px);
+        sl__u4_store(dst, sl__u4_select(mask, new_px, old_px));
+    }
+    else {
+        // The span crosses the end of the tile, only touch covered pixels
+        // since the rest may belong to a tile owned by another thread
+        uint32_t lanes[4] = { 0 };
+        for (int i = 0; i < 4; i++) {
+            if (bits & (1 << i)) lanes[i] = dst[i];
+        }
+        sl__u4 new_px = sl__raster_blend(state->blend_mode, src, sl__u4_set(lanes));
+        sl__u4_get(lanes, new_px);
+        for (int i = 0; i < 4; i++) {
+            if (bits & (1 << i)) dst[i] = lanes[i];
+        }
+    }
+}
+
+static inline sl__m4 sl__raster_inside(sl__f4 e, bool top_left)
+{
+    // Top-left fill rule, pixels exactly on an edge only belong to
+    // top or left edges so shared edges are never drawn twice
+    const sl__f4 zero = sl__f4_set1(0.0f);
+    return sl__m4_or(sl__f4_gt(e, zero), sl__m4_and(sl__f4_eq(e, zero), sl__m4_from_bool(top_left)));
+}
+
+static void sl__raster_triangle(const sl__raster_triangle_t* tri, const sl__raster_rect_t* tile)
+{
+    int x0 = SL_MAX(tri->x0, tile->x);
+    int y0 = SL_MAX(tri->y0, tile->y);
+    int x1 = SL_MIN(tri->x1, tile->x + tile->w - 1);
+    int y1 = SL_MIN(tri->y1, tile->y + tile->h - 1);
+
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    const sl__raster_state_t* state = &sl__pipeline.states[tri->state];
+    uint32_t* pixels = sl__pipeline.target->pixels;
+    int pitch = sl__pipeline.target->w;
+
+    const sl__f4 lanes = sl__f4_set(0.0f, 1.0f, 2.0f, 3.0f);
+
+    sl__f4 step[3];
+    for (int i = 0; i < 3; i++) {
+        step[i] = sl__f4_set1(tri->a[i] * 4.0f);
+    }
+
+    for (int y = y0; y <= y1; y++)
+    {
+        float px = x0 + 0.5f;
+        float py = y + 0.5f;
+
+        sl__f4 e[3];
+        for (int i = 0; i < 3; i++) {
+            float row = tri->a[i] * px + tri->b[i] * py + tri->c[i];
+            e[i] = sl__f4_add(sl__f4_set1(row), sl__f4_mul(sl__f4_set1(tri->a[i]), lanes));
+        }
+
+        uint32_t* row = pixels + (size_t)y * pitch;
+
+        for (int x = x0; x <= x1; x += 4)
+        {
+            sl__m4 mask = sl__m4_and(sl__m4_and(
+                sl__raster_inside(e[0], tri->top_left[0]),
+                sl__raster_inside(e[1], tri->top_left[1])),
+                sl__raster_inside(e[2], tri->top_left[2]));
+
+            bool full = (x + 3 <= x1);
+            if (!full) {
+                mask = sl__m4_and(mask, sl__f4_gt(sl__f4_set1((float)(x1 - x) + 0.5f), lanes));
+            }
+
+            int bits = sl__m4_bits(mask);
+            if (bits != 0) {
+                sl__raster_shade(tri, state, row + x, e, mask, bits, full);
+            }
+
+            for (int i = 0; i < 3; i++) {
+                e[i] = sl__f4_add(e[i], step[i]);
+            }
+        }
+    }
+}
+
+static void sl__raster_run_jobs(void)
+{
+    const int ts = SL__RASTER_TILE_SIZE;
+
+    for (;;)
+    {
+        int job = SDL_AddAtomicInt(&sl__pipeline.next_job, 1);
+        if (job >= sl__pipeline.job_count) break;
+
+        int tile = sl__pipeline.jobs[job];
+        sl__raster_rect_t rect = {
+            .x = (tile % sl__pipeline.tiles_x) * ts,
+            .y = (tile / sl__pipeline.tiles_x) * ts,
+            .w = ts, .h = ts
+        };
+
+        const int* items = sl__pipeline.items + sl__pipeline.tile_offsets[tile];
+        for (int i = 0; i < sl__pipeline.tile_counts[tile]; i++) {
+            sl__raster_triangle(&sl__pipeline.triangles[items[i]], &rect);
+        }
+    }
+}
+
+static int sl__raster_worker(void* data)
+{
+    (void)data;
+
+    int generation = 0;
+
+    SDL_LockMutex(sl__pipeline.mutex);
+
+    for (;;)
+    {
+        while (!sl__pipeline.quit && generation == sl__pipeline.generation) {
+            SDL_WaitCondition(sl__pipeline.cond_work, sl__pipeline.mutex);
+        }
+
+        if (sl__pipeline.quit) {
+            break;
+        }
+
+        generation = sl__pipeline.generation;
+        SDL_UnlockMutex(sl__pipeline.mutex);
+
+        sl__raster_run_jobs();
+
+        SDL_LockMutex(sl__pipeline.mutex);
+        if (--sl__pipeline.busy == 0) {
+            SDL_SignalCondition(sl__pipeline.cond_done);
+        }
+    }
+
+    SDL_UnlockMutex(sl__pipeline.mutex);
+
+    return 0;
+}
+
+static void sl__raster_dispatch(int item_count)
+{
+    SDL_SetAtomicInt(&sl__pipeline.next_job, 0);
+
+    // Waking the workers is not worth it for tiny batches
+    if (sl__pipeline.thread_count == 0 || sl__pipeline.job_count < 2 || item_count < 32) {
+        sl__raster_run_jobs();
+        return;
+    }
+
+    SDL_LockMutex(sl__pipeline.mutex);
+    sl__pipeline.busy = sl__pipeline.thread_count;
+    sl__pipeline.generation++;
+    SDL_BroadcastCondition(sl__pipeline.cond_work);
+    SDL_UnlockMutex(sl__pipeline.mutex);
+
+    sl__raster_run_jobs();
+
+    SDL_LockMutex(sl__pipeline.mutex);
+    while (sl__pipeline.busy > 0) {
+        SDL_WaitCondition(sl__pipeline.cond_done, sl__pipeline.mutex);
+    }
+    SDL_UnlockMutex(sl__pipeline.mutex);
+}
+
+static int sl__raster_push_state(const sl__texture_t* texture, sl_blend_mode_t blend_mode)
+{
+    if (!sl__raster_reserve((void**)&sl__pipeline.states, &sl__pipeline.state_capacity,
+                            sl__pipeline.state_count + 1, sizeof(sl__raster_state_t))) {
+        return -1;
+    }
+
+    sl__raster_state_t* state = &sl__pipeline.states[sl__pipeline.state_count];
+
+    state->pixels = texture->pixels;
+    state->w = texture->w;
+    state->h = texture->h;
+    state->filter = texture->filter;
+    state->wrap = texture->wrap;
+    state->blend_mode = blend_mode;
+    state->constant = (texture->w == 1 && texture->h == 1);
+
+    if (state->constant) {
+        uint32_t t = texture->pixels[0];
+        for (int c = 0; c < 4; c++) {
+            state->texel[c] = (float)((t >> (c * 8)) & 0xFF) / 255.0f;
+        }
+    }
+
+    return sl__pipeline.state_count++;
+}
+
+static inline float sl__raster_plane_distance(const sl__raster_vertex_t* v, int plane)
+{
+    // NOTE: Plane 0 is the GL near plane (z >= -w), plane 1 only
+    //       keeps w positive for projections without a near plane.
+
+    return (plane == 0) ? v->z + v->w : v->w - 1e-6f;
+}
+
+static inline bool sl__raster_is_clipped(const sl__raster_vertex_t* v)
+{
+    return sl__raster_plane_distance(v, 0) < 0.0f || sl__raster_plane_distance(v, 1) < 0.0f;
+}
+
+static sl__raster_vertex_t sl__raster_lerp_vertex(const sl__raster_vertex_t* a, const sl__raster_vertex_t* b, float t)
+{
+    return (sl__raster_vertex_t) {
+        a->x + (b->x - a->x) * t, a->y + (b->y - a->y) * t,
+        a->z + (b->z - a->z) * t, a->w + (b->w - a->w) * t,
+        a->u + (b->u - a->u) * t, a->v + (b->v - a->v) * t,
+        a->r + (b->r - a->r) * t, a->g + (b->g - a->g) * t,
+        a->b + (b->b - a->b) * t, a->a + (b->a - a->a) * t
+    };
+}
+
+static sl__raster_point_t sl__raster_project(const sl__raster_vertex_t* v)
+{
+    // NOTE: The vertex must be on the visible side of the near plane,
+    //       the clamp only absorbs the rounding of the clipped vertices.
+
+    sl__raster_point_t p = { 0 };
+
+    const sl__raster_rect_t* vp = &sl__raster.viewport;
+
+    p.inv_w = 1.0f / fmaxf(v->w, 1e-6f);
+    p.x = vp->x + (v->x * p.inv_w * 0.5f + 0.5f) * vp->w;
+    p.y = vp->y + (v->y * p.inv_w * 0.5f + 0.5f) * vp->h;
+    p.u = v->u * p.inv_w;
+    p.v = v->v * p.inv_w;
+    p.c[0] = v->r * p.inv_w;
+    p.c[1] = v->g * p.inv_w;
+    p.c[2] = v->b * p.inv_w;
+    p.c[3] = v->a * p.inv_w;
+    p.affine = (fabsf(v->w - 1.0f) < 1e-6f);
+    p.valid = true;
+
+    return p;
+}
+
+static void sl__raster_setup_triangle(const sl__raster_point_t* p0, const sl__raster_point_t* p1,
+                                      const sl__raster_point_t* p2, int state, bool cull)
+{
+    if (!p0->valid || !p1->valid || !p2->valid) {
+        return;
+    }
+
+    /* --- Orientation and culling --- */
+
+    // Window coordinates have a bottom-left origin like GL,
+    // so a positive area means counter-clockwise (front facing)
+
+    float area = (p1->x - p0->x) * (p2->y - p0->y) - (p2->x - p0->x) * (p1->y - p0->y);
+    if (area == 0.0f || !isfinite(area)) {
+        return;
+    }
+
+    if (cull) {
+        if (sl__raster.cull_mode == SL_CULL_BACK && area < 0.0f) return;
+        if (sl__raster.cull_mode == SL_CULL_FRONT && area > 0.0f) return;
+    }
+
+    if (area < 0.0f) {
+        const sl__raster_point_t* tmp = p1;
+        p1 = p2, p2 = tmp;
+        area = -area;
+    }
+
+    /* --- Clipped bounds --- */
+
+    const sl__raster_rect_t* clip = &sl__pipeline.clip;
+
+    float min_x = fminf(p0->x, fminf(p1->x, p2->x));
+    float min_y = fminf(p0->y, fminf(p1->y, p2->y));
+    float max_x = fmaxf(p0->x, fmaxf(p1->x, p2->x));
+    float max_y = fmaxf(p0->y, fmaxf(p1->y, p2->y));
+
+    int x0 = SL_MAX((int)floorf(min_x), clip->x);
+    int y0 = SL_MAX((int)floorf(min_y), clip->y);
+    int x1 = SL_MIN((int)ceilf(max_x), clip->x + clip->w) - 1;
+    int y1 = SL_MIN((int)ceilf(max_y), clip->y + clip->h) - 1;
+
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    /* --- Push the triangle setup --- */
+
+    if (!sl__raster_reserve((void**)&sl__pipeline.triangles, &sl__pipeline.triangle_capacity,
+                            sl__pipeline.triangle_count + 1, sizeof(sl__raster_triangle_t))) {
+        return;
+    }
+
+    sl__raster_triangle_t* tri = &sl__pipeline.triangles[sl__pipeline.triangle_count++];
+    const sl__raster_point_t* p[3] = { p0, p1, p2 };
+
+    for (int i = 0; i < 3; i++)
+    {
+        const sl__raster_point_t* a = p[(i + 1) % 3];
+        const sl__raster_point_t* b = p[(i + 2) % 3];
+
+        float dx = b->x - a->x;
+        float dy = b->y - a->y;
+
+        tri->a[i] = -dy;
+        tri->b[i] = dx;
+        tri->c[i] = dy * a->x - dx * a->y;
+        tri->top_left[i] = (dy < 0.0f) || (dy == 0.0f && dx < 0.0f);
+
+        tri->inv_w[i] = p[i]->inv_w;
+        tri->u[i] = p[i]->u;
+        tri->v[i] = p[i]->v;
+        for (int c = 0; c < 4; c++) {
+            tri->col[c][i] = p[i]->c[c];
+        }
+    }
+
+    tri->inv_area = 1.0f / area;
+    tri->x0 = x0, tri->y0 = y0;
+    tri->x1 = x1, tri->y1 = y1;
+    tri->state = state;
+    tri->affine = p0->affine && p1->affine && p2->affine;
+}
+
+static void sl__raster_setup_line(const sl__raster_point_t* p0, const sl__raster_point_t* p1, int state)
+{
+    if (!p0->valid || !p1->valid) {
+        return;
+    }
+
+    // Lines are drawn as one pixel wide quads
+    float dx = p1->x - p0->x;
+    float dy = p1->y - p0->y;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len < 1e-6f) return;
+
+    float nx = -dy / len * 0.5f;
+    float ny = dx / len * 0.5f;
+
+    sl__raster_point_t q[4] = { *p0, *p0, *p1, *p1 };
+    q[0].x += nx, q[0].y += ny;
+    q[1].x -= nx, q[1].y -= ny;
+    q[2].x -= nx, q[2].y -= ny;
+    q[3].x += nx, q[3].y += ny;
+
+    sl__raster_setup_triangle(&q[0], &q[1], &q[2], state, false);
+    sl__raster_setup_triangle(&q[0], &q[2], &q[3], state, false);
+}
+
+static void sl__raster_clip_triangle(int i0, int i1, int i2, int state)
+{
+    // NOTE: Sutherland-Hodgman against the two planes, a triangle
+    //       grows to five vertices at most, then drawn as a fan.
+
+    sl__raster_vertex_t poly[2][8];
+    const sl__raster_vertex_t* vertices = sl__pipeline.vertices;
+
+    poly[0][0] = vertices[i0];
+    poly[0][1] = vertices[i1];
+    poly[0][2] = vertices[i2];
+
+    int count = 3, src = 0;
+
+    for (int plane = 0; plane < 2; plane++, src ^= 1)
+    {
+        const sl__raster_vertex_t* in = poly[src];
+        sl__raster_vertex_t* out = poly[src ^ 1];
+        int out_count = 0;
+
+        for (int i = 0; i < count; i++) {
+            const sl__raster_vertex_t* a = &in[i];
+            const sl__raster_vertex_t* b = &in[(i + 1) % count];
+            float da = sl__raster_plane_distance(a, plane);
+            float db = sl__raster_plane_distance(b, plane);
+            if (da >= 0.0f) {
+                out[out_count++] = *a;
+            }
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                out[out_count++] = sl__raster_lerp_vertex(a, b, da / (da - db));
+            }
+        }
+
+        if (out_count < 3) {
+            return;
+        }
+
+        count = out_count;
+    }
+
+    sl__raster_point_t points[8];
+    for (int i = 0; i < count; i++) {
+        points[i] = sl__raster_project(&poly[src][i]);
+    }
+
+    for (int i = 1; i + 1 < count; i++) {
+        sl__raster_setup_triangle(&points[0], &points[i], &points[i + 1], state, true);
+    }
+}
+
+static void sl__raster_clip_line(int i0, int i1, int state)
+{
+    sl__raster_vertex_t a = sl__pipeline.vertices[i0];
+    sl__raster_vertex_t b = sl__pipeline.vertices[i1];
+
+    for (int plane = 0; plane < 2; plane++) {
+        float da = sl__raster_plane_distance(&a, plane);
+        float db = sl__raster_plane_distance(&b, plane);
+        if (da < 0.0f && db < 0.0f) return;
+        if (da < 0.0f) a = sl__raster_lerp_vertex(&a, &b, da / (da - db));
+        else if (db < 0.0f) b = sl__raster_lerp_vertex(&a, &b, da / (da - db));
+    }
+
+    sl__raster_point_t p0 = sl__raster_project(&a);
+    sl__raster_point_t p1 = sl__raster_project(&b);
+
+    sl__raster_setup_line(&p0, &p1, state);
+}
+
+/* === Module Functions === */
+
+bool sl__raster_init(int w, int h)
+{
+    /* --- Default pipeline state --- */
+
+    sl__raster.viewport = (sl__raster_rect_t) { 0, 0, w, h };
+    sl__raster.scissor_enabled = false;
+    sl__raster.cull_mode = SL_CULL_NONE;
+
+    if (!sl__raster_resize_backbuffer(w, h)) {
+        return false;
+    }
+
+    /* --- Create the worker threads --- */
+
+    // NOTE: The calling thread also rasterizes tiles,
+    //       so one core is left to it.
+
+    sl__pipeline.mutex = SDL_CreateMutex();
+    sl__pipeline.cond_work = SDL_CreateCondition();
+    sl__pipeline.cond_done = SDL_CreateCondition();
+
+    if (!sl__pipeline.mutex || !sl__pipeline.cond_work || !sl__pipeline.cond_done) {
+        sl_logw("RENDER: Failed to create rasterizer synchronization objects; Rendering will be single-threaded");
+        return true;
+    }
+
+    int thread_count = SL_CLAMP(SDL_GetNumLogicalCPUCores() - 1, 0, SL__RASTER_MAX_THREADS);
+
+    for (int i = 0; i < thread_count; i++) {
+        sl__pipeline.threads[i] = SDL_CreateThread(sl__raster_worker, "sl_raster", NULL);
+        if (sl__pipeline.threads[i] == NULL) {
+            sl_logw("RENDER: Failed to create rasterizer thread; %s", SDL_GetError());
+            break;
+        }
+        sl__pipeline.thread_count++;
+    }
+
+    return true;
+}
+
+void sl__raster_quit(void)
+{
+    /* --- Stop the worker threads --- */
+
+    if (sl__pipeline.mutex) {
+        SDL_LockMutex(sl__pipeline.mutex);
+        sl__pipeline.quit = true;
+        SDL_BroadcastCondition(sl__pipeline.cond_work);
+        SDL_UnlockMutex(sl__pipeline.mutex);
+    }
+
+    for (int i = 0; i < sl__pipeline.thread_count; i++) {
+        SDL_WaitThread(sl__pipeline.threads[i], NULL);
+    }
+
+    if (sl__pipeline.cond_done) SDL_DestroyCondition(sl__pipeline.cond_done);
+    if (sl__pipeline.cond_work) SDL_DestroyCondition(sl__pipeline.cond_work);
+    if (sl__pipeline.mutex) SDL_DestroyMutex(sl__pipeline.mutex);
+
+    /* --- Release buffers --- */
+
+    SDL_free(sl__pipeline.vertices);
+    SDL_free(sl__pipeline.points);
+    SDL_free(sl__pipeline.triangles);
+    SDL_free(sl__pipeline.states);
+    SDL_free(sl__pipeline.tile_counts);
+    SDL_free(sl__pipeline.tile_offsets);
+    SDL_free(sl__pipeline.tile_cursors);
+    SDL_free(sl__pipeline.jobs);
+    SDL_free(sl__pipeline.items);
+
+    sl__raster_texture_free(&sl__raster.backbuffer);
+
+    SDL_memset(&sl__pipeline, 0, sizeof(sl__pipeline));
+}
+
+/* === Target Functions === */
+
+bool sl__raster_resize_backbuffer(int w, int h)
+{
+    if (w <= 0 || h <= 0) {
+        return false;
+    }
+
+    uint32_t* pixels = SDL_calloc((size_t)w * h, sizeof(uint32_t));
+    if (pixels == NULL) {
+        sl_loge("RENDER: Failed to allocate the software backbuffer (%dx%d)", w, h);
+        return false;
+    }
+
+    SDL_free(sl__raster.backbuffer.pixels);
+
+    sl__raster.backbuffer.pixels = pixels;
+    sl__raster.backbuffer.w = w;
+    sl__raster.backbuffer.h = h;
+    sl__raster.backbuffer.filter = SL_FILTER_NEAREST;
+    sl__raster.backbuffer.wrap = SL_WRAP_CLAMP;
+
+    return true;
+}
+
+void sl__raster_present(SDL_Window* window)
+{
+    SDL_Surface* surface = SDL_GetWindowSurface(window);
+    if (surface == NULL) {
+        return;
+    }
+
+    if (SDL_MUSTLOCK(surface) && !SDL_LockSurface(surface)) {
+        return;
+    }
+
+    const sl__texture_t* bb = &sl__raster.backbuffer;
+    int w = SL_MIN(surface->w, bb->w);
+    int h = SL_MIN(surface->h, bb->h);
+
+    // The backbuffer is stored bottom-up like a GL framebuffer
+    for (int y = 0; y < h; y++) {
+        const uint32_t* src = bb->pixels + (size_t)(bb->h - 1 - y) * bb->w;
+        uint8_t* dst = (uint8_t*)surface->pixels + (size_t)y * surface->pitch;
+        SDL_ConvertPixels(w, 1, SDL_PIXELFORMAT_ABGR8888, src, bb->w * 4, surface->format, dst, surface->pitch);
+    }
+
+    if (SDL_MUSTLOCK(surface)) {
+        SDL_UnlockSurface(surface);
+    }
+
+    SDL_UpdateWindowSurface(window);
+}
+
+/* === Texture Functions === */
+
+static void sl__raster_convert_row(uint32_t* dst, const uint8_t* src, int count, sl_pixel_format_t format)
+{
+    // Converted the same way GL expands the GLES2 formats when sampling
+    for (int i = 0; i < count; i++) {
+        uint8_t r = 0, g = 0, b = 0, a = 255;
+        switch (format) {
+        case SL_PIXEL_FORMAT_LUMINANCE8:
+            r = g = b = src[i];
+            break;
+        case SL_PIXEL_FORMAT_ALPHA8:
+            a = src[i];
+            break;
+        case SL_PIXEL_FORMAT_LUMINANCE_ALPHA8:
+            r = g = b = src[2 * i + 0];
+            a = src[2 * i + 1];
+            break;
+        case SL_PIXEL_FORMAT_RGB8:
+            r = src[3 * i + 0];
+            g = src[3 * i + 1];
+            b = src[3 * i + 2];
+            break;
+        case SL_PIXEL_FORMAT_RGBA8:
+        default:
+            r = src[4 * i + 0];
+            g = src[4 * i + 1];
+            b = src[4 * i + 2];
+            a = src[4 * i + 3];
+            break;
+        }
+        dst[i] = sl__raster_pack_color((sl_color_t) { r, g, b, a });
+    }
+}
+
+bool sl__raster_texture_alloc(sl__texture_t* texture, const void* pixels, int w, int h, sl_pixel_format_t format)
+{
+    uint32_t* texels = SDL_malloc((size_t)w * h * sizeof(uint32_t));
+    if (texels == NULL) {
+        return false;
+    }
+
+    if (pixels == NULL) {
+        SDL_memset(texels, 0, (size_t)w * h * sizeof(uint32_t));
+    }
+    else {
+        sl__raster_convert_row(texels, pixels, w * h, format);
+    }
+
+    texture->pixels = texels;
+    texture->w = w;
+    texture->h = h;
+    texture->filter = SL_FILTER_NEAREST;
+    texture->wrap = SL_WRAP_CLAMP;
+
+    return true;
+}
+
+void sl__raster_texture_update(sl__texture_t* texture, int x, int y, int w, int h, const void* pixels, sl_pixel_format_t format)
+{
+    static const int sizes[] = { 1, 1, 2, 3, 4 };
+
+    const uint8_t* src = pixels;
+    int pitch = w * sizes[format];
+
+    for (int row = 0; row < h; row++) {
+        uint32_t* dst = texture->pixels + (size_t)(y + row) * texture->w + x;
+        sl__raster_convert_row(dst, src + (size_t)row * pitch, w, format);
+    }
+}
+
+void sl__raster_texture_free(sl__texture_t* texture)
+{
+    SDL_free(texture->pixels);
+    texture->pixels = NULL;
+}
+
+/* === Draw Functions === */
+
+void sl__raster_clear(sl__texture_t* target, sl_color_t color)
+{
+    // Like glClear(), only the scissor box restricts the cleared area
+    sl__raster_rect_t rect = { 0, 0, target->w, target->h };
+
+    if (sl__raster.scissor_enabled) {
+        int x0 = SL_MAX(rect.x, sl__raster.scissor.x);
+        int y0 = SL_MAX(rect.y, sl__raster.scissor.y);
+        int x1 = SL_MIN(rect.x + rect.w, sl__raster.scissor.x + sl__raster.scissor.w);
+        int y1 = SL_MIN(rect.y + rect.h, sl__raster.scissor.y + sl__raster.scissor.h);
+        rect = (sl__raster_rect_t) { x0, y0, x1 - x0, y1 - y0 };
+    }
+
+    if (rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
+
+    uint32_t value = sl__raster_pack_color(color);
+
+    for (int y = rect.y; y < rect.y + rect.h; y++) {
+        uint32_t* row = target->pixels + (size_t)y * target->w + rect.x;
+        for (int x = 0; x < rect.w; x++) {
+            row[x] = value;
+        }
+    }
+}
+
+void sl__raster_begin(sl__texture_t* target)
+{
+    sl__pipeline.target = target;
+    sl__pipeline.triangle_count = 0;
+    sl__pipeline.state_count = 0;
+
+    /* --- Clip rect: target, viewport and scissor --- */
+
+    const sl__raster_rect_t* vp = &sl__raster.viewport;
+
+    int x0 = SL_MAX(0, vp->x);
+    int y0 = SL_MAX(0, vp->y);
+    int x1 = SL_MIN(target->w, vp->x + vp->w);
+    int y1 = SL_MIN(target->h, vp->y + vp->h);
+
+    if (sl__raster.scissor_enabled) {
+        x0 = SL_MAX(x0, sl__raster.scissor.x);
+        y0 = SL_MAX(y0, sl__raster.scissor.y);
+        x1 = SL_MIN(x1, sl__raster.scissor.x + sl__raster.scissor.w);
+        y1 = SL_MIN(y1, sl__raster.scissor.y + sl__raster.scissor.h);
+    }
+
+    sl__pipeline.clip = (sl__raster_rect_t) { x0, y0, SL_MAX(x1 - x0, 0), SL_MAX(y1 - y0, 0) };
+}
+
+void sl__raster_vertices_2d(const sl_vertex_2d_t* vertices, int count, const sl_mat4_t* mvp)
+{
+    sl__pipeline.point_count = 0;
+
+    if (count <= 0 || !sl__raster_reserve_points(count)) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const sl_vertex_2d_t* src = &vertices[i];
+        sl_vec4_t clip = sl_vec4_transform(SL_VEC4(src->position.x, src->position.y, 0.0f, 1.0f), mvp);
+        sl__raster_vertex_t* v = &sl__pipeline.vertices[i];
+        *v = (sl__raster_vertex_t) {
+            clip.x, clip.y, clip.z, clip.w,
+            src->texcoord.x, src->texcoord.y,
+            src->color.r / 255.0f, src->color.g / 255.0f,
+            src->color.b / 255.0f, src->color.a / 255.0f
+        };
+        sl__pipeline.points[i] = sl__raster_is_clipped(v)
+            ? (sl__raster_point_t) { 0 } : sl__raster_project(v);
+    }
+
+    sl__pipeline.point_count = count;
+}
+
+void sl__raster_vertices_3d(const sl_vertex_3d_t* vertices, int count, const sl_mat4_t* mvp)
+{
+    sl__pipeline.point_count = 0;
+
+    if (count <= 0 || !sl__raster_reserve_points(count)) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const sl_vertex_3d_t* src = &vertices[i];
+        sl_vec4_t clip = sl_vec4_transform(SL_VEC4(src->position.x, src->position.y, src->position.z, 1.0f), mvp);
+        sl__raster_vertex_t* v = &sl__pipeline.vertices[i];
+        *v = (sl__raster_vertex_t) {
+            clip.x, clip.y, clip.z, clip.w,
+            src->texcoord.x, src->texcoord.y,
+            src->color.r / 255.0f, src->color.g / 255.0f,
+            src->color.b / 255.0f, src->color.a / 255.0f
+        };
+        sl__pipeline.points[i] = sl__raster_is_clipped(v)
+            ? (sl__raster_point_t) { 0 } : sl__raster_project(v);
+    }
+
+    sl__pipeline.point_count = count;
+}
+
+void sl__raster_draw(const uint16_t* indices, int count, const sl__texture_t* texture, sl_blend_mode_t blend_mode, bool lines)
+{
+    if (texture == NULL || texture->pixels == NULL) {
+        return;
+    }
+
+    int state = sl__raster_push_state(texture, blend_mode);
+    if (state < 0) return;
+
+    const sl__raster_point_t* points = sl__pipeline.points;
+    int point_count = sl__pipeline.point_count;
+    int stride = lines ? 2 : 3;
+
+    for (int i = 0; i + stride <= count; i += stride)
+    {
+        int i0 = indices ? indices[i + 0] : i + 0;
+        int i1 = indices ? indices[i + 1] : i + 1;
+        int i2 = lines ? i1 : (indices ? indices[i + 2] : i + 2);
+
+        if (i0 >= point_count || i1 >= point_count || i2 >= point_count) {
+            continue;
+        }
+
+        // Primitives crossing the near plane take the slower clipped path
+        bool clipped = !points[i0].valid || !points[i1].valid || !points[i2].valid;
+
+        if (lines) {
+            if (clipped) sl__raster_clip_line(i0, i1, state);
+            else sl__raster_setup_line(&points[i0], &points[i1], state);
+        }
+        else {
+            if (clipped) sl__raster_clip_triangle(i0, i1, i2, state);
+            else sl__raster_setup_triangle(&points[i0], &points[i1], &points[i2], state, true);
+        }
+    }
+}
+
+void sl__raster_end(void)
+{
+    if (sl__pipeline.triangle_count == 0 || sl__pipeline.target == NULL) {
+        return;
+    }
+
+    const int ts = SL__RASTER_TILE_SIZE;
+    const sl__texture_t* target = sl__pipeline.target;
+
+    int tiles_x = (target->w + ts - 1) / ts;
+    int tiles_y = (target->h + ts - 1) / ts;
+    int tile_count = tiles_x * tiles_y;
+
+    /* --- Reserve binning buffers --- */
+
+    if (!sl__raster_reserve_tiles(tile_count)) {
+        sl__pipeline.triangle_count = 0;
+        return;
+    }
+
+    sl__pipeline.tiles_x = tiles_x;
+
+    /* --- Count triangles per tile --- */
+
+    SDL_memset(sl__pipeline.tile_counts, 0, tile_count * sizeof(int));
+
+    int item_count = 0;
+
+    for (int i = 0; i < sl__pipeline.triangle_count; i++) {
+        const sl__raster_triangle_t* tri = &sl__pipeline.triangles[i];
+        for (int ty = tri->y0 / ts; ty <= tri->y1 / ts; ty++) {
+            for (int tx = tri->x0 / ts; tx <= tri->x1 / ts; tx++) {
+                sl__pipeline.tile_counts[ty * tiles_x + tx]++;
+                item_count++;
+            }
+        }
+    }
+
+    if (!sl__raster_reserve((void**)&sl__pipeline.items, &sl__pipeline.item_capacity, item_count, sizeof(int))) {
+        sl__pipeline.triangle_count = 0;
+        return;
+    }
+
+    /* --- Bin triangles, keeping submission order within each tile --- */
+
+    sl__pipeline.job_count = 0;
+
+    for (int t = 0, offset = 0; t < tile_count; t++) {
+        sl__pipeline.tile_offsets[t] = sl__pipeline.tile_cursors[t] = offset;
+        offset += sl__pipeline.tile_counts[t];
+        if (sl__pipeline.tile_counts[t] > 0) {
+            sl__pipeline.jobs[sl__pipeline.job_count++] = t;
+        }
+    }
+
+    for (int i = 0; i < sl__pipeline.triangle_count; i++) {
+        const sl__raster_triangle_t* tri = &sl__pipeline.triangles[i];
+        for (int ty = tri->y0 / ts; ty <= tri->y1 / ts; ty++) {
+            for (int tx = tri->x0 / ts; tx <= tri->x1 / ts; tx++) {
+                sl__pipeline.items[sl__pipeline.tile_cursors[ty * tiles_x + tx]++] = i;
+            }
+        }
+    }
+
+    /* --- Rasterize all tiles --- */
+
+    sl__raster_dispatch(item_count);
+
+    sl__pipeline.triangle_count = 0;
+    sl__pipeline.state_count = 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2025 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef SL__RASTER_H
+#define SL__RASTER_H
+
+#include <smol.h>
+
+#include "./sl__render.h"
+
+#include <SDL3/SDL_video.h>
+
+/* === Constants === */
+
+#define SL__RASTER_TILE_SIZE 64
+#define SL__RASTER_MAX_THREADS 16
+
+/* === Internal Structs === */
+
+typedef struct {
+    int x, y, w, h;
+} sl__raster_rect_t;
+
+/* === Global State === */
+
+extern struct sl__raster {
+
+    sl__texture_t backbuffer;       ///< Window color buffer, bottom-left origin like GL
+
+    sl__raster_rect_t viewport;
+    sl__raster_rect_t scissor;
+    bool scissor_enabled;
+    sl_cull_mode_t cull_mode;
+
+} sl__raster;
+
+/* === Module Functions === */
+
+bool sl__raster_init(int w, int h);
+void sl__raster_quit(void);
+
+/* === Target Functions === */
+
+bool sl__raster_resize_backbuffer(int w, int h);
+void sl__raster_present(SDL_Window* window);
+
+/* === Texture Functions === */
+
+bool sl__raster_texture_alloc(sl__texture_t* texture, const void* pixels, int w, int h, sl_pixel_format_t format);
+void sl__raster_texture_update(sl__texture_t* texture, int x, int y, int w, int h, const void* pixels, sl_pixel_format_t format);
+void sl__raster_texture_free(sl__texture_t* texture);
+
+/* === Draw Functions === */
+
+void sl__raster_clear(sl__texture_t* target, sl_color_t color);
+
+// NOTE: Draws are only recorded between begin and end, the
+//       primitives are binned and rasterized in order by end.
+//       Indices refer to the last vertices sent.
+
+void sl__raster_begin(sl__texture_t* target);
+void sl__raster_vertices_2d(const sl_vertex_2d_t* vertices, int count, const sl_mat4_t* mvp);
+void sl__raster_vertices_3d(const sl_vertex_3d_t* vertices, int count, const sl_mat4_t* mvp);
+void sl__raster_draw(const uint16_t* indices, int count, const sl__texture_t* texture, sl_blend_mode_t blend_mode, bool lines);
+void sl__raster_end(void);
+
+#endif // SL__RASTER_H
@@ -19,14 +19,61 @@
 
 #include "./sl__render.h"
 
+#ifdef SL_BACKEND_SOFTWARE
+    #include "./sl__raster.h"
+#endif
+
+#include <SDL3/SDL_video.h>
+#include <stddef.h>
+
 /* === Global State === */
 
 struct sl__render sl__render = { 0 };
 
+#ifdef SL_BACKEND_GL33
+struct sl__gl33 sl__gl33 = { 0 };
+#endif
+
+/* === Internal Functions === */
+
+#ifdef SL_BACKEND_GL33
+static bool sl__render_load_gl33(void)
+{
+#   define LOAD(type, name) \
+        sl__gl33.name = (type)SDL_GL_GetProcAddress("gl" #name); \
+        if (sl__gl33.name == NULL) { \
+            sl_loge("RENDER: Failed to load GL 3.3 function 'gl%s'", #name); \
+            return false; \
+        }
+
+    LOAD(sl__PFNGLGENVERTEXARRAYSPROC, GenVertexArrays);
+    LOAD(sl__PFNGLBINDVERTEXARRAYPROC, BindVertexArray);
+    LOAD(sl__PFNGLDELETEVERTEXARRAYSPROC, DeleteVertexArrays);
+    LOAD(sl__PFNGLMAPBUFFERRANGEPROC, MapBufferRange);
+    LOAD(sl__PFNGLUNMAPBUFFERPROC, UnmapBuffer);
+    LOAD(sl__PFNGLBINDBUFFERBASEPROC, BindBufferBase);
+    LOAD(sl__PFNGLGETUNIFORMBLOCKINDEXPROC, GetUniformBlockIndex);
+    LOAD(sl__PFNGLUNIFORMBLOCKBINDINGPROC, UniformBlockBinding);
+    LOAD(sl__PFNGLDEPTHRANGEPROC, DepthRange);
+
+#   undef LOAD
+
+    return true;
+}
+#endif // SL_BACKEND_GL33
+
 /* === Module Functions === */
 
 bool sl__render_init(int w, int h)
 {
+    /* --- Load GL 3.3 entry points --- */
+
+#ifdef SL_BACKEND_GL33
+    if (!sl__render_load_gl33()) {
+        return false;
+    }
+#endif
+
     /* --- Create registries --- */
 
     sl__render.reg_textures = sl__registry_create(32, sizeof(sl__texture_t));
@@ -34,11 +81,19 @@ bool sl__render_init(int w, int h)
     sl__render.reg_shaders = sl__registry_create(8, sizeof(sl__shader_t));
     sl__render.reg_meshes = sl__registry_create(8, sizeof(sl__mesh_t));
     sl__render.reg_fonts = sl__registry_create(4, sizeof(sl__font_t));
+    sl__render.reg_layouts = sl__registry_create(8, sizeof(sl__text_layout_t));
 
     /* --- Init default values --- */
 
     sl__render.current_texture = sl__render.default_texture = sl_texture_create((uint8_t[]){255}, 1, 1, SL_PIXEL_FORMAT_LUMINANCE8);
     sl__render.current_shader = sl__render.default_shader = sl_shader_create(NULL);
+    sl__render.sdf_shader = sl__shader_create_sdf();
+
+    sl__render.loc_sdf_outline_width = sl_shader_uniform(sl__render.sdf_shader, "u_outline_width");
+    sl__render.loc_sdf_outline_color = sl_shader_uniform(sl__render.sdf_shader, "u_outline_color");
+    sl__render.loc_sdf_shadow_offset = sl_shader_uniform(sl__render.sdf_shader, "u_shadow_offset");
+    sl__render.loc_sdf_shadow_color = sl_shader_uniform(sl__render.sdf_shader, "u_shadow_color");
+
     sl__render.current_blend_mode = SL_BLEND_OPAQUE;
     sl__render.current_color = SL_WHITE;
 
@@ -50,8 +105,36 @@ bool sl__render_init(int w, int h)
     sl__render.transform_is_identity = true;
     sl__render.texture_is_identity = true;
 
+    sl__render.transform_palette[0][0] = 1.0f;
+    sl__render.transform_palette[0][5] = 1.0f;
+    sl__render.transform_palette_count = 1;
+    sl__render.transform_palette_slot = -1;
+
+    sl__render.depth_write = true;
+    sl__render.depth_far = 1.0f;
+
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Create the software pipeline --- */
+
+    // NOTE: No GPU buffers are needed, draw calls
+    //       are rasterized straight from the CPU batch.
+
+    if (!sl__raster_init(w, h)) {
+        return false;
+    }
+
+#else
+
     /* --- Create batch buffers --- */
 
+#ifdef SL_BACKEND_GL33
+    // NOTE: The element buffer binding is part of the VAO state,
+    //       so the VAO must be bound before the batch buffers.
+    glGenVertexArrays(1, &sl__render.vao);
+    glBindVertexArray(sl__render.vao);
+#endif
+
     glGenBuffers(1, &sl__render.vbo);
     glGenBuffers(1, &sl__render.ebo);
 
@@ -61,6 +144,46 @@ bool sl__render_init(int w, int h)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sl__render.ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(sl__render.index_buffer), NULL, GL_DYNAMIC_DRAW);
 
+    // NOTE: Palette indices live in their own buffer so that
+    //       the public vertex layout does not have to change.
+    glGenBuffers(1, &sl__render.vbo_transform);
+    glBindBuffer(GL_ARRAY_BUFFER, sl__render.vbo_transform);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(sl__render.transform_index_buffer), NULL, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, sl__render.vbo);
+
+#ifdef SL_BACKEND_GL33
+
+    /* --- Setup the batch vertex layout once --- */
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(sl_vertex_2d_t), (void*)offsetof(sl_vertex_2d_t, position));
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(sl_vertex_2d_t), (void*)offsetof(sl_vertex_2d_t, texcoord));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sl_vertex_2d_t), (void*)offsetof(sl_vertex_2d_t, color));
+    glEnableVertexAttribArray(3);
+
+    // NOTE: Only enabled by the flush when the palette is in use
+    glBindBuffer(GL_ARRAY_BUFFER, sl__render.vbo_transform);
+    glVertexAttribPointer(4, 1, GL_UNSIGNED_BYTE, GL_FALSE, 0, NULL);
+
+    /* --- Create the matrices uniform buffer --- */
+
+    // NOTE: The mvp is followed by the transform palette, its
+    //       identity entry is uploaded once and never changes.
+
+    glGenBuffers(1, &sl__render.ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, sl__render.ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(sl_mat4_t) + sizeof(sl__render.transform_palette), NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(sl_mat4_t), sizeof(sl__render.transform_palette[0]), sl__render.transform_palette[0]);
+    glBindBufferBase(GL_UNIFORM_BUFFER, SL__UBO_BINDING_MATRICES, sl__render.ubo);
+
+#endif // SL_BACKEND_GL33
+
+#endif // SL_BACKEND_SOFTWARE
+
     /* --- Yayyy! --- */
 
     return true;
@@ -76,6 +199,12 @@ void sl__render_quit(void)
         }
     }
 
+    for (int i = 0; i < sl__render.reg_layouts.elements.count; i++) {
+        if (((bool*)sl__render.reg_layouts.valid_flags.data)[i]) {
+            sl_text_layout_destroy(i + 1);
+        }
+    }
+
     for (int i = 0; i < sl__render.reg_fonts.elements.count; i++) {
         if (((bool*)sl__render.reg_fonts.valid_flags.data)[i]) {
             sl_font_destroy(i + 1);
@@ -102,11 +231,20 @@ void sl__render_quit(void)
 
     /* --- Release registries --- */
 
+    sl__registry_destroy(&sl__render.reg_layouts);
     sl__registry_destroy(&sl__render.reg_fonts);
     sl__registry_destroy(&sl__render.reg_shaders);
     sl__registry_destroy(&sl__render.reg_canvases);
     sl__registry_destroy(&sl__render.reg_textures);
 
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Release the software pipeline --- */
+
+    sl__raster_quit();
+
+#else
+
     /* --- Release batch buffer objects --- */
 
     if (sl__render.ebo) {
@@ -118,34 +256,378 @@ void sl__render_quit(void)
         glDeleteBuffers(1, &sl__render.vbo);
         sl__render.vbo = 0;
     }
+
+    if (sl__render.vbo_transform) {
+        glDeleteBuffers(1, &sl__render.vbo_transform);
+        sl__render.vbo_transform = 0;
+    }
+
+#ifdef SL_BACKEND_GL33
+    if (sl__render.ubo) {
+        glDeleteBuffers(1, &sl__render.ubo);
+        sl__render.ubo = 0;
+    }
+
+    if (sl__render.vao) {
+        glDeleteVertexArrays(1, &sl__render.vao);
+        sl__render.vao = 0;
+    }
+#endif
+
+#endif // SL_BACKEND_SOFTWARE
+}
+
+/* === Backend Functions === */
+
+#ifndef SL_BACKEND_SOFTWARE
+
+static void sl__render_gl_format(sl_pixel_format_t format, GLenum* gl_internal_format, GLenum* gl_format, const GLint** swizzle)
+{
+#ifdef SL_BACKEND_GL33
+
+    // NOTE: Luminance and alpha formats do not exist in core profile,
+    //       they are stored as red/rg textures and swizzled back on sampling.
+
+    static const GLint swizzle_luminance[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+    static const GLint swizzle_alpha[4] = { GL_ZERO, GL_ZERO, GL_ZERO, GL_RED };
+    static const GLint swizzle_luminance_alpha[4] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+
+    *gl_internal_format = GL_RGBA8;
+    *gl_format = GL_RGBA;
+    *swizzle = NULL;
+
+    switch (format) {
+    case SL_PIXEL_FORMAT_LUMINANCE8:
+        *gl_internal_format = GL_R8;
+        *gl_format = GL_RED;
+        *swizzle = swizzle_luminance;
+        break;
+    case SL_PIXEL_FORMAT_ALPHA8:
+        *gl_internal_format = GL_R8;
+        *gl_format = GL_RED;
+        *swizzle = swizzle_alpha;
+        break;
+    case SL_PIXEL_FORMAT_LUMINANCE_ALPHA8:
+        *gl_internal_format = GL_RG8;
+        *gl_format = GL_RG;
+        *swizzle = swizzle_luminance_alpha;
+        break;
+    case SL_PIXEL_FORMAT_RGB8:
+        *gl_internal_format = GL_RGB8;
+        *gl_format = GL_RGB;
+        break;
+    case SL_PIXEL_FORMAT_RGBA8:
+        *gl_internal_format = GL_RGBA8;
+        *gl_format = GL_RGBA;
+        break;
+    default:
+        break;
+    }
+
+#else
+
+    *gl_format = GL_RGBA;
+    *swizzle = NULL;
+
+    switch (format) {
+    case SL_PIXEL_FORMAT_LUMINANCE8:
+        *gl_format = GL_LUMINANCE;
+        break;
+    case SL_PIXEL_FORMAT_ALPHA8:
+        *gl_format = GL_ALPHA;
+        break;
+    case SL_PIXEL_FORMAT_LUMINANCE_ALPHA8:
+        *gl_format = GL_LUMINANCE_ALPHA;
+        break;
+    case SL_PIXEL_FORMAT_RGB8:
+        *gl_format = GL_RGB;
+        break;
+    case SL_PIXEL_FORMAT_RGBA8:
+        *gl_format = GL_RGBA;
+        break;
+    default:
+        break;
+    }
+
+    *gl_internal_format = *gl_format;
+
+#endif
+}
+
+void sl__render_tex_image_2d(sl_pixel_format_t format, int w, int h, const void* pixels)
+{
+    GLenum gl_internal_format, gl_format;
+    const GLint* swizzle;
+
+    sl__render_gl_format(format, &gl_internal_format, &gl_format, &swizzle);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, gl_internal_format, w, h, 0, gl_format, GL_UNSIGNED_BYTE, pixels);
+
+#ifdef SL_BACKEND_GL33
+    if (swizzle != NULL) {
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+#endif
 }
 
+void sl__render_tex_sub_image_2d(sl_pixel_format_t format, int x, int y, int w, int h, const void* pixels)
+{
+    GLenum gl_internal_format, gl_format;
+    const GLint* swizzle;
+
+    sl__render_gl_format(format, &gl_internal_format, &gl_format, &swizzle);
+
+    // Rows of a sub-region are tightly packed whatever their width
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, gl_format, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+#endif // SL_BACKEND_SOFTWARE
+
 /* === Font Functions === */
 
-const sl__glyph_t* sl__glyph_info(const sl__font_t* font, int codepoint)
+static inline uint32_t sl__font_hash_codepoint(int codepoint)
+{
+    return (uint32_t)codepoint * 2654435761u;
+}
+
+static bool sl__font_map_resize(sl__font_t* font, int capacity)
+{
+    sl__glyph_slot_t* old_map = font->glyph_map;
+    int old_capacity = font->glyph_map_capacity;
+
+    sl__glyph_slot_t* map = SDL_malloc(capacity * sizeof(sl__glyph_slot_t));
+    if (map == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        map[i].codepoint = -1;
+    }
+
+    font->glyph_map = map;
+    font->glyph_map_capacity = capacity;
+    font->glyph_map_count = 0;
+
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_map[i].codepoint != -1) {
+            sl__font_lookup_insert(font, old_map[i].codepoint, old_map[i].index);
+        }
+    }
+
+    SDL_free(old_map);
+
+    return true;
+}
+
+bool sl__font_build_lookup(sl__font_t* font)
 {
 #   define FALLBACK 63 //< Fallback is '?'
 
-    int index = 0, fallback_index = 0;
+    /* --- Reset the lookup --- */
+
+    for (int i = 0; i < SL__FONT_DIRECT_LOOKUP_SIZE; i++) {
+        font->direct_lookup[i] = -1;
+    }
+
+    font->glyph_map = NULL;
+    font->glyph_map_capacity = 0;
+    font->glyph_map_count = 0;
+    font->fallback_index = 0;
+
+    /* --- Count the codepoints out of the direct range --- */
+
+    int mapped_count = 0;
+    for (int i = 0; i < font->glyph_count; i++) {
+        if ((unsigned)font->glyphs[i].value >= SL__FONT_DIRECT_LOOKUP_SIZE) {
+            mapped_count++;
+        }
+    }
+
+    /* --- Allocate the map, kept at most half full --- */
+
+    if (mapped_count > 0) {
+        int capacity = 16;
+        while (capacity < 2 * mapped_count) {
+            capacity *= 2;
+        }
+        if (!sl__font_map_resize(font, capacity)) {
+            return false;
+        }
+    }
+
+    /* --- Insert the glyphs --- */
+
+    bool has_fallback = false;
 
     for (int i = 0; i < font->glyph_count; i++) {
-        if (font->glyphs[i].value == codepoint) {
-            index = i;
-            break;
+        if (font->glyphs[i].value == FALLBACK && !has_fallback) {
+            font->fallback_index = i;
+            has_fallback = true;
+        }
+        if (!sl__font_lookup_insert(font, font->glyphs[i].value, i)) {
+            return false;
+        }
+    }
+
+    return true;
+
+#   undef FALLBACK
+}
+
+bool sl__font_lookup_insert(sl__font_t* font, int codepoint, int index)
+{
+    // NOTE: The first glyph of a codepoint wins, like the linear scan did
+
+    if ((unsigned)codepoint < SL__FONT_DIRECT_LOOKUP_SIZE) {
+        if (font->direct_lookup[codepoint] < 0) {
+            font->direct_lookup[codepoint] = index;
         }
-        else if (font->glyphs[i].value == FALLBACK) {
-            fallback_index = i;
+        return true;
+    }
+
+    if (2 * (font->glyph_map_count + 1) > font->glyph_map_capacity) {
+        if (!sl__font_map_resize(font, SL_MAX(16, 2 * font->glyph_map_capacity))) {
+            return false;
+        }
+    }
+
+    uint32_t mask = (uint32_t)font->glyph_map_capacity - 1;
+    uint32_t slot = sl__font_hash_codepoint(codepoint) & mask;
+
+    while (font->glyph_map[slot].codepoint != -1 && font->glyph_map[slot].codepoint != codepoint) {
+        slot = (slot + 1) & mask;
+    }
+
+    if (font->glyph_map[slot].codepoint == -1) {
+        font->glyph_map[slot].codepoint = codepoint;
+        font->glyph_map[slot].index = index;
+        font->glyph_map_count++;
+    }
+
+    return true;
+}
+
+int sl__font_glyph_index(sl__font_t* font, int codepoint)
+{
+    if ((unsigned)codepoint < SL__FONT_DIRECT_LOOKUP_SIZE) {
+        int index = font->direct_lookup[codepoint];
+        if (index >= 0) return index;
+    }
+    else if (font->glyph_map_capacity > 0) {
+        uint32_t mask = (uint32_t)font->glyph_map_capacity - 1;
+        uint32_t slot = sl__font_hash_codepoint(codepoint) & mask;
+
+        while (font->glyph_map[slot].codepoint != -1) {
+            if (font->glyph_map[slot].codepoint == codepoint) {
+                return font->glyph_map[slot].index;
+            }
+            slot = (slot + 1) & mask;
         }
     }
 
-    if (index == 0 && font->glyphs[0].value != codepoint) {
-        index = fallback_index;
+    // Dynamic fonts learn the codepoints they have not seen yet
+    if (font->cache != NULL) {
+        return sl__font_cache_add_glyph(font, codepoint);
     }
 
-    return &font->glyphs[index];
+    return font->fallback_index;
+}
+
+const sl__glyph_t* sl__glyph_info(sl__font_t* font, int codepoint)
+{
+    return &font->glyphs[sl__font_glyph_index(font, codepoint)];
+}
+
+static inline uint32_t sl__font_kern_key(int left, int right)
+{
+    return ((uint32_t)left << 16) | (uint32_t)right;
 }
 
-void sl__font_measure_text(float* w, float* h, const sl__font_t* font, const char* text, float font_size, float x_spacing, float y_spacing)
+static bool sl__font_kerning_resize(sl__font_t* font, int capacity)
+{
+    sl__kern_pair_t* old_pairs = font->kern_pairs;
+    int old_capacity = font->kern_capacity;
+
+    sl__kern_pair_t* pairs = SDL_malloc(capacity * sizeof(sl__kern_pair_t));
+    if (pairs == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        pairs[i].pair = UINT32_MAX;
+    }
+
+    font->kern_pairs = pairs;
+    font->kern_capacity = capacity;
+    font->kern_count = 0;
+
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_pairs[i].pair != UINT32_MAX) {
+            sl__font_kerning_insert(font, old_pairs[i].pair >> 16, old_pairs[i].pair & 0xFFFF, old_pairs[i].advance);
+        }
+    }
+
+    SDL_free(old_pairs);
+
+    return true;
+}
+
+bool sl__font_kerning_insert(sl__font_t* font, int left, int right, float advance)
+{
+    // NOTE: Keys pack two 16-bit glyph indices, which covers
+    //       every glyph a TrueType font can hold.
+
+    if ((unsigned)left > 0xFFFF || (unsigned)right > 0xFFFF || advance == 0.0f) {
+        return true;
+    }
+
+    if (2 * (font->kern_count + 1) > font->kern_capacity) {
+        if (!sl__font_kerning_resize(font, SL_MAX(64, 2 * font->kern_capacity))) {
+            return false;
+        }
+    }
+
+    uint32_t key = sl__font_kern_key(left, right);
+    uint32_t mask = (uint32_t)font->kern_capacity - 1;
+    uint32_t slot = sl__font_hash_codepoint((int)key) & mask;
+
+    while (font->kern_pairs[slot].pair != UINT32_MAX && font->kern_pairs[slot].pair != key) {
+        slot = (slot + 1) & mask;
+    }
+
+    if (font->kern_pairs[slot].pair == UINT32_MAX) {
+        font->kern_count++;
+    }
+
+    font->kern_pairs[slot].pair = key;
+    font->kern_pairs[slot].advance = advance;
+
+    return true;
+}
+
+float sl__font_kerning(const sl__font_t* font, int left, int right)
+{
+    if (font->kern_count == 0 || left < 0) {
+        return 0.0f;
+    }
+
+    uint32_t key = sl__font_kern_key(left, right);
+    uint32_t mask = (uint32_t)font->kern_capacity - 1;
+    uint32_t slot = sl__font_hash_codepoint((int)key) & mask;
+
+    while (font->kern_pairs[slot].pair != UINT32_MAX) {
+        if (font->kern_pairs[slot].pair == key) {
+            return font->kern_pairs[slot].advance;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return 0.0f;
+}
+
+void sl__font_measure_text(float* w, float* h, sl__font_t* font, const char* text, float font_size, float x_spacing, float y_spacing)
 {
     if ((!w && !h) || font == NULL || text == NULL) {
         return;
@@ -159,26 +641,37 @@ void sl__font_measure_text(float* w, float* h, const sl__font_t* font, const cha
 
     int max_chars_in_line = 0;
     int current_chars_in_line = 0;
+    int previous_index = -1;
     int text_length = (int)strlen(text);
 
+    int codepoints[SL__TEXT_DECODE_CHUNK];
+
     for (int i = 0; i < text_length;)
     {
-        int codepoint_byte_count = 0;
-        int letter = sl_codepoint_next(&text[i], &codepoint_byte_count);
-        i += codepoint_byte_count;
-
-        if (letter == '\n') {
-            max_width = fmaxf(max_width, current_width);
-            max_chars_in_line = SL_MAX(max_chars_in_line, current_chars_in_line);
-            current_width = 0.0f;
-            current_chars_in_line = 0;
-            text_height += font_size + y_spacing;
-        }
-        else if (w != NULL) {
-            const sl__glyph_t* glyph = sl__glyph_info(font, letter);
-            float char_width = (glyph->x_advance > 0) ? glyph->x_advance : (glyph->w_atlas + glyph->x_offset);
-            current_width += char_width;
-            current_chars_in_line++;
+        int decoded_size = 0;
+        int count = sl_codepoint_decode(text + i, text_length - i, codepoints, SL__TEXT_DECODE_CHUNK, &decoded_size);
+        i += decoded_size;
+
+        for (int j = 0; j < count; j++)
+        {
+            int letter = codepoints[j];
+
+            if (letter == '\n') {
+                max_width = fmaxf(max_width, current_width);
+                max_chars_in_line = SL_MAX(max_chars_in_line, current_chars_in_line);
+                current_width = 0.0f;
+                current_chars_in_line = 0;
+                previous_index = -1;
+                text_height += font_size + y_spacing;
+            }
+            else if (w != NULL) {
+                int glyph_index = sl__font_glyph_index(font, letter);
+                const sl__glyph_t* glyph = &font->glyphs[glyph_index];
+                float char_width = (glyph->x_advance > 0) ? glyph->x_advance : (glyph->w_atlas + glyph->x_offset);
+                current_width += char_width + sl__font_kerning(font, previous_index, glyph_index);
+                current_chars_in_line++;
+                previous_index = glyph_index;
+            }
         }
     }
 
@@ -190,7 +683,7 @@ void sl__font_measure_text(float* w, float* h, const sl__font_t* font, const cha
     if (h) *h = text_height;
 }
 
-void sl__font_measure_codepoints(float* w, float* h, const sl__font_t* font, const int* codepoints, int length, float font_size, float x_spacing, float y_spacing)
+void sl__font_measure_codepoints(float* w, float* h, sl__font_t* font, const int* codepoints, int length, float font_size, float x_spacing, float y_spacing)
 {
     float scale = font_size / font->base_size;
 
@@ -200,6 +693,7 @@ void sl__font_measure_codepoints(float* w, float* h, const sl__font_t* font, con
 
     int max_chars_in_line = 0;
     int current_chars_in_line = 0;
+    int previous_index = -1;
 
     for (int i = 0; i < length; i++)
     {
@@ -210,13 +704,16 @@ void sl__font_measure_codepoints(float* w, float* h, const sl__font_t* font, con
             max_chars_in_line = SL_MAX(max_chars_in_line, current_chars_in_line);
             current_width = 0.0f;
             current_chars_in_line = 0;
+            previous_index = -1;
             text_height += font_size + y_spacing;
         }
         else {
-            const sl__glyph_t* glyph = sl__glyph_info(font, letter);
+            int glyph_index = sl__font_glyph_index(font, letter);
+            const sl__glyph_t* glyph = &font->glyphs[glyph_index];
             float char_width = (glyph->x_advance > 0) ? glyph->x_advance : (glyph->w_atlas + glyph->x_offset);
-            current_width += char_width;
+            current_width += char_width + sl__font_kerning(font, previous_index, glyph_index);
             current_chars_in_line++;
+            previous_index = glyph_index;
         }
     }
 
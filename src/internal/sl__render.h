@@ -32,12 +32,84 @@
 #define SL__INDEX_BUFFER_SIZE (SL__VERTEX_BUFFER_SIZE * 3)
 #define SL__MATRIX_STACK_SIZE 8
 #define SL__MAX_DRAW_CALLS 256
+#define SL__TRANSFORM_PALETTE_SIZE 32
+#define SL__FONT_DIRECT_LOOKUP_SIZE 256
+#define SL__FONT_CACHE_PAGE_SIZE 512
+#define SL__FONT_CACHE_MAX_PAGES 16
+#define SL__FONT_CACHE_DEFAULT_PAGES 4
+#define SL__FONT_SDF_PIXEL_DIST_SCALE 32.0f
+#define SL__TEXT_DECODE_CHUNK 256
+#define SL__FONT_SDF_MAX_OUTLINE 3.5f
+
+/* === GL 3.3 Core Entry Points === */
+
+#ifdef SL_BACKEND_GL33
+
+// NOTE: The GLES2 loader also works on a GL 3.3 core context,
+//       only the entry points and enums it lacks are defined here.
+
+#define SL__UBO_BINDING_MATRICES 0
+
+#define GL_RED                          0x1903
+#define GL_GREEN                        0x1904
+#define GL_RG                           0x8227
+#define GL_R8                           0x8229
+#define GL_RG8                          0x822B
+#define GL_RGB8                         0x8051
+#define GL_RGBA8                        0x8058
+#define GL_DEPTH_STENCIL                0x84F9
+#define GL_DEPTH24_STENCIL8             0x88F0
+#define GL_UNSIGNED_INT_24_8            0x84FA
+#define GL_TEXTURE_SWIZZLE_RGBA         0x8E46
+#define GL_UNIFORM_BUFFER               0x8A11
+#define GL_INVALID_INDEX                0xFFFFFFFFu
+#define GL_MAP_WRITE_BIT                0x0002
+#define GL_MAP_INVALIDATE_BUFFER_BIT    0x0008
+
+typedef void (GLAD_API_PTR *sl__PFNGLGENVERTEXARRAYSPROC)(GLsizei n, GLuint* arrays);
+typedef void (GLAD_API_PTR *sl__PFNGLBINDVERTEXARRAYPROC)(GLuint array);
+typedef void (GLAD_API_PTR *sl__PFNGLDELETEVERTEXARRAYSPROC)(GLsizei n, const GLuint* arrays);
+typedef void* (GLAD_API_PTR *sl__PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+typedef GLboolean (GLAD_API_PTR *sl__PFNGLUNMAPBUFFERPROC)(GLenum target);
+typedef void (GLAD_API_PTR *sl__PFNGLBINDBUFFERBASEPROC)(GLenum target, GLuint index, GLuint buffer);
+typedef GLuint (GLAD_API_PTR *sl__PFNGLGETUNIFORMBLOCKINDEXPROC)(GLuint program, const GLchar* name);
+typedef void (GLAD_API_PTR *sl__PFNGLUNIFORMBLOCKBINDINGPROC)(GLuint program, GLuint index, GLuint binding);
+typedef void (GLAD_API_PTR *sl__PFNGLDEPTHRANGEPROC)(double n, double f);
+
+extern struct sl__gl33 {
+    sl__PFNGLGENVERTEXARRAYSPROC GenVertexArrays;
+    sl__PFNGLBINDVERTEXARRAYPROC BindVertexArray;
+    sl__PFNGLDELETEVERTEXARRAYSPROC DeleteVertexArrays;
+    sl__PFNGLMAPBUFFERRANGEPROC MapBufferRange;
+    sl__PFNGLUNMAPBUFFERPROC UnmapBuffer;
+    sl__PFNGLBINDBUFFERBASEPROC BindBufferBase;
+    sl__PFNGLGETUNIFORMBLOCKINDEXPROC GetUniformBlockIndex;
+    sl__PFNGLUNIFORMBLOCKBINDINGPROC UniformBlockBinding;
+    sl__PFNGLDEPTHRANGEPROC DepthRange;
+} sl__gl33;
+
+#define glGenVertexArrays sl__gl33.GenVertexArrays
+#define glBindVertexArray sl__gl33.BindVertexArray
+#define glDeleteVertexArrays sl__gl33.DeleteVertexArrays
+#define glMapBufferRange sl__gl33.MapBufferRange
+#define glUnmapBuffer sl__gl33.UnmapBuffer
+#define glBindBufferBase sl__gl33.BindBufferBase
+#define glGetUniformBlockIndex sl__gl33.GetUniformBlockIndex
+#define glUniformBlockBinding sl__gl33.UniformBlockBinding
+#define glDepthRange sl__gl33.DepthRange
+
+#endif // SL_BACKEND_GL33
 
 /* === Internal Structs === */
 
 typedef struct {
     uint32_t id;
     int w, h;
+#ifdef SL_BACKEND_SOFTWARE
+    uint32_t* pixels;           ///< Packed RGBA8 texels (red in the low byte), rows stored as uploaded
+    sl_filter_mode_t filter;    ///< Sampling filter, trilinear falls back to bilinear
+    sl_wrap_mode_t wrap;        ///< Sampling wrap mode
+#endif
 } sl__texture_t;
 
 typedef struct {
@@ -49,25 +121,99 @@ typedef struct {
     int y_atlas;            ///< Y-coordinate position in texture atlas
     int w_atlas;            ///< Width of glyph in texture atlas
     int h_atlas;            ///< Height of glyph in texture atlas
+    int page;               ///< Atlas page of the glyph, -1 if not rasterized yet
+    int font_index;         ///< Glyph index in the font file, 0 if the font lacks it
 } sl__glyph_t;
 
+typedef struct {
+    int codepoint;          ///< Unicode codepoint value, -1 for an empty slot
+    int index;              ///< Index of the glyph in the font
+} sl__glyph_slot_t;
+
+typedef struct {
+    uint32_t pair;          ///< Left glyph index in the high half, right in the low half, all bits set if empty
+    float advance;          ///< Advance adjustment in pixels at the base size
+} sl__kern_pair_t;
+
+typedef struct sl__font_cache sl__font_cache_t;
+
 typedef struct {
     int base_size;          ///< Base font size (default character height in pixels)
     int glyph_count;        ///< Total number of glyphs available in this font
+    int glyph_capacity;     ///< Allocated glyphs, only grows for dynamic fonts
     int glyph_padding;      ///< Padding around glyphs in the texture atlas
     uint32_t texture;       ///< Texture atlas containing all glyph images
     sl__glyph_t* glyphs;    ///< Array of glyph information structures
     sl_font_type_t type;    ///< Font rendering type used during text rendering
+
+    int direct_lookup[SL__FONT_DIRECT_LOOKUP_SIZE];     ///< Glyph index of the first codepoints, -1 if missing
+    sl__glyph_slot_t* glyph_map;                        ///< Open addressing table for the other codepoints
+    int glyph_map_capacity;                             ///< Power of two, zero if the map is not needed
+    int glyph_map_count;                                ///< Codepoints stored in the map
+    int fallback_index;                                 ///< Glyph used for missing codepoints
+
+    sl__kern_pair_t* kern_pairs;                        ///< Open addressing table of the non-zero kerning pairs
+    int kern_capacity;                                  ///< Power of two, zero if the font has no kerning
+    int kern_count;
+
+    sl__font_cache_t* cache;                            ///< Rasterizer and atlas pages of dynamic fonts, NULL otherwise
 } sl__font_t;
 
+typedef struct {
+    int index;              ///< Glyph index in the font
+    float x;                ///< Offset from the line start at the layout font size
+} sl__layout_glyph_t;
+
+typedef struct {
+    int glyph_first;        ///< First glyph of the line in its paragraph
+    int glyph_count;
+    float w;                ///< Width without the trailing blanks, used for alignment
+} sl__layout_line_t;
+
+// NOTE: Paragraphs are the text between two line breaks, each one
+//       keeps its own glyphs and line breaks so an edit only lays
+//       out again the paragraphs that actually changed.
+
+typedef struct {
+    int length;                     ///< Byte length in the layout text, without the line break
+    sl__layout_glyph_t* glyphs;     ///< Drawable glyphs only, blanks are resolved
+    int glyph_count;
+    int glyph_capacity;
+    sl__layout_line_t* lines;
+    int line_count;
+    int line_capacity;
+} sl__layout_paragraph_t;
+
+typedef struct {
+    sl_font_id font;
+    float font_size;
+    sl_vec2_t spacing;
+    float box_w, box_h;                     ///< Wrap width and clip height, zero when unbounded
+    sl_text_wrap_t wrap;
+    sl_text_align_t align;
+    char* text;                             ///< Copy of the string, compared on updates
+    sl__layout_paragraph_t* paragraphs;
+    int paragraph_count;
+    int line_count;                         ///< Lines of all the paragraphs
+    float w, h;                             ///< Bounds of the laid out lines
+} sl__text_layout_t;
+
 typedef struct {
     GLuint vbo;
     GLuint ebo;
+    GLuint vao;     ///< Only used by the GL 3.3 backend
+#ifdef SL_BACKEND_SOFTWARE
+    sl_vertex_3d_t* vertices;
+    uint16_t* indices;
+    int vertex_count;
+    int index_count;
+#endif
 } sl__mesh_t;
 
 typedef struct {
     uint32_t id;
     int loc_mvp;
+    int loc_transforms;     ///< Only used by the GLES2 backend
 } sl__shader_t;
 
 typedef struct {
@@ -102,9 +248,21 @@ extern struct sl__render {
     sl__registry_t reg_shaders;
     sl__registry_t reg_meshes;
     sl__registry_t reg_fonts;
+    sl__registry_t reg_layouts;
 
     sl_texture_id default_texture;
     sl_shader_id default_shader;
+    sl_shader_id sdf_shader;                ///< Built-in text shader of SDF fonts, zero if unavailable
+
+    int loc_sdf_outline_width;
+    int loc_sdf_outline_color;
+    int loc_sdf_shadow_offset;
+    int loc_sdf_shadow_color;
+
+    float text_outline_width;               ///< In distance units of the SDF atlas
+    sl_color_t text_outline_color;
+    sl_vec2_t text_shadow_offset;           ///< In window pixels
+    sl_color_t text_shadow_color;
 
     sl_texture_id current_texture;
     sl_canvas_id current_canvas;
@@ -124,18 +282,32 @@ extern struct sl__render {
     bool transform_is_identity;
     bool texture_is_identity;
     bool use_custom_proj;
+    bool gpu_transform;
+    bool opaque_sorting;
+
+    bool depth_test;        ///< Depth state set by the user, restored after sorted draws
+    bool depth_write;
+    float depth_near;
+    float depth_far;
 
     sl_vertex_2d_t vertex_buffer[SL__VERTEX_BUFFER_SIZE];
     GLushort index_buffer[SL__INDEX_BUFFER_SIZE];
+    uint8_t transform_index_buffer[SL__VERTEX_BUFFER_SIZE];
     int vertex_count;
     int index_count;
 
+    float transform_palette[SL__TRANSFORM_PALETTE_SIZE][8];     ///< 2D affine rows, the first entry is the identity
+    int transform_palette_count;
+    int transform_palette_slot;                                 ///< Entry of the current transform, -1 if not stored yet
+
     sl__draw_call_t draw_calls[SL__MAX_DRAW_CALLS];
     int draw_call_count;
 
     GLuint vbo;
     GLuint ebo;
     GLuint vao;
+    GLuint ubo;
+    GLuint vbo_transform;
     sl__render_state_t last_state;
     bool has_pending_data;
 
@@ -146,10 +318,34 @@ extern struct sl__render {
 bool sl__render_init(int w, int h);
 void sl__render_quit(void);
 
+/* === Backend Functions === */
+
+#ifndef SL_BACKEND_SOFTWARE
+void sl__render_tex_image_2d(sl_pixel_format_t format, int w, int h, const void* pixels);
+void sl__render_tex_sub_image_2d(sl_pixel_format_t format, int x, int y, int w, int h, const void* pixels);
+#endif
+
+/* === Shader Functions === */
+
+sl_shader_id sl__shader_create_sdf(void);
+
 /* === Font Functions === */
 
-const sl__glyph_t* sl__glyph_info(const sl__font_t* font, int codepoint);
-void sl__font_measure_text(float* w, float* h, const sl__font_t* font, const char* text, float font_size, float x_spacing, float y_spacing);
-void sl__font_measure_codepoints(float* w, float* h, const sl__font_t* font, const int* codepoints, int length, float font_size, float x_spacing, float y_spacing);
+// NOTE: Lookups take a mutable font because dynamic fonts
+//       add the glyphs they have not seen yet on the fly.
+
+bool sl__font_build_lookup(sl__font_t* font);
+bool sl__font_lookup_insert(sl__font_t* font, int codepoint, int index);
+int sl__font_glyph_index(sl__font_t* font, int codepoint);
+const sl__glyph_t* sl__glyph_info(sl__font_t* font, int codepoint);
+bool sl__font_kerning_insert(sl__font_t* font, int left, int right, float advance);
+float sl__font_kerning(const sl__font_t* font, int left, int right);
+void sl__font_measure_text(float* w, float* h, sl__font_t* font, const char* text, float font_size, float x_spacing, float y_spacing);
+void sl__font_measure_codepoints(float* w, float* h, sl__font_t* font, const int* codepoints, int length, float font_size, float x_spacing, float y_spacing);
+
+/* === Font Cache Functions === */
+
+int sl__font_cache_add_glyph(sl__font_t* font, int codepoint);
+sl_texture_id sl__font_glyph_texture(sl__font_t* font, int index, bool* rasterized);
 
 #endif // SL__RENDER_H
@@ -18,6 +18,15 @@
  */
 
 #ifndef SL__SIMD_H
+#define SL__SIMD_H
+
+#include <smol.h>
+
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
 
 #if defined(__FMA__) && defined(__AVX2__)
     #define SL__HAS_FMA_AVX2
@@ -78,4 +87,253 @@
     #include <arm_neon.h>
 #endif
 
+/* === Four Lane Helpers === */
+
+// NOTE: sl__f4 holds four floats, sl__m4 the lane masks of the comparisons,
+//       sl__u4 four RGBA8 colors and sl__i4 four integers. NEON is only used
+//       on AArch64, which has the vector division, other targets without
+//       SSE2 get the scalar versions.
+
+#if defined(SL__HAS_SSE2)
+#   define SL__SIMD_SSE2
+#elif (defined(SL__HAS_NEON) || defined(SL__HAS_NEON_FMA)) && defined(__aarch64__)
+#   define SL__SIMD_NEON
+#endif
+
+#if defined(SL__SIMD_SSE2)
+
+typedef __m128 sl__f4;
+typedef __m128 sl__m4;
+typedef __m128i sl__u4;
+typedef __m128i sl__i4;
+
+static inline sl__f4 sl__f4_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void sl__f4_store(float* p, sl__f4 v) { _mm_storeu_ps(p, v); }
+static inline sl__f4 sl__f4_set1(float x) { return _mm_set1_ps(x); }
+static inline sl__f4 sl__f4_set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+static inline sl__f4 sl__f4_add(sl__f4 a, sl__f4 b) { return _mm_add_ps(a, b); }
+static inline sl__f4 sl__f4_sub(sl__f4 a, sl__f4 b) { return _mm_sub_ps(a, b); }
+static inline sl__f4 sl__f4_mul(sl__f4 a, sl__f4 b) { return _mm_mul_ps(a, b); }
+static inline sl__f4 sl__f4_div(sl__f4 a, sl__f4 b) { return _mm_div_ps(a, b); }
+static inline sl__f4 sl__f4_min(sl__f4 a, sl__f4 b) { return _mm_min_ps(a, b); }
+static inline sl__f4 sl__f4_max(sl__f4 a, sl__f4 b) { return _mm_max_ps(a, b); }
+static inline sl__f4 sl__f4_rsqrt(sl__f4 x) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(x)); }
+
+static inline sl__f4 sl__f4_round(sl__f4 x, sl__i4* i)
+{
+    *i = _mm_cvtps_epi32(x);
+    return _mm_cvtepi32_ps(*i);
+}
+
+static inline sl__m4 sl__f4_gt(sl__f4 a, sl__f4 b) { return _mm_cmpgt_ps(a, b); }
+static inline sl__m4 sl__f4_eq(sl__f4 a, sl__f4 b) { return _mm_cmpeq_ps(a, b); }
+static inline sl__m4 sl__m4_and(sl__m4 a, sl__m4 b) { return _mm_and_ps(a, b); }
+static inline sl__m4 sl__m4_or(sl__m4 a, sl__m4 b) { return _mm_or_ps(a, b); }
+static inline sl__m4 sl__m4_from_bool(bool b) { return _mm_castsi128_ps(_mm_set1_epi32(b ? -1 : 0)); }
+static inline int sl__m4_bits(sl__m4 m) { return _mm_movemask_ps(m); }
+
+static inline sl__i4 sl__i4_add1(sl__i4 q) { return _mm_add_epi32(q, _mm_set1_epi32(1)); }
+
+static inline sl__f4 sl__i4_select_bit(sl__i4 q, int bit, sl__f4 if_set, sl__f4 if_clear)
+{
+    __m128i b = _mm_set1_epi32(bit);
+    __m128 m = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, b), b));
+    return _mm_or_ps(_mm_and_ps(m, if_set), _mm_andnot_ps(m, if_clear));
+}
+
+static inline sl__u4 sl__u4_load(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline void sl__u4_store(uint32_t* p, sl__u4 v) { _mm_storeu_si128((__m128i*)p, v); }
+static inline sl__u4 sl__u4_set(const uint32_t t[4]) { return _mm_loadu_si128((const __m128i*)t); }
+static inline void sl__u4_get(uint32_t t[4], sl__u4 v) { _mm_storeu_si128((__m128i*)t, v); }
+
+static inline sl__u4 sl__u4_select(sl__m4 m, sl__u4 a, sl__u4 b)
+{
+    __m128i mi = _mm_castps_si128(m);
+    return _mm_or_si128(_mm_and_si128(mi, a), _mm_andnot_si128(mi, b));
+}
+
+static inline sl__f4 sl__u4_channel(sl__u4 v, int shift)
+{
+    __m128i c = _mm_and_si128(_mm_srl_epi32(v, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xFF));
+    return _mm_mul_ps(_mm_cvtepi32_ps(c), _mm_set1_ps(1.0f / 255.0f));
+}
+
+static inline sl__u4 sl__u4_pack(sl__f4 r, sl__f4 g, sl__f4 b, sl__f4 a)
+{
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f), half = _mm_set1_ps(0.5f);
+
+    __m128i ri = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(r, zero), one), scale), half));
+    __m128i gi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(g, zero), one), scale), half));
+    __m128i bi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(b, zero), one), scale), half));
+    __m128i ai = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(a, zero), one), scale), half));
+
+    return _mm_or_si128(_mm_or_si128(ri, _mm_slli_epi32(gi, 8)), _mm_or_si128(_mm_slli_epi32(bi, 16), _mm_slli_epi32(ai, 24)));
+}
+
+#elif defined(SL__SIMD_NEON)
+
+typedef float32x4_t sl__f4;
+typedef uint32x4_t sl__m4;
+typedef uint32x4_t sl__u4;
+typedef int32x4_t sl__i4;
+
+static inline sl__f4 sl__f4_load(const float* p) { return vld1q_f32(p); }
+static inline void sl__f4_store(float* p, sl__f4 v) { vst1q_f32(p, v); }
+static inline sl__f4 sl__f4_set1(float x) { return vdupq_n_f32(x); }
+static inline sl__f4 sl__f4_set(float a, float b, float c, float d) { const float t[4] = { a, b, c, d }; return vld1q_f32(t); }
+static inline sl__f4 sl__f4_add(sl__f4 a, sl__f4 b) { return vaddq_f32(a, b); }
+static inline sl__f4 sl__f4_sub(sl__f4 a, sl__f4 b) { return vsubq_f32(a, b); }
+static inline sl__f4 sl__f4_mul(sl__f4 a, sl__f4 b) { return vmulq_f32(a, b); }
+static inline sl__f4 sl__f4_div(sl__f4 a, sl__f4 b) { return vdivq_f32(a, b); }
+static inline sl__f4 sl__f4_min(sl__f4 a, sl__f4 b) { return vminq_f32(a, b); }
+static inline sl__f4 sl__f4_max(sl__f4 a, sl__f4 b) { return vmaxq_f32(a, b); }
+
+static inline sl__f4 sl__f4_rsqrt(sl__f4 x)
+{
+    float32x4_t r = vrsqrteq_f32(x);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(x, r), r));  // Newton step
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(x, r), r));  // Newton step
+    return r;
+}
+
+static inline sl__f4 sl__f4_round(sl__f4 x, sl__i4* i)
+{
+    // Round half away from zero, like _mm_cvtps_epi32 up to ties
+    float32x4_t half = vbslq_f32(vcltq_f32(x, vdupq_n_f32(0.0f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+    *i = vcvtq_s32_f32(vaddq_f32(x, half));
+    return vcvtq_f32_s32(*i);
+}
+
+static inline sl__m4 sl__f4_gt(sl__f4 a, sl__f4 b) { return vcgtq_f32(a, b); }
+static inline sl__m4 sl__f4_eq(sl__f4 a, sl__f4 b) { return vceqq_f32(a, b); }
+static inline sl__m4 sl__m4_and(sl__m4 a, sl__m4 b) { return vandq_u32(a, b); }
+static inline sl__m4 sl__m4_or(sl__m4 a, sl__m4 b) { return vorrq_u32(a, b); }
+static inline sl__m4 sl__m4_from_bool(bool b) { return vdupq_n_u32(b ? 0xFFFFFFFFu : 0u); }
+
+static inline int sl__m4_bits(sl__m4 m)
+{
+    return (int)((vgetq_lane_u32(m, 0) & 1) | ((vgetq_lane_u32(m, 1) & 1) << 1) |
+                 ((vgetq_lane_u32(m, 2) & 1) << 2) | ((vgetq_lane_u32(m, 3) & 1) << 3));
+}
+
+static inline sl__i4 sl__i4_add1(sl__i4 q) { return vaddq_s32(q, vdupq_n_s32(1)); }
+
+static inline sl__f4 sl__i4_select_bit(sl__i4 q, int bit, sl__f4 if_set, sl__f4 if_clear)
+{
+    uint32x4_t m = vtstq_s32(q, vdupq_n_s32(bit));
+    return vbslq_f32(m, if_set, if_clear);
+}
+
+static inline sl__u4 sl__u4_load(const uint32_t* p) { return vld1q_u32(p); }
+static inline void sl__u4_store(uint32_t* p, sl__u4 v) { vst1q_u32(p, v); }
+static inline sl__u4 sl__u4_set(const uint32_t t[4]) { return vld1q_u32(t); }
+static inline void sl__u4_get(uint32_t t[4], sl__u4 v) { vst1q_u32(t, v); }
+static inline sl__u4 sl__u4_select(sl__m4 m, sl__u4 a, sl__u4 b) { return vbslq_u32(m, a, b); }
+
+static inline sl__f4 sl__u4_channel(sl__u4 v, int shift)
+{
+    uint32x4_t c = vandq_u32(vshlq_u32(v, vdupq_n_s32(-shift)), vdupq_n_u32(0xFF));
+    return vmulq_n_f32(vcvtq_f32_u32(c), 1.0f / 255.0f);
+}
+
+static inline sl__u4 sl__u4_pack(sl__f4 r, sl__f4 g, sl__f4 b, sl__f4 a)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f), half = vdupq_n_f32(0.5f);
+
+    uint32x4_t ri = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(r, zero), one), 255.0f), half));
+    uint32x4_t gi = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(g, zero), one), 255.0f), half));
+    uint32x4_t bi = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(b, zero), one), 255.0f), half));
+    uint32x4_t ai = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(a, zero), one), 255.0f), half));
+
+    return vorrq_u32(vorrq_u32(ri, vshlq_n_u32(gi, 8)), vorrq_u32(vshlq_n_u32(bi, 16), vshlq_n_u32(ai, 24)));
+}
+
+#else
+
+typedef struct { float v[4]; } sl__f4;
+typedef struct { uint32_t v[4]; } sl__m4;
+typedef struct { uint32_t v[4]; } sl__u4;
+typedef struct { int32_t v[4]; } sl__i4;
+
+#define SL__F4_OP(name, expr)                                   \
+    static inline sl__f4 name(sl__f4 a, sl__f4 b) {             \
+        sl__f4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr);  \
+        return r;                                               \
+    }
+
+SL__F4_OP(sl__f4_add, a.v[i] + b.v[i])
+SL__F4_OP(sl__f4_sub, a.v[i] - b.v[i])
+SL__F4_OP(sl__f4_mul, a.v[i] * b.v[i])
+SL__F4_OP(sl__f4_div, a.v[i] / b.v[i])
+SL__F4_OP(sl__f4_min, a.v[i] < b.v[i] ? a.v[i] : b.v[i])
+SL__F4_OP(sl__f4_max, a.v[i] > b.v[i] ? a.v[i] : b.v[i])
+
+#undef SL__F4_OP
+
+static inline sl__f4 sl__f4_load(const float* p) { sl__f4 r; SDL_memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline void sl__f4_store(float* p, sl__f4 v) { SDL_memcpy(p, v.v, sizeof(v.v)); }
+static inline sl__f4 sl__f4_set1(float x) { return (sl__f4) {{ x, x, x, x }}; }
+static inline sl__f4 sl__f4_set(float a, float b, float c, float d) { return (sl__f4) {{ a, b, c, d }}; }
+static inline sl__f4 sl__f4_rsqrt(sl__f4 x) { for (int i = 0; i < 4; i++) x.v[i] = 1.0f / sqrtf(x.v[i]); return x; }
+
+static inline sl__f4 sl__f4_round(sl__f4 x, sl__i4* i)
+{
+    for (int k = 0; k < 4; k++) {
+        i->v[k] = (int32_t)lrintf(x.v[k]);
+        x.v[k] = (float)i->v[k];
+    }
+    return x;
+}
+
+static inline sl__m4 sl__f4_gt(sl__f4 a, sl__f4 b) { sl__m4 r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] > b.v[i] ? ~0u : 0u; return r; }
+static inline sl__m4 sl__f4_eq(sl__f4 a, sl__f4 b) { sl__m4 r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] == b.v[i] ? ~0u : 0u; return r; }
+static inline sl__m4 sl__m4_and(sl__m4 a, sl__m4 b) { sl__m4 r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] & b.v[i]; return r; }
+static inline sl__m4 sl__m4_or(sl__m4 a, sl__m4 b) { sl__m4 r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] | b.v[i]; return r; }
+static inline sl__m4 sl__m4_from_bool(bool b) { uint32_t m = b ? ~0u : 0u; return (sl__m4) {{ m, m, m, m }}; }
+static inline int sl__m4_bits(sl__m4 m) { return (int)((m.v[0] & 1) | ((m.v[1] & 1) << 1) | ((m.v[2] & 1) << 2) | ((m.v[3] & 1) << 3)); }
+
+static inline sl__i4 sl__i4_add1(sl__i4 q) { for (int k = 0; k < 4; k++) q.v[k] += 1; return q; }
+
+static inline sl__f4 sl__i4_select_bit(sl__i4 q, int bit, sl__f4 if_set, sl__f4 if_clear)
+{
+    for (int k = 0; k < 4; k++) {
+        if (q.v[k] & bit) if_clear.v[k] = if_set.v[k];
+    }
+    return if_clear;
+}
+
+static inline sl__u4 sl__u4_load(const uint32_t* p) { sl__u4 r; SDL_memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline void sl__u4_store(uint32_t* p, sl__u4 v) { SDL_memcpy(p, v.v, sizeof(v.v)); }
+static inline sl__u4 sl__u4_set(const uint32_t t[4]) { return sl__u4_load(t); }
+static inline void sl__u4_get(uint32_t t[4], sl__u4 v) { sl__u4_store(t, v); }
+static inline sl__u4 sl__u4_select(sl__m4 m, sl__u4 a, sl__u4 b) { sl__u4 r; for (int i = 0; i < 4; i++) r.v[i] = (a.v[i] & m.v[i]) | (b.v[i] & ~m.v[i]); return r; }
+
+static inline sl__f4 sl__u4_channel(sl__u4 v, int shift)
+{
+    sl__f4 r;
+    for (int i = 0; i < 4; i++) r.v[i] = (float)((v.v[i] >> shift) & 0xFF) * (1.0f / 255.0f);
+    return r;
+}
+
+static inline sl__u4 sl__u4_pack(sl__f4 r, sl__f4 g, sl__f4 b, sl__f4 a)
+{
+    sl__u4 out;
+    for (int i = 0; i < 4; i++) {
+        uint32_t ri = (uint32_t)(SL_CLAMP(r.v[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t gi = (uint32_t)(SL_CLAMP(g.v[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t bi = (uint32_t)(SL_CLAMP(b.v[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t ai = (uint32_t)(SL_CLAMP(a.v[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        out.v[i] = ri | (gi << 8) | (bi << 16) | (ai << 24);
+    }
+    return out;
+}
+
+#endif
+
+static inline sl__f4 sl__f4_fma(sl__f4 a, sl__f4 b, sl__f4 c)
+{
+    return sl__f4_add(sl__f4_mul(a, b), c);
+}
+
 #endif // SL__SIMD_H
@@ -20,6 +20,7 @@
 #include <smol.h>
 
 #include "./internal/sl__audio.h"
+#include "./internal/sl__mixer.h"
 
 /* === Public API === */
 
@@ -42,20 +43,14 @@ void sl_audio_set_volume_master(float volume)
 {
     sl__audio.volume_master = SL_CLAMP(volume, 0.0f, 1.0f);
 
-    sl__audio_update_all_sample_volumes();
-
-    SDL_LockMutex(sl__audio.stream_mutex);
-    sl__audio_update_all_stream_volumes();
-    SDL_UnlockMutex(sl__audio.stream_mutex);
+    sl__audio_update_master_volume();
 }
 
 void sl_audio_set_volume_stream(float volume)
 {
     sl__audio.volume_stream = SL_CLAMP(volume, 0.0f, 1.0f);
 
-    SDL_LockMutex(sl__audio.stream_mutex);
     sl__audio_update_all_stream_volumes();
-    SDL_UnlockMutex(sl__audio.stream_mutex);
 }
 
 void sl_audio_set_volume_sample(float volume)
@@ -64,3 +59,105 @@ void sl_audio_set_volume_sample(float volume)
 
     sl__audio_update_all_sample_volumes();
 }
+
+void sl_audio_set_stream_desc(const sl_stream_desc_t* desc)
+{
+    sl__audio_stream_desc_resolve(&sl__audio.stream_desc, desc);
+}
+
+void sl_audio_get_stream_desc(sl_stream_desc_t* desc)
+{
+    if (desc) *desc = sl__audio.stream_desc;
+}
+
+void sl_audio_set_bus_volume(sl_audio_bus_t bus, float volume)
+{
+    if (bus < 0 || bus >= SL_AUDIO_BUS_COUNT) {
+        sl_logw("AUDIO: Invalid bus %d", bus);
+        return;
+    }
+
+    sl__audio.bus_volumes[bus] = SL_CLAMP(volume, 0.0f, 1.0f);
+
+    sl__audio_update_bus_volume(bus);
+}
+
+float sl_audio_get_bus_volume(sl_audio_bus_t bus)
+{
+    if (bus < 0 || bus >= SL_AUDIO_BUS_COUNT) {
+        sl_logw("AUDIO: Invalid bus %d", bus);
+        return 0.0f;
+    }
+
+    return sl__audio.bus_volumes[bus];
+}
+
+void sl_audio_set_bus_desc(sl_audio_bus_t bus, const sl_audio_bus_desc_t* desc)
+{
+    if (bus < 0 || bus >= SL_AUDIO_BUS_COUNT) {
+        sl_logw("AUDIO: Invalid bus %d", bus);
+        return;
+    }
+
+    sl__mixer_bus_desc_resolve(&sl__audio.bus_descs[bus], desc);
+
+    sl__mixer_command_t command = {
+        .type = SL__MIXER_CMD_BUS_DESC,
+        .bus = bus,
+        .bus_desc = sl__audio.bus_descs[bus]
+    };
+
+    sl__mixer_post(&command);
+}
+
+void sl_audio_get_bus_desc(sl_audio_bus_t bus, sl_audio_bus_desc_t* desc)
+{
+    if (bus < 0 || bus >= SL_AUDIO_BUS_COUNT) {
+        sl_logw("AUDIO: Invalid bus %d", bus);
+        return;
+    }
+
+    if (desc) *desc = sl__audio.bus_descs[bus];
+}
+
+bool sl_audio_render(float* out, int frames)
+{
+    if (!sl__audio.offline) {
+        sl_logw("AUDIO: Rendering requires audio initialized with SL_FLAG_AUDIO_OFFLINE");
+        return false;
+    }
+
+    if (out == NULL || frames < 0) {
+        sl_loge("AUDIO: Invalid output given for audio rendering");
+        return false;
+    }
+
+    sl__audio_render(out, frames);
+
+    return true;
+}
+
+bool sl_audio_render_wav(const char* file_path, int frames)
+{
+    if (!sl__audio.offline) {
+        sl_logw("AUDIO: Rendering requires audio initialized with SL_FLAG_AUDIO_OFFLINE");
+        return false;
+    }
+
+    if (file_path == NULL || frames < 0) {
+        sl_loge("AUDIO: Invalid file path given for audio rendering");
+        return false;
+    }
+
+    return sl__audio_render_wav(file_path, frames);
+}
+
+int sl_audio_get_pending_loads(void)
+{
+    return sl__audio.load_pending;
+}
+
+void sl_audio_wait_loads(void)
+{
+    sl__audio_load_wait();
+}
@@ -21,35 +21,40 @@
 
 #include "./internal/sl__render.h"
 
+#ifdef SL_BACKEND_SOFTWARE
+    #include "./internal/sl__raster.h"
+#endif
+
 /* === Public API === */
 
 sl_canvas_id sl_canvas_create(int w, int h, sl_pixel_format_t format, bool depth)
 {
-    /* --- Get color target format --- */
-
-    GLenum gl_color_format = GL_RGBA;
-    GLenum gl_color_type = GL_UNSIGNED_BYTE;
-
-    switch (format) {
-    case SL_PIXEL_FORMAT_LUMINANCE8:
-        gl_color_format = GL_LUMINANCE;
-        break;
-    case SL_PIXEL_FORMAT_ALPHA8:
-        gl_color_format = GL_ALPHA;
-        break;
-    case SL_PIXEL_FORMAT_LUMINANCE_ALPHA8:
-        gl_color_format = GL_LUMINANCE_ALPHA;
-        break;
-    case SL_PIXEL_FORMAT_RGB8:
-        gl_color_format = GL_RGB;
-        break;
-    case SL_PIXEL_FORMAT_RGBA8:
-        gl_color_format = GL_RGBA;
-        break;
-    default:
-        break;
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Allocate the color target --- */
+
+    // NOTE: The rasterizer always renders in RGBA8 and has no depth
+    //       buffer, the format and the depth request are ignored.
+
+    (void)format, (void)depth;
+
+    sl__texture_t color = { 0 };
+
+    if (!sl__raster_texture_alloc(&color, NULL, w, h, SL_PIXEL_FORMAT_RGBA8)) {
+        sl_loge("CANVAS: Failed to create canvas; Out of memory");
+        return 0;
     }
 
+    sl__canvas_t canvas = { 0 };
+
+    canvas.color = sl__registry_add(&sl__render.reg_textures, &color);
+    canvas.w = w;
+    canvas.h = h;
+
+    return sl__registry_add(&sl__render.reg_canvases, &canvas);
+
+#else
+
     /* --- Create framebuffer's targets --- */
 
     GLuint targets[2] = { 0 };
@@ -58,7 +63,7 @@ sl_canvas_id sl_canvas_create(int w, int h, sl_pixel_format_t format, bool depth
     glActiveTexture(GL_TEXTURE0);
 
     glBindTexture(GL_TEXTURE_2D, targets[0]);
-    glTexImage2D(GL_TEXTURE_2D, 0, gl_color_format, w, h, 0, gl_color_format, gl_color_type, NULL);
+    sl__render_tex_image_2d(format, w, h, NULL);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -67,7 +72,11 @@ sl_canvas_id sl_canvas_create(int w, int h, sl_pixel_format_t format, bool depth
 
     if (depth) {
         glBindTexture(GL_TEXTURE_2D, targets[1]);
+#ifdef SL_BACKEND_GL33
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, w, h, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+#else
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_STENCIL_OES, w, h, 0, GL_DEPTH_STENCIL_OES, GL_UNSIGNED_INT_24_8_OES, NULL);
+#endif
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -129,6 +138,8 @@ sl_canvas_id sl_canvas_create(int w, int h, sl_pixel_format_t format, bool depth
     canvas.h = h;
 
     return sl__registry_add(&sl__render.reg_canvases, &canvas);
+
+#endif // SL_BACKEND_SOFTWARE
 }
 
 void sl_canvas_destroy(sl_canvas_id canvas)
@@ -138,15 +149,21 @@ void sl_canvas_destroy(sl_canvas_id canvas)
     }
 
     if (sl__render.current_canvas == canvas) {
+#ifndef SL_BACKEND_SOFTWARE
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+#endif
         sl__render.current_canvas = 0;
     }
 
     sl__canvas_t* data = sl__registry_get(&sl__render.reg_canvases, canvas);
     if (data == NULL) return;
 
+#ifdef SL_BACKEND_SOFTWARE
+    sl_texture_destroy(data->color);
+#else
     glDeleteFramebuffers(1, &data->framebuffer);
     glDeleteTextures(data->depth ? 2 : 1, &data->color);
+#endif
 
     sl__registry_remove(&sl__render.reg_canvases, canvas);
 }
@@ -17,44 +17,230 @@
  *   3. This notice may not be removed or altered from any source distribution.
  */
 
+#include "./internal/sl__simd.h"
+
 #include <SDL3/SDL_stdinc.h>
 
-/* === Public API === */
+/* === SIMD Helpers === */
 
-int sl_codepoint_next(const char* text, int* codepoint_size)
+// NOTE: Text is mostly ASCII, runs of 16 bytes without their high
+//       bit set are checked and widened to codepoints at once, the
+//       other bytes go through the scalar decoder.
+
+#if defined(SL__HAS_SSE2)
+#   define SL__UTF8_SSE2
+#elif (defined(SL__HAS_NEON) || defined(SL__HAS_NEON_FMA)) && defined(__aarch64__)
+#   define SL__UTF8_NEON
+#endif
+
+#if defined(SL__UTF8_SSE2)
+
+static inline bool sl__utf8_ascii16(const uint8_t* src)
 {
-    const char* ptr = text;
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)src)) == 0;
+}
+
+static inline void sl__utf8_widen16(const uint8_t* src, int* dst)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_loadu_si128((const __m128i*)src);
+    __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+    _mm_storeu_si128((__m128i*)(dst + 0), _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(dst + 4), _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(dst + 8), _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128((__m128i*)(dst + 12), _mm_unpackhi_epi16(hi, zero));
+}
+
+#elif defined(SL__UTF8_NEON)
+
+static inline bool sl__utf8_ascii16(const uint8_t* src)
+{
+    return vmaxvq_u8(vld1q_u8(src)) < 0x80;
+}
+
+static inline void sl__utf8_widen16(const uint8_t* src, int* dst)
+{
+    uint8x16_t bytes = vld1q_u8(src);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+    uint16x8_t hi = vmovl_high_u8(bytes);
+
+    vst1q_s32(dst + 0, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))));
+    vst1q_s32(dst + 4, vreinterpretq_s32_u32(vmovl_high_u16(lo)));
+    vst1q_s32(dst + 8, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))));
+    vst1q_s32(dst + 12, vreinterpretq_s32_u32(vmovl_high_u16(hi)));
+}
+
+#else
+
+static inline bool sl__utf8_ascii16(const uint8_t* src)
+{
+    uint64_t a, b;
+    SDL_memcpy(&a, src, 8);
+    SDL_memcpy(&b, src + 8, 8);
+    return ((a | b) & 0x8080808080808080ull) == 0;
+}
+
+static inline void sl__utf8_widen16(const uint8_t* src, int* dst)
+{
+    for (int i = 0; i < 16; i++) {
+        dst[i] = src[i];
+    }
+}
+
+#endif
+
+/* === Internal Functions === */
+
+static inline int sl__utf8_decode_one(const uint8_t* ptr, int size, int* codepoint_size)
+{
+    // NOTE: Bytes past 'size' are read as zero, so sequences cut by
+    //       the end are rejected like those cut by a null terminator.
+
+    uint8_t b0 = ptr[0];
+    uint8_t b1 = (size > 1) ? ptr[1] : 0;
+    uint8_t b2 = (size > 2) ? ptr[2] : 0;
+    uint8_t b3 = (size > 3) ? ptr[3] : 0;
+
     int codepoint = 0x3f;       // Codepoint (defaults to '?')
     *codepoint_size = 1;
 
     // Get current codepoint and bytes processed
-    if (0xf0 == (0xf8 & ptr[0])) {
+    if (0xf0 == (0xf8 & b0)) {
         // 4 byte UTF-8 codepoint
-        if (((ptr[1] & 0xC0) ^ 0x80) || ((ptr[2] & 0xC0) ^ 0x80) || ((ptr[3] & 0xC0) ^ 0x80)) return codepoint; // 10xxxxxx checks
-        codepoint = ((0x07 & ptr[0]) << 18) | ((0x3f & ptr[1]) << 12) | ((0x3f & ptr[2]) << 6) | (0x3f & ptr[3]);
+        if (((b1 & 0xC0) ^ 0x80) || ((b2 & 0xC0) ^ 0x80) || ((b3 & 0xC0) ^ 0x80)) return codepoint; // 10xxxxxx checks
+        codepoint = ((0x07 & b0) << 18) | ((0x3f & b1) << 12) | ((0x3f & b2) << 6) | (0x3f & b3);
         *codepoint_size = 4;
     }
-    else if (0xe0 == (0xf0 & ptr[0])) {
+    else if (0xe0 == (0xf0 & b0)) {
         // 3 byte UTF-8 codepoint */
-        if (((ptr[1] & 0xC0) ^ 0x80) || ((ptr[2] & 0xC0) ^ 0x80)) return codepoint; // 10xxxxxx checks
-        codepoint = ((0x0f & ptr[0]) << 12) | ((0x3f & ptr[1]) << 6) | (0x3f & ptr[2]);
+        if (((b1 & 0xC0) ^ 0x80) || ((b2 & 0xC0) ^ 0x80)) return codepoint; // 10xxxxxx checks
+        codepoint = ((0x0f & b0) << 12) | ((0x3f & b1) << 6) | (0x3f & b2);
         *codepoint_size = 3;
     }
-    else if (0xc0 == (0xe0 & ptr[0])) {
+    else if (0xc0 == (0xe0 & b0)) {
         // 2 byte UTF-8 codepoint
-        if ((ptr[1] & 0xC0) ^ 0x80) return codepoint; // 10xxxxxx checks
-        codepoint = ((0x1f & ptr[0]) << 6) | (0x3f & ptr[1]);
+        if ((b1 & 0xC0) ^ 0x80) return codepoint; // 10xxxxxx checks
+        codepoint = ((0x1f & b0) << 6) | (0x3f & b1);
         *codepoint_size = 2;
     }
-    else if (0x00 == (0x80 & ptr[0])) {
+    else if (0x00 == (0x80 & b0)) {
         // 1 byte UTF-8 codepoint
-        codepoint = ptr[0];
+        codepoint = b0;
         *codepoint_size = 1;
     }
 
     return codepoint;
 }
 
+/* === Public API === */
+
+int sl_codepoint_next(const char* text, int* codepoint_size)
+{
+    // NOTE: Continuation bytes are checked one by one, so the
+    //       decoder never reads past a null terminator.
+
+    const uint8_t* ptr = (const uint8_t*)text;
+
+    if (ptr[0] <= 0x7f) {
+        *codepoint_size = 1;
+        return ptr[0];
+    }
+
+    int size = 1;
+    while (size < 4 && ptr[size] != 0) size++;
+
+    return sl__utf8_decode_one(ptr, size, codepoint_size);
+}
+
+int sl_codepoint_decode(const char* text, int size, int* codepoints, int capacity, int* decoded_size)
+{
+    const uint8_t* ptr = (const uint8_t*)text;
+
+    int count = 0;
+    int i = 0;
+
+    while (i < size && count < capacity)
+    {
+        /* --- Widen the pure ASCII runs 16 bytes at a time --- */
+
+        while (size - i >= 16 && capacity - count >= 16 && sl__utf8_ascii16(ptr + i)) {
+            sl__utf8_widen16(ptr + i, codepoints + count);
+            count += 16;
+            i += 16;
+        }
+
+        if (i >= size || count >= capacity) {
+            break;
+        }
+
+        /* --- Decode the next codepoint --- */
+
+        int codepoint_size = 0;
+        codepoints[count++] = sl__utf8_decode_one(ptr + i, size - i, &codepoint_size);
+        i += codepoint_size;
+    }
+
+    if (decoded_size != NULL) {
+        *decoded_size = i;
+    }
+
+    return count;
+}
+
+bool sl_codepoint_validate(const char* text)
+{
+    // NOTE: Follows RFC 3629, overlong forms, surrogates and
+    //       codepoints past U+10FFFF are rejected.
+
+    const uint8_t* ptr = (const uint8_t*)text;
+    int size = (int)SDL_strlen(text);
+
+    for (int i = 0; i < size;)
+    {
+        if (size - i >= 16 && sl__utf8_ascii16(ptr + i)) {
+            i += 16;
+            continue;
+        }
+
+        uint8_t byte = ptr[i];
+
+        if (byte <= 0x7f) {
+            i++;
+            continue;
+        }
+
+        /* --- Get the length and the range of the second byte --- */
+
+        int length = 0;
+        uint8_t lo = 0x80, hi = 0xbf;
+
+        if (byte >= 0xc2 && byte <= 0xdf) length = 2;
+        else if (byte == 0xe0) length = 3, lo = 0xa0;
+        else if (byte == 0xed) length = 3, hi = 0x9f;
+        else if (byte >= 0xe1 && byte <= 0xef) length = 3;
+        else if (byte == 0xf0) length = 4, lo = 0x90;
+        else if (byte == 0xf4) length = 4, hi = 0x8f;
+        else if (byte >= 0xf1 && byte <= 0xf3) length = 4;
+        else return false;
+
+        /* --- Check the continuation bytes --- */
+
+        if (size - i < length || ptr[i + 1] < lo || ptr[i + 1] > hi) {
+            return false;
+        }
+
+        for (int j = 2; j < length; j++) {
+            if ((ptr[i + j] & 0xc0) != 0x80) return false;
+        }
+
+        i += length;
+    }
+
+    return true;
+}
+
 int sl_codepoint_prev(const char* text, int* codepoint_size)
 {
     const char* ptr = text;
@@ -76,14 +262,21 @@ int sl_codepoint_prev(const char* text, int* codepoint_size)
 
 int sl_codepoint_count(const char* text)
 {
-    uint32_t length = 0;
-    const char* ptr = text;
-
-    while (*ptr != '\0') {
-        int next = 0;
-        sl_codepoint_next(ptr, &next);
-        ptr += next;
-        length++;
+    const uint8_t* ptr = (const uint8_t*)text;
+    int size = (int)SDL_strlen(text);
+    int length = 0;
+
+    for (int i = 0; i < size;) {
+        if (size - i >= 16 && sl__utf8_ascii16(ptr + i)) {
+            length += 16;
+            i += 16;
+        }
+        else {
+            int next = 0;
+            sl__utf8_decode_one(ptr + i, size - i, &next);
+            length++;
+            i += next;
+        }
     }
 
     return length;
@@ -271,16 +464,10 @@ int* sl_codepoint_from_utf8_str(const char* text, int* count)
 {
     int text_length = SDL_strlen(text);
 
-    int codepoint_size = 0;
-    int codepoint_count = 0;
-
     // Allocate a big enough buffer to store as many codepoints as text bytes
     int* codepoints = SDL_calloc(text_length, sizeof(int));
 
-    for (int i = 0; i < text_length; codepoint_count++) {
-        codepoints[codepoint_count] = sl_codepoint_next(text + i, &codepoint_size);
-        i += codepoint_size;
-    }
+    int codepoint_count = sl_codepoint_decode(text, text_length, codepoints, text_length, NULL);
 
     // Re-allocate buffer to the actual number of codepoints loaded
     codepoints = SDL_realloc(codepoints, codepoint_count * sizeof(int));
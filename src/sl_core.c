@@ -23,6 +23,10 @@
 #include "./internal/sl__audio.h"
 #include "./internal/sl__core.h"
 
+#ifdef SL_BACKEND_SOFTWARE
+    #include "./internal/sl__raster.h"
+#endif
+
 #include <SDL3/SDL_filesystem.h>
 #include <SDL3/SDL_stdinc.h>
 #include <SDL3/SDL_events.h>
@@ -71,7 +75,7 @@ bool sl_init_ex(const char* title, int w, int h, const sl_app_desc_t* desc)
         return false;
     }
 
-    if (!sl__audio_init()) {
+    if (!sl__audio_init(desc->flags & SL_FLAG_AUDIO_OFFLINE)) {
         return false;
     }
 
@@ -135,6 +139,10 @@ bool sl_frame_step(void)
     sl__core.mouse_wheel = SL_VEC2_ZERO;
     sl__core.mouse_delta = SL_VEC2_ZERO;
 
+    /* --- Finish the asynchronous audio loads --- */
+
+    sl__audio_update();
+
     /* --- Update system events --- */
 
     SDL_Event ev;
@@ -146,7 +154,16 @@ bool sl_frame_step(void)
             should_run = false;
             break;
         case SDL_EVENT_WINDOW_RESIZED:
+#ifdef SL_BACKEND_SOFTWARE
+            {
+                int w = 0, h = 0;
+                SDL_GetWindowSizeInPixels(sl__core.window, &w, &h);
+                sl__raster_resize_backbuffer(w, h);
+                sl__raster.viewport = (sl__raster_rect_t) { 0, 0, w, h };
+            }
+#else
             glViewport(0, 0, ev.window.data1, ev.window.data2);
+#endif
             if (!sl__render.use_custom_proj) {
                 sl__render.matrix_proj = sl_mat4_ortho(0, ev.window.data1, ev.window.data2, 0, 0, 1);
             }
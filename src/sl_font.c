@@ -22,6 +22,9 @@
 #include "./internal/sl__render.h"
 
 #include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_thread.h>
+#include <SDL3/SDL_cpuinfo.h>
 #include <SDL3/SDL_time.h>
 
  /* === STB TrueType Implementation === */
@@ -33,12 +36,95 @@
 
 #include <stb_truetype.h>
 
+/* === Constants === */
+
+#define FONT_SDF_CHAR_PADDING         4
+#define FONT_SDF_ON_EDGE_VALUE        128
+#define FONT_SDF_PIXEL_DIST_SCALE     SL__FONT_SDF_PIXEL_DIST_SCALE
+#define FONT_BITMAP_ALPHA_THRESHOLD   80
+#define FONT_ATLAS_MAX_SIZE           8192
+#define FONT_RASTER_MAX_THREADS       16
+#define FONT_RASTER_GLYPHS_PER_THREAD 32
+
+/* === Internal Structs === */
+
+typedef struct {
+    sl_texture_id texture;
+    uint64_t last_use;      ///< Cache clock when a glyph of the page was last drawn
+    int x, y;               ///< Pen position on the current shelf
+    int row_h;              ///< Height of the current shelf
+} sl__font_page_t;
+
+struct sl__font_cache {
+    void* file_data;                                        ///< Copy of the font file, referenced by the font info
+    stbtt_fontinfo info;
+    float scale;
+    int scaled_ascent;
+    sl__font_page_t pages[SL__FONT_CACHE_MAX_PAGES];
+    int page_count;
+    int max_pages;                                          ///< Pages kept before the least recently used is evicted
+    uint64_t clock;
+};
+
+typedef struct {
+    uint8_t* pixels;        ///< Coverage or distance values, freed with stbtt_FreeBitmap
+    int w, h;
+} sl__glyph_bitmap_t;
+
+typedef struct {
+    const stbtt_fontinfo* font_info;
+    float scale;
+    sl_font_type_t font_type;
+    const sl__glyph_t* glyphs;
+    const stbrp_rect* pack_rects;
+    sl__glyph_bitmap_t* bitmaps;
+    int glyph_count;
+    SDL_AtomicInt next_glyph;
+} sl__glyph_raster_job_t;
+
+typedef struct {
+    const uint8_t* table;   ///< GPOS pair adjustment subtable
+    int* class_start;       ///< Format 2, first entry of each right class in 'class_glyphs', NULL until needed
+    int* class_glyphs;      ///< Format 2, our glyphs sorted by right class
+} sl__gpos_pairs_t;
+
 /* === Internal Functions Declarations === */
 
 static bool
 generate_font_atlas(sl_image_t* image, const uint8_t* file_data, int data_size, sl_font_type_t font_type,
                     int base_size, int* codepoints, int codepoint_count, int padding, sl__glyph_t** out_glyphs);
 
+static void
+compute_glyph_metrics(const stbtt_fontinfo* font_info, float scale, int scaled_ascent, sl_font_type_t font_type,
+                      int base_size, int ch, sl__glyph_t* glyph, int* w_glyph, int* h_glyph);
+
+static uint8_t*
+rasterize_glyph(const stbtt_fontinfo* font_info, float scale, sl_font_type_t font_type, int ch, int* w_glyph, int* h_glyph);
+
+static void
+rasterize_glyphs_parallel(sl__glyph_raster_job_t* job);
+
+static bool
+build_kerning_table(sl__font_t* font, const uint8_t* file_data);
+
+static bool
+read_gpos_kerning(sl__font_t* font, const stbtt_fontinfo* font_info, const int* font_to_glyph, float scale);
+
+static bool
+group_gpos_classes(sl__gpos_pairs_t* pairs, const sl__font_t* font, const stbtt_fontinfo* font_info, const int* font_to_glyph);
+
+static bool
+add_dynamic_kerning(sl__font_t* font, int index);
+
+static int
+append_dynamic_glyph(sl__font_t* font, int codepoint, int font_index);
+
+static bool
+cache_glyph(sl__font_t* font, sl__glyph_t* glyph);
+
+static void
+remove_cache_page(sl__font_t* font, int page);
+
 /* === Public API === */
 
 sl_font_id sl_font_load_from_memory(const void* file_data, size_t data_size, sl_font_type_t type,
@@ -76,12 +162,34 @@ sl_font_id sl_font_load_from_memory(const void* file_data, size_t data_size, sl_
         return 0;
     }
 
+    /* --- Build the glyph lookup --- */
+
+    if (!sl__font_build_lookup(&font)) {
+        sl_loge("FONT: Failed to build the glyph lookup; Out of memory");
+        sl_image_destroy(&atlas);
+        SDL_free(font.glyphs);
+        return 0;
+    }
+
+    /* --- Extract the kerning pairs of the loaded glyphs --- */
+
+    if (!build_kerning_table(&font, file_data)) {
+        sl_loge("FONT: Failed to build the kerning table; Out of memory");
+        sl_image_destroy(&atlas);
+        SDL_free(font.kern_pairs);
+        SDL_free(font.glyph_map);
+        SDL_free(font.glyphs);
+        return 0;
+    }
+
     /* --- Creating the atlas texture --- */
 
     font.texture = sl_texture_load_from_memory(&atlas);
     sl_image_destroy(&atlas);
 
     if (font.texture == 0) {
+        SDL_free(font.kern_pairs);
+        SDL_free(font.glyph_map);
         SDL_free(font.glyphs);
         return 0;
     }
@@ -117,24 +225,151 @@ sl_font_id sl_font_load(const char* filePath, sl_font_type_t type, int base_size
     return id;
 }
 
+sl_font_id sl_font_load_dynamic_from_memory(const void* file_data, size_t data_size, sl_font_type_t type, int base_size)
+{
+#   define FONT_TTF_DEFAULT_CHARS_PADDING 4
+
+    if (file_data == NULL || data_size == 0 || base_size <= 0) {
+        sl_loge("FONT: Failed to load dynamic font; Invalid input parameters");
+        return 0;
+    }
+
+    sl__font_t font = { 0 };
+
+    font.glyph_padding = FONT_TTF_DEFAULT_CHARS_PADDING;
+    font.base_size = base_size;
+    font.type = type;
+
+    /* --- Keep the font file for later rasterization --- */
+
+    sl__font_cache_t* cache = SDL_calloc(1, sizeof(sl__font_cache_t));
+    if (cache == NULL) {
+        sl_loge("FONT: Failed to load dynamic font; Out of memory");
+        return 0;
+    }
+
+    cache->file_data = SDL_malloc(data_size);
+    if (cache->file_data == NULL) {
+        sl_loge("FONT: Failed to load dynamic font; Out of memory");
+        SDL_free(cache);
+        return 0;
+    }
+
+    SDL_memcpy(cache->file_data, file_data, data_size);
+
+    if (!stbtt_InitFont(&cache->info, cache->file_data, 0)) {
+        sl_loge("FONT: Failed to load dynamic font; Invalid font data");
+        SDL_free(cache->file_data);
+        SDL_free(cache);
+        return 0;
+    }
+
+    int ascent, descent, line_gap;
+    stbtt_GetFontVMetrics(&cache->info, &ascent, &descent, &line_gap);
+
+    cache->scale = stbtt_ScaleForPixelHeight(&cache->info, (float)base_size);
+    cache->scaled_ascent = (int)roundf((float)ascent * cache->scale);
+    cache->max_pages = SL__FONT_CACHE_DEFAULT_PAGES;
+
+    font.cache = cache;
+
+    /* --- Start with the fallback glyph only --- */
+
+    // NOTE: The fallback is added even if the font lacks '?', the
+    //       rasterizer then draws the missing glyph of the font.
+
+    if (!sl__font_build_lookup(&font) || append_dynamic_glyph(&font, '?', stbtt_FindGlyphIndex(&cache->info, '?')) < 0) {
+        sl_loge("FONT: Failed to load dynamic font; Out of memory");
+        SDL_free(font.kern_pairs);
+        SDL_free(font.glyph_map);
+        SDL_free(font.glyphs);
+        SDL_free(cache->file_data);
+        SDL_free(cache);
+        return 0;
+    }
+
+    return sl__registry_add(&sl__render.reg_fonts, &font);
+}
+
+sl_font_id sl_font_load_dynamic(const char* file_path, sl_font_type_t type, int base_size)
+{
+    size_t data_size = 0;
+    void* data = sl_file_load(file_path, &data_size);
+    if (data == NULL) {
+        return 0;
+    }
+
+    sl_font_id id = sl_font_load_dynamic_from_memory(data, data_size, type, base_size);
+    SDL_free(data);
+
+    return id;
+}
+
+void sl_font_set_cache_budget(sl_font_id font, size_t bytes)
+{
+    sl__font_t* data = sl__registry_get(&sl__render.reg_fonts, font);
+    if (data == NULL || data->cache == NULL) {
+        return;
+    }
+
+    sl__font_cache_t* cache = data->cache;
+
+    /* --- Convert the budget into a page count --- */
+
+    size_t page_bytes = (size_t)SL__FONT_CACHE_PAGE_SIZE * SL__FONT_CACHE_PAGE_SIZE * 2;
+    size_t max_pages = bytes / page_bytes;
+
+    cache->max_pages = (int)SL_CLAMP(max_pages, (size_t)1, (size_t)SL__FONT_CACHE_MAX_PAGES);
+
+    /* --- Release the least recently used pages over the budget --- */
+
+    if (cache->page_count > cache->max_pages) {
+        sl_render_flush();
+    }
+
+    while (cache->page_count > cache->max_pages) {
+        int lru = 0;
+        for (int i = 1; i < cache->page_count; i++) {
+            if (cache->pages[i].last_use < cache->pages[lru].last_use) {
+                lru = i;
+            }
+        }
+        remove_cache_page(data, lru);
+    }
+}
+
 void sl_font_destroy(sl_font_id font)
 {
-    /* --- Check and get the current font --- */
+    /* --- Check and get the font --- */
 
-    if (sl__render.current_font == 0) {
+    if (font == 0) {
         return;
     }
 
-    sl__font_t* data = sl__registry_get(&sl__render.reg_fonts, sl__render.current_font);
+    sl__font_t* data = sl__registry_get(&sl__render.reg_fonts, font);
     if (data == NULL) {
         return;
     }
 
+    if (sl__render.current_font == font) {
+        sl__render.current_font = 0;
+    }
+
     /* --- Release contained data --- */
 
     sl_texture_destroy(data->texture);
+    SDL_free(data->kern_pairs);
+    SDL_free(data->glyph_map);
     SDL_free(data->glyphs);
 
+    if (data->cache != NULL) {
+        for (int i = 0; i < data->cache->page_count; i++) {
+            sl_texture_destroy(data->cache->pages[i].texture);
+        }
+        SDL_free(data->cache->file_data);
+        SDL_free(data->cache);
+    }
+
     /* --- Remove font from the registry --- */
 
     sl__registry_remove(&sl__render.reg_fonts, font);
@@ -176,6 +411,48 @@ void sl_font_measure_codepoints(float* w, float* h, const sl_font_id font, const
     sl__font_measure_codepoints(w, h, data, codepoints, length, font_size, x_spacing, y_spacing);
 }
 
+/* === Font Cache Functions === */
+
+int sl__font_cache_add_glyph(sl__font_t* font, int codepoint)
+{
+    // NOTE: Codepoints missing from the font are mapped to the
+    //       fallback so they are not looked up in the file again.
+
+    int font_index = stbtt_FindGlyphIndex(&font->cache->info, codepoint);
+    if (font_index == 0) {
+        sl__font_lookup_insert(font, codepoint, font->fallback_index);
+        return font->fallback_index;
+    }
+
+    int index = append_dynamic_glyph(font, codepoint, font_index);
+
+    return (index < 0) ? font->fallback_index : index;
+}
+
+sl_texture_id sl__font_glyph_texture(sl__font_t* font, int index, bool* rasterized)
+{
+    *rasterized = false;
+
+    sl__font_cache_t* cache = font->cache;
+    if (cache == NULL) {
+        return font->texture;
+    }
+
+    sl__glyph_t* glyph = &font->glyphs[index];
+
+    if (glyph->page < 0) {
+        if (!cache_glyph(font, glyph)) {
+            return 0;
+        }
+        *rasterized = true;
+    }
+
+    sl__font_page_t* page = &cache->pages[glyph->page];
+    page->last_use = ++cache->clock;
+
+    return page->texture;
+}
+
 /* === Internal Functions === */
 
 bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_size, sl_font_type_t font_type,
@@ -183,13 +460,6 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
 {
     assert(atlas != NULL);
 
-    /* --- Constants --- */
-
-#   define FONT_SDF_CHAR_PADDING         4
-#   define FONT_SDF_ON_EDGE_VALUE        128
-#   define FONT_SDF_PIXEL_DIST_SCALE     32.0f
-#   define FONT_BITMAP_ALPHA_THRESHOLD   80
-
     *out_glyphs = NULL;
 
     /* --- Cleanup Variables --- */
@@ -198,6 +468,7 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
     int* default_codepoints = NULL;
     stbrp_context* pack_context = NULL;
     stbrp_node* pack_nodes = NULL;
+    sl__glyph_bitmap_t* bitmaps = NULL;
 
     /* --- Font Validation and Init --- */
 
@@ -258,47 +529,21 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
         glyphs[i].value = ch;
 
         int glyphIndex = stbtt_FindGlyphIndex(&font_info, ch);
+        glyphs[i].font_index = glyphIndex;
+
         if (glyphIndex == 0) {
             pack_rects[i].w = pack_rects[i].h = 0;
             continue;
         }
 
-        if (ch == 32) { // Space character
-            stbtt_GetCodepointHMetrics(&font_info, ch, &glyphs[i].x_advance, NULL);
-            glyphs[i].x_advance = (int)((float)glyphs[i].x_advance * scale);
-            glyphs[i].x_offset = glyphs[i].y_offset = 0;
-
-            pack_rects[i].w = glyphs[i].x_advance + 2 * padding;
-            pack_rects[i].h = base_size + 2 * padding;
-        }
-        else { // Regular character
-            int x0, y0, x1, y1;
-            stbtt_GetCodepointBitmapBox(&font_info, ch, scale, scale, &x0, &y0, &x1, &y1);
-
-            int w_glyph = x1 - x0;
-            int h_glyph = y1 - y0;
-
-            // Add SDF padding if needed
-            if (font_type == SL_FONT_SDF) {
-                w_glyph += 2 * FONT_SDF_CHAR_PADDING;
-                h_glyph += 2 * FONT_SDF_CHAR_PADDING;
-                glyphs[i].x_offset = x0 - FONT_SDF_CHAR_PADDING;
-                glyphs[i].y_offset = y0 - FONT_SDF_CHAR_PADDING + scaled_ascent;
-            }
-            else {
-                glyphs[i].x_offset = x0;
-                glyphs[i].y_offset = y0 + scaled_ascent;
-            }
-
-            pack_rects[i].w = w_glyph + 2 * padding;
-            pack_rects[i].h = h_glyph + 2 * padding;
+        int w_glyph, h_glyph;
+        compute_glyph_metrics(&font_info, scale, scaled_ascent, font_type, base_size, ch, &glyphs[i], &w_glyph, &h_glyph);
 
-            stbtt_GetCodepointHMetrics(&font_info, ch, &glyphs[i].x_advance, NULL);
-            glyphs[i].x_advance = (int)((float)glyphs[i].x_advance * scale);
+        pack_rects[i].w = w_glyph + 2 * padding;
+        pack_rects[i].h = h_glyph + 2 * padding;
 
-            if (h_glyph > max_h_glyph) {
-                max_h_glyph = h_glyph;
-            }
+        if (ch != 32 && h_glyph > max_h_glyph) {
+            max_h_glyph = h_glyph;
         }
 
         pack_rects[i].id = i;
@@ -330,6 +575,45 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
         atlas->h = atlas_size;
     }
 
+    /* --- Rectangle Packing --- */
+
+    // NOTE: The estimate above can be too small for unusual glyph sets,
+    //       the atlas grows until every glyph fits rather than dropping them.
+
+    pack_context = SDL_malloc(sizeof(*pack_context));
+    if (!pack_context) {
+        goto cleanup;
+    }
+
+    while (true)
+    {
+        stbrp_node* nodes = SDL_realloc(pack_nodes, atlas->w * sizeof(*pack_nodes));
+        if (!nodes) {
+            goto cleanup;
+        }
+        pack_nodes = nodes;
+
+        stbrp_init_target(pack_context, atlas->w, atlas->h, pack_nodes, atlas->w);
+        stbrp_pack_rects(pack_context, pack_rects, codepoint_count);
+
+        bool all_packed = true;
+        for (int i = 0; i < codepoint_count; i++) {
+            all_packed &= (pack_rects[i].was_packed != 0);
+        }
+
+        if (all_packed) {
+            break;
+        }
+
+        if (atlas->w >= FONT_ATLAS_MAX_SIZE && atlas->h >= FONT_ATLAS_MAX_SIZE) {
+            sl_logw("FONT: Some glyphs do not fit in a %ix%i atlas and will not be drawn", atlas->w, atlas->h);
+            break;
+        }
+
+        if (atlas->h < atlas->w) atlas->h *= 2;
+        else atlas->w *= 2;
+    }
+
     /* --- Create Atlas Image --- */
 
     atlas->pixels = SDL_calloc(atlas->w * atlas->h, 2);
@@ -338,19 +622,26 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
     }
     atlas->format = SL_PIXEL_FORMAT_LUMINANCE_ALPHA8;
 
-    /* --- Rectangle Packing Setup --- */
+    /* --- Second Pass: Rasterize Glyphs in Parallel --- */
 
-    pack_context = SDL_malloc(sizeof(*pack_context));
-    pack_nodes = SDL_malloc(atlas->w * sizeof(*pack_nodes));
-
-    if (!pack_context || !pack_nodes) {
+    bitmaps = SDL_calloc(codepoint_count, sizeof(sl__glyph_bitmap_t));
+    if (!bitmaps) {
         goto cleanup;
     }
 
-    stbrp_init_target(pack_context, atlas->w, atlas->h, pack_nodes, atlas->w);
-    stbrp_pack_rects(pack_context, pack_rects, codepoint_count);
+    sl__glyph_raster_job_t job = {
+        .font_info = &font_info,
+        .scale = scale,
+        .font_type = font_type,
+        .glyphs = glyphs,
+        .pack_rects = pack_rects,
+        .bitmaps = bitmaps,
+        .glyph_count = codepoint_count
+    };
 
-    /* --- Second Pass: Render Glyphs to Atlas --- */
+    rasterize_glyphs_parallel(&job);
+
+    /* --- Third Pass: Copy Glyphs to Atlas --- */
 
     for (int i = 0; i < codepoint_count; i++)
     {
@@ -370,36 +661,14 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
             continue;
         }
 
-        /* --- Generate Glyph Bitmap --- */
-
-        uint8_t* glyph_bitmap = NULL;
-        int w_glyph, h_glyph, x_offset, y_offset;
-
-        if (font_type == SL_FONT_SDF) {
-            glyph_bitmap = stbtt_GetCodepointSDF(
-                &font_info, scale, ch, FONT_SDF_CHAR_PADDING,
-                FONT_SDF_ON_EDGE_VALUE, FONT_SDF_PIXEL_DIST_SCALE,
-                &w_glyph, &h_glyph, &x_offset, &y_offset
-            );
-        }
-        else {
-            glyph_bitmap = stbtt_GetCodepointBitmap(
-                &font_info, scale, scale, ch,
-                &w_glyph, &h_glyph, &x_offset, &y_offset
-            );
-        }
+        uint8_t* glyph_bitmap = bitmaps[i].pixels;
+        int w_glyph = bitmaps[i].w;
+        int h_glyph = bitmaps[i].h;
 
         if (!glyph_bitmap) {
             continue;
         }
 
-        // Apply threshold for pixel fonts
-        if (font_type == SL_FONT_PIXEL) {
-            for (int p = 0; p < w_glyph * h_glyph; p++) {
-                glyph_bitmap[p] = (glyph_bitmap[p] < FONT_BITMAP_ALPHA_THRESHOLD) ? 0 : 255;
-            }
-        }
-
         // Copy glyph to atlas (line by line)
         uint8_t* atlasData = (uint8_t*)atlas->pixels;
         for (int y = 0; y < h_glyph; y++) {
@@ -413,6 +682,7 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
         }
 
         stbtt_FreeBitmap(glyph_bitmap, NULL);
+        bitmaps[i].pixels = NULL;
 
         glyphs[i].x_atlas = (float)x_dst;
         glyphs[i].y_atlas = (float)y_dst;
@@ -431,6 +701,7 @@ bool generate_font_atlas(sl_image_t* atlas, const uint8_t* file_data, int data_s
 
     /* --- Cleanup --- */
 
+    SDL_free(bitmaps);
     SDL_free(work_buffer);
     SDL_free(pack_nodes);
     SDL_free(pack_context);
@@ -442,6 +713,13 @@ cleanup:
 
     /* --- Error Cleanup --- */
 
+    if (bitmaps) {
+        for (int i = 0; i < codepoint_count; i++) {
+            stbtt_FreeBitmap(bitmaps[i].pixels, NULL);
+        }
+    }
+
+    SDL_free(bitmaps);
     SDL_free(atlas->pixels);
     SDL_free(work_buffer);
     SDL_free(pack_nodes);
@@ -454,3 +732,701 @@ cleanup:
 
     return false;
 }
+
+void compute_glyph_metrics(const stbtt_fontinfo* font_info, float scale, int scaled_ascent, sl_font_type_t font_type,
+                           int base_size, int ch, sl__glyph_t* glyph, int* w_glyph, int* h_glyph)
+{
+    if (ch == 32) { // Space character
+        stbtt_GetCodepointHMetrics(font_info, ch, &glyph->x_advance, NULL);
+        glyph->x_advance = (int)((float)glyph->x_advance * scale);
+        glyph->x_offset = glyph->y_offset = 0;
+
+        *w_glyph = glyph->x_advance;
+        *h_glyph = base_size;
+        return;
+    }
+
+    int x0, y0, x1, y1;
+    stbtt_GetCodepointBitmapBox(font_info, ch, scale, scale, &x0, &y0, &x1, &y1);
+
+    *w_glyph = x1 - x0;
+    *h_glyph = y1 - y0;
+
+    // Add SDF padding if needed
+    if (font_type == SL_FONT_SDF) {
+        *w_glyph += 2 * FONT_SDF_CHAR_PADDING;
+        *h_glyph += 2 * FONT_SDF_CHAR_PADDING;
+        glyph->x_offset = x0 - FONT_SDF_CHAR_PADDING;
+        glyph->y_offset = y0 - FONT_SDF_CHAR_PADDING + scaled_ascent;
+    }
+    else {
+        glyph->x_offset = x0;
+        glyph->y_offset = y0 + scaled_ascent;
+    }
+
+    stbtt_GetCodepointHMetrics(font_info, ch, &glyph->x_advance, NULL);
+    glyph->x_advance = (int)((float)glyph->x_advance * scale);
+}
+
+uint8_t* rasterize_glyph(const stbtt_fontinfo* font_info, float scale, sl_font_type_t font_type, int ch, int* w_glyph, int* h_glyph)
+{
+    uint8_t* glyph_bitmap = NULL;
+    int x_offset, y_offset;
+
+    if (font_type == SL_FONT_SDF) {
+        glyph_bitmap = stbtt_GetCodepointSDF(
+            font_info, scale, ch, FONT_SDF_CHAR_PADDING,
+            FONT_SDF_ON_EDGE_VALUE, FONT_SDF_PIXEL_DIST_SCALE,
+            w_glyph, h_glyph, &x_offset, &y_offset
+        );
+    }
+    else {
+        glyph_bitmap = stbtt_GetCodepointBitmap(
+            font_info, scale, scale, ch,
+            w_glyph, h_glyph, &x_offset, &y_offset
+        );
+    }
+
+    if (!glyph_bitmap) {
+        return NULL;
+    }
+
+    // Apply threshold for pixel fonts
+    if (font_type == SL_FONT_PIXEL) {
+        for (int p = 0; p < *w_glyph * *h_glyph; p++) {
+            glyph_bitmap[p] = (glyph_bitmap[p] < FONT_BITMAP_ALPHA_THRESHOLD) ? 0 : 255;
+        }
+    }
+
+    return glyph_bitmap;
+}
+
+static int rasterize_glyphs_worker(void* data)
+{
+    sl__glyph_raster_job_t* job = data;
+
+    // NOTE: The font info is only read by stb_truetype, each
+    //       glyph gets its own bitmap so no locking is needed.
+
+    while (true)
+    {
+        int i = SDL_AddAtomicInt(&job->next_glyph, 1);
+        if (i >= job->glyph_count) {
+            break;
+        }
+
+        if (!job->pack_rects[i].was_packed || job->glyphs[i].value == 32) {
+            continue;
+        }
+
+        sl__glyph_bitmap_t* bitmap = &job->bitmaps[i];
+        bitmap->pixels = rasterize_glyph(job->font_info, job->scale, job->font_type,
+                                         job->glyphs[i].value, &bitmap->w, &bitmap->h);
+    }
+
+    return 0;
+}
+
+void rasterize_glyphs_parallel(sl__glyph_raster_job_t* job)
+{
+    /* --- Choose the number of helper threads --- */
+
+    // NOTE: Small glyph sets are not worth a thread, and
+    //       the calling thread rasterizes glyphs as well.
+
+    int thread_count = SL_MIN(SDL_GetNumLogicalCPUCores() - 1, job->glyph_count / FONT_RASTER_GLYPHS_PER_THREAD);
+    thread_count = SL_CLAMP(thread_count, 0, FONT_RASTER_MAX_THREADS);
+
+    /* --- Rasterize the glyphs --- */
+
+    SDL_Thread* threads[FONT_RASTER_MAX_THREADS];
+    int started = 0;
+
+    SDL_SetAtomicInt(&job->next_glyph, 0);
+
+    for (int i = 0; i < thread_count; i++) {
+        threads[started] = SDL_CreateThread(rasterize_glyphs_worker, "sl_font_raster", job);
+        if (threads[started] == NULL) {
+            break;
+        }
+        started++;
+    }
+
+    rasterize_glyphs_worker(job);
+
+    for (int i = 0; i < started; i++) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+}
+
+int append_dynamic_glyph(sl__font_t* font, int codepoint, int font_index)
+{
+    sl__font_cache_t* cache = font->cache;
+
+    /* --- Grow the glyph array if needed --- */
+
+    if (font->glyph_count == font->glyph_capacity) {
+        int capacity = (font->glyph_capacity > 0) ? 2 * font->glyph_capacity : 128;
+        sl__glyph_t* glyphs = SDL_realloc(font->glyphs, capacity * sizeof(sl__glyph_t));
+        if (glyphs == NULL) {
+            return -1;
+        }
+        font->glyphs = glyphs;
+        font->glyph_capacity = capacity;
+    }
+
+    /* --- Compute the metrics, the bitmap waits for the first draw --- */
+
+    int index = font->glyph_count;
+    sl__glyph_t* glyph = &font->glyphs[index];
+
+    SDL_memset(glyph, 0, sizeof(*glyph));
+    glyph->value = codepoint;
+    glyph->page = -1;
+    glyph->font_index = font_index;
+
+    int w_glyph, h_glyph;
+    compute_glyph_metrics(&cache->info, cache->scale, cache->scaled_ascent, font->type,
+                          font->base_size, codepoint, glyph, &w_glyph, &h_glyph);
+
+    glyph->w_atlas = w_glyph;
+    glyph->h_atlas = h_glyph;
+
+    if (!sl__font_lookup_insert(font, codepoint, index)) {
+        return -1;
+    }
+
+    font->glyph_count++;
+
+    // Missing pairs only cost some spacing, the glyph stays usable
+    if (!add_dynamic_kerning(font, index)) {
+        sl_logw("FONT: Failed to store the kerning pairs of glyph %i; Out of memory", codepoint);
+    }
+
+    return index;
+}
+
+static bool pack_in_page(sl__font_page_t* page, int w, int h, int* x, int* y)
+{
+    int x_pen = page->x;
+    int y_pen = page->y;
+    int row_h = page->row_h;
+
+    // Open a new shelf when the current one is full
+    if (x_pen + w > SL__FONT_CACHE_PAGE_SIZE) {
+        x_pen = 0;
+        y_pen += row_h;
+        row_h = 0;
+    }
+
+    if (w > SL__FONT_CACHE_PAGE_SIZE || y_pen + h > SL__FONT_CACHE_PAGE_SIZE) {
+        return false;
+    }
+
+    *x = x_pen;
+    *y = y_pen;
+
+    page->x = x_pen + w;
+    page->y = y_pen;
+    page->row_h = SL_MAX(row_h, h);
+
+    return true;
+}
+
+static bool create_cache_page(sl__font_t* font, sl__font_page_t* page)
+{
+    // NOTE: Textures can't be created empty, the zeroed pixels
+    //       are only used for the initial upload of the page.
+
+    void* pixels = SDL_calloc(SL__FONT_CACHE_PAGE_SIZE * SL__FONT_CACHE_PAGE_SIZE, 2);
+    if (pixels == NULL) {
+        return false;
+    }
+
+    page->texture = sl_texture_create(pixels, SL__FONT_CACHE_PAGE_SIZE, SL__FONT_CACHE_PAGE_SIZE, SL_PIXEL_FORMAT_LUMINANCE_ALPHA8);
+    SDL_free(pixels);
+
+    if (page->texture == 0) {
+        return false;
+    }
+
+    sl_filter_mode_t filter = (font->type == SL_FONT_PIXEL) ? SL_FILTER_NEAREST : SL_FILTER_BILINEAR;
+    sl_texture_parameters(page->texture, filter, SL_WRAP_CLAMP);
+
+    page->last_use = 0;
+    page->x = page->y = page->row_h = 0;
+
+    return true;
+}
+
+static void reset_cache_page(sl__font_t* font, int page)
+{
+    // Glyphs of the page are rasterized again on their next draw
+    for (int i = 0; i < font->glyph_count; i++) {
+        if (font->glyphs[i].page == page) {
+            font->glyphs[i].page = -1;
+        }
+    }
+
+    sl__font_page_t* data = &font->cache->pages[page];
+    data->x = data->y = data->row_h = 0;
+}
+
+void remove_cache_page(sl__font_t* font, int page)
+{
+    sl__font_cache_t* cache = font->cache;
+
+    reset_cache_page(font, page);
+    sl_texture_destroy(cache->pages[page].texture);
+
+    /* --- Move the last page into the freed slot --- */
+
+    int last = --cache->page_count;
+
+    if (page != last) {
+        cache->pages[page] = cache->pages[last];
+        for (int i = 0; i < font->glyph_count; i++) {
+            if (font->glyphs[i].page == last) {
+                font->glyphs[i].page = page;
+            }
+        }
+    }
+}
+
+bool cache_glyph(sl__font_t* font, sl__glyph_t* glyph)
+{
+    sl__font_cache_t* cache = font->cache;
+
+    int padding = font->glyph_padding;
+    int w_rect = glyph->w_atlas + 2 * padding;
+    int h_rect = glyph->h_atlas + 2 * padding;
+
+    if (w_rect > SL__FONT_CACHE_PAGE_SIZE || h_rect > SL__FONT_CACHE_PAGE_SIZE) {
+        sl_logw("FONT: Glyph %i is too large for the glyph cache and will not be drawn", glyph->value);
+        return false;
+    }
+
+    /* --- Find a page with room for the glyph --- */
+
+    int page = -1;
+    int x_rect = 0, y_rect = 0;
+
+    for (int i = 0; i < cache->page_count; i++) {
+        if (pack_in_page(&cache->pages[i], w_rect, h_rect, &x_rect, &y_rect)) {
+            page = i;
+            break;
+        }
+    }
+
+    if (page < 0 && cache->page_count < cache->max_pages) {
+        if (create_cache_page(font, &cache->pages[cache->page_count])) {
+            page = cache->page_count++;
+            pack_in_page(&cache->pages[page], w_rect, h_rect, &x_rect, &y_rect);
+        }
+    }
+
+    /* --- Evict the least recently used page otherwise --- */
+
+    if (page < 0) {
+        if (cache->page_count == 0) {
+            sl_loge("FONT: Failed to create a glyph cache page");
+            return false;
+        }
+
+        page = 0;
+        for (int i = 1; i < cache->page_count; i++) {
+            if (cache->pages[i].last_use < cache->pages[page].last_use) {
+                page = i;
+            }
+        }
+
+        // NOTE: Pending draws may still sample the evicted glyphs
+        sl_render_flush();
+
+        reset_cache_page(font, page);
+        pack_in_page(&cache->pages[page], w_rect, h_rect, &x_rect, &y_rect);
+    }
+
+    /* --- Rasterize the glyph in a zeroed padded rect --- */
+
+    // NOTE: The padding is uploaded too, so the stale content
+    //       of an evicted page never bleeds into the glyph.
+
+    uint8_t* pixels = SDL_calloc((size_t)w_rect * h_rect, 2);
+    if (pixels == NULL) {
+        return false;
+    }
+
+    if (glyph->value != 32) {
+        int w_bitmap = 0, h_bitmap = 0;
+        uint8_t* glyph_bitmap = rasterize_glyph(&cache->info, cache->scale, font->type, glyph->value, &w_bitmap, &h_bitmap);
+
+        if (glyph_bitmap != NULL) {
+            // The bitmap box and the rasterized size should agree, clamped just in case
+            int w_copy = SL_MIN(w_bitmap, glyph->w_atlas);
+            int h_copy = SL_MIN(h_bitmap, glyph->h_atlas);
+            for (int y = 0; y < h_copy; y++) {
+                uint8_t* dst_line = &pixels[((y + padding) * w_rect + padding) * 2];
+                const uint8_t* src_line = &glyph_bitmap[y * w_bitmap];
+                for (int x = 0; x < w_copy; x++) {
+                    dst_line[x * 2 + 0] = src_line[x];
+                    dst_line[x * 2 + 1] = src_line[x];
+                }
+            }
+            stbtt_FreeBitmap(glyph_bitmap, NULL);
+        }
+    }
+
+    bool uploaded = sl_texture_update(
+        cache->pages[page].texture, x_rect, y_rect,
+        w_rect, h_rect, pixels, SL_PIXEL_FORMAT_LUMINANCE_ALPHA8
+    );
+
+    SDL_free(pixels);
+
+    if (!uploaded) {
+        return false;
+    }
+
+    glyph->x_atlas = x_rect + padding;
+    glyph->y_atlas = y_rect + padding;
+    glyph->page = page;
+
+    return true;
+}
+
+static bool build_kerning_table(sl__font_t* font, const uint8_t* file_data)
+{
+    stbtt_fontinfo font_info = { 0 };
+    if (!stbtt_InitFont(&font_info, file_data, 0)) {
+        return true;
+    }
+
+    if (!font_info.kern && !font_info.gpos) {
+        return true;
+    }
+
+    float scale = stbtt_ScaleForPixelHeight(&font_info, (float)font->base_size);
+
+    /* --- Map the font glyphs to our glyphs --- */
+
+    // NOTE: The map is indexed by the glyph id of the font,
+    //       the first glyph of a codepoint wins like the lookup.
+
+    int* font_to_glyph = SDL_malloc(font_info.numGlyphs * sizeof(int));
+    if (!font_to_glyph) {
+        return false;
+    }
+
+    for (int i = 0; i < font_info.numGlyphs; i++) {
+        font_to_glyph[i] = -1;
+    }
+
+    for (int i = 0; i < font->glyph_count; i++) {
+        int glyph = font->glyphs[i].font_index;
+        if (glyph > 0 && glyph < font_info.numGlyphs && font_to_glyph[glyph] < 0) {
+            font_to_glyph[glyph] = i;
+        }
+    }
+
+    bool success = true;
+
+    /* --- Read the pairs from the table used by the pair queries --- */
+
+    // NOTE: Like stbtt_GetGlyphKernAdvance(), GPOS takes precedence
+    //       over the kern table, so both kinds of fonts kern the same
+    //       whether they are loaded static or dynamic.
+
+    if (font_info.gpos) {
+        success = read_gpos_kerning(font, &font_info, font_to_glyph, scale);
+    }
+    else {
+        int length = stbtt_GetKerningTableLength(&font_info);
+        stbtt_kerningentry* table = SDL_malloc(SL_MAX(length, 1) * sizeof(stbtt_kerningentry));
+
+        if (table == NULL) {
+            success = false;
+        }
+        else {
+            length = stbtt_GetKerningTable(&font_info, table, length);
+            for (int k = 0; k < length && success; k++) {
+                int g1 = table[k].glyph1, g2 = table[k].glyph2;
+                if (g1 >= font_info.numGlyphs || g2 >= font_info.numGlyphs) continue;
+                if (font_to_glyph[g1] < 0 || font_to_glyph[g2] < 0) continue;
+                success = sl__font_kerning_insert(font, font_to_glyph[g1], font_to_glyph[g2], table[k].advance * scale);
+            }
+            SDL_free(table);
+        }
+    }
+
+    SDL_free(font_to_glyph);
+
+    return success;
+}
+
+static uint16_t gpos_u16(const uint8_t* p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static int gpos_coverage_index(const uint8_t* coverage, int glyph)
+{
+    // Binary search in the glyph list or in the glyph ranges, -1 if not covered
+
+    int format = gpos_u16(coverage);
+    int count = gpos_u16(coverage + 2);
+    int l = 0, r = count - 1;
+
+    while (l <= r) {
+        int m = (l + r) >> 1;
+        if (format == 1) {
+            int id = gpos_u16(coverage + 4 + 2 * m);
+            if (glyph < id) r = m - 1;
+            else if (glyph > id) l = m + 1;
+            else return m;
+        }
+        else if (format == 2) {
+            const uint8_t* range = coverage + 4 + 6 * m;
+            if (glyph < gpos_u16(range)) r = m - 1;
+            else if (glyph > gpos_u16(range + 2)) l = m + 1;
+            else return gpos_u16(range + 4) + glyph - gpos_u16(range);
+        }
+        else {
+            return -1;
+        }
+    }
+
+    return -1;
+}
+
+static int gpos_glyph_class(const uint8_t* class_def, int glyph)
+{
+    // Glyphs not assigned to a class are in class 0, -1 for unsupported definitions
+
+    int format = gpos_u16(class_def);
+
+    if (format == 1) {
+        int start = gpos_u16(class_def + 2);
+        int count = gpos_u16(class_def + 4);
+        if (glyph >= start && glyph < start + count) {
+            return gpos_u16(class_def + 6 + 2 * (glyph - start));
+        }
+        return 0;
+    }
+
+    if (format == 2) {
+        int l = 0, r = gpos_u16(class_def + 2) - 1;
+        while (l <= r) {
+            int m = (l + r) >> 1;
+            const uint8_t* range = class_def + 4 + 6 * m;
+            if (glyph < gpos_u16(range)) r = m - 1;
+            else if (glyph > gpos_u16(range + 2)) l = m + 1;
+            else return gpos_u16(range + 4);
+        }
+        return 0;
+    }
+
+    return -1;
+}
+
+static bool group_gpos_classes(sl__gpos_pairs_t* pairs, const sl__font_t* font, const stbtt_fontinfo* font_info, const int* font_to_glyph)
+{
+    // Sorts our glyphs by their right class in a format 2 subtable
+
+    int count = font->glyph_count;
+    int class2_count = gpos_u16(pairs->table + 14);
+    const uint8_t* class_def = pairs->table + gpos_u16(pairs->table + 10);
+
+    pairs->class_start = SDL_calloc(class2_count + 1, sizeof(int));
+    pairs->class_glyphs = SDL_malloc(SL_MAX(count, 1) * sizeof(int));
+    int* class_of = SDL_malloc(SL_MAX(count, 1) * sizeof(int));
+
+    if (!pairs->class_start || !pairs->class_glyphs || !class_of) {
+        SDL_free(class_of);
+        return false;
+    }
+
+    for (int j = 0; j < count; j++) {
+        int right = font->glyphs[j].font_index;
+        bool valid = (right > 0 && right < font_info->numGlyphs && font_to_glyph[right] == j);
+        int c = valid ? gpos_glyph_class(class_def, right) : -1;
+        class_of[j] = (c >= 0 && c < class2_count) ? c : -1;
+        if (class_of[j] >= 0) pairs->class_start[class_of[j] + 1]++;
+    }
+
+    for (int c = 0; c < class2_count; c++) {
+        pairs->class_start[c + 1] += pairs->class_start[c];
+    }
+
+    // Filling moves each start to the next class, they are shifted back after
+    for (int j = 0; j < count; j++) {
+        if (class_of[j] < 0) continue;
+        pairs->class_glyphs[pairs->class_start[class_of[j]]++] = j;
+    }
+
+    for (int c = class2_count; c > 0; c--) {
+        pairs->class_start[c] = pairs->class_start[c - 1];
+    }
+    pairs->class_start[0] = 0;
+
+    SDL_free(class_of);
+
+    return true;
+}
+
+static bool read_gpos_kerning(sl__font_t* font, const stbtt_fontinfo* font_info, const int* font_to_glyph, float scale)
+{
+    // NOTE: Enumerates the pair adjustment subtables instead of querying
+    //       every pair, so large glyph sets cost the pairs the font lists.
+    //       It reads what stbtt_GetGlyphKernAdvance() reads: for a left
+    //       glyph the subtables are tried in order, a format 1 subtable
+    //       decides the pairs it lists, zero ones included, and the first
+    //       other subtable covering the glyph decides the remaining ones.
+
+    const uint8_t* gpos = font_info->data + font_info->gpos;
+    if (gpos_u16(gpos) != 1 || gpos_u16(gpos + 2) != 0) {
+        return true;
+    }
+
+    /* --- Collect the pair adjustment subtables --- */
+
+    const uint8_t* lookup_list = gpos + gpos_u16(gpos + 8);
+    int lookup_count = gpos_u16(lookup_list);
+    int pairs_count = 0;
+
+    for (int l = 0; l < lookup_count; l++) {
+        const uint8_t* lookup = lookup_list + gpos_u16(lookup_list + 2 + 2 * l);
+        if (gpos_u16(lookup) == 2) pairs_count += gpos_u16(lookup + 4);
+    }
+
+    if (pairs_count == 0) {
+        return true;
+    }
+
+    int count = font->glyph_count;
+
+    sl__gpos_pairs_t* pairs = SDL_calloc(pairs_count, sizeof(sl__gpos_pairs_t));
+    int* decided = SDL_calloc(SL_MAX(count, 1), sizeof(int));  //< Left glyph index + 1 for the pairs already decided
+
+    if (!pairs || !decided) {
+        SDL_free(decided);
+        SDL_free(pairs);
+        return false;
+    }
+
+    for (int l = 0, k = 0; l < lookup_count; l++) {
+        const uint8_t* lookup = lookup_list + gpos_u16(lookup_list + 2 + 2 * l);
+        if (gpos_u16(lookup) != 2) continue;
+        for (int st = 0; st < gpos_u16(lookup + 4); st++) {
+            pairs[k++].table = lookup + gpos_u16(lookup + 6 + 2 * st);
+        }
+    }
+
+    /* --- Decide the pairs of each left glyph --- */
+
+    bool success = true;
+
+    for (int i = 0; i < count && success; i++)
+    {
+        int left = font->glyphs[i].font_index;
+        if (left <= 0 || left >= font_info->numGlyphs || font_to_glyph[left] != i) {
+            continue;
+        }
+
+        for (int p = 0; p < pairs_count && success; p++)
+        {
+            const uint8_t* table = pairs[p].table;
+            int format = gpos_u16(table);
+
+            int index = gpos_coverage_index(table + gpos_u16(table + 2), left);
+            if (index < 0) continue;
+
+            // Only the x advance of the left glyph is supported, like stb_truetype
+            bool supported = (gpos_u16(table + 4) == 4 && gpos_u16(table + 6) == 0);
+
+            /* --- Pairs listed one by one, later subtables can add others --- */
+
+            if (format == 1 && supported && index < gpos_u16(table + 8)) {
+                const uint8_t* pair_set = table + gpos_u16(table + 10 + 2 * index);
+                int pair_count = gpos_u16(pair_set);
+
+                for (int r = 0; r < pair_count && success; r++) {
+                    const uint8_t* record = pair_set + 2 + 4 * r;
+                    int right = gpos_u16(record);
+                    if (right >= font_info->numGlyphs || font_to_glyph[right] < 0) continue;
+                    int j = font_to_glyph[right];
+                    if (decided[j] == i + 1) continue;
+                    decided[j] = i + 1;
+                    success = sl__font_kerning_insert(font, i, j, (int16_t)gpos_u16(record + 2) * scale);
+                }
+
+                continue;
+            }
+
+            /* --- Pairs by class, this subtable decides all the others --- */
+
+            if (format == 2 && supported) {
+                int class1_count = gpos_u16(table + 12);
+                int class2_count = gpos_u16(table + 14);
+                int class1 = gpos_glyph_class(table + gpos_u16(table + 8), left);
+
+                if (class1 >= 0 && class1 < class1_count) {
+                    if (pairs[p].class_start == NULL && !group_gpos_classes(&pairs[p], font, font_info, font_to_glyph)) {
+                        success = false;
+                        break;
+                    }
+
+                    const uint8_t* row = table + 16 + 2 * class1 * class2_count;
+
+                    for (int c = 0; c < class2_count && success; c++) {
+                        int advance = (int16_t)gpos_u16(row + 2 * c);
+                        if (advance == 0) continue;
+                        for (int g = pairs[p].class_start[c]; g < pairs[p].class_start[c + 1] && success; g++) {
+                            int j = pairs[p].class_glyphs[g];
+                            if (decided[j] == i + 1) continue;
+                            success = sl__font_kerning_insert(font, i, j, advance * scale);
+                        }
+                    }
+                }
+            }
+
+            break;
+        }
+    }
+
+    for (int p = 0; p < pairs_count; p++) {
+        SDL_free(pairs[p].class_start);
+        SDL_free(pairs[p].class_glyphs);
+    }
+
+    SDL_free(decided);
+    SDL_free(pairs);
+
+    return success;
+}
+
+static bool add_dynamic_kerning(sl__font_t* font, int index)
+{
+    sl__font_cache_t* cache = font->cache;
+
+    if (!cache->info.kern && !cache->info.gpos) {
+        return true;
+    }
+
+    /* --- Query the pairs between the new glyph and the known ones --- */
+
+    // NOTE: Each glyph is only added once, so the pairs of
+    //       the glyph set are still computed a single time.
+
+    int glyph = font->glyphs[index].font_index;
+
+    for (int i = 0; i <= index; i++) {
+        int other = font->glyphs[i].font_index;
+        float before = stbtt_GetGlyphKernAdvance(&cache->info, other, glyph) * cache->scale;
+        float after = stbtt_GetGlyphKernAdvance(&cache->info, glyph, other) * cache->scale;
+        if (!sl__font_kerning_insert(font, i, index, before)) return false;
+        if (!sl__font_kerning_insert(font, index, i, after)) return false;
+    }
+
+    return true;
+}
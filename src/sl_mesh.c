@@ -21,12 +21,48 @@
 
 #include "./internal/sl__render.h"
 
+#include <stddef.h>
+
 /* === Public API === */
 
 sl_mesh_id sl_mesh_create(const sl_vertex_3d_t* vertices, uint16_t v_count, const uint16_t* indices, uint32_t i_count)
 {
     sl__mesh_t mesh = { 0 };
 
+#ifdef SL_BACKEND_SOFTWARE
+
+    // NOTE: The rasterizer reads the mesh from memory,
+    //       so the data is simply kept in copies.
+
+    mesh.vertices = SDL_malloc(v_count * sizeof(sl_vertex_3d_t));
+    if (mesh.vertices == NULL) {
+        sl_loge("MESH: Failed to create mesh; Out of memory");
+        return 0;
+    }
+
+    SDL_memcpy(mesh.vertices, vertices, v_count * sizeof(sl_vertex_3d_t));
+    mesh.vertex_count = v_count;
+
+    if (indices != NULL && i_count > 0) {
+        mesh.indices = SDL_malloc(i_count * sizeof(uint16_t));
+        if (mesh.indices == NULL) {
+            sl_loge("MESH: Failed to create mesh; Out of memory");
+            SDL_free(mesh.vertices);
+            return 0;
+        }
+        SDL_memcpy(mesh.indices, indices, i_count * sizeof(uint16_t));
+        mesh.index_count = i_count;
+    }
+
+    return sl__registry_add(&sl__render.reg_meshes, &mesh);
+
+#else
+
+#ifdef SL_BACKEND_GL33
+    glGenVertexArrays(1, &mesh.vao);
+    glBindVertexArray(mesh.vao);
+#endif
+
     glGenBuffers(1, &mesh.vbo);
     glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
     glBufferData(GL_ARRAY_BUFFER, v_count * sizeof(sl_vertex_3d_t), vertices, GL_DYNAMIC_DRAW);
@@ -37,7 +73,27 @@ sl_mesh_id sl_mesh_create(const sl_vertex_3d_t* vertices, uint16_t v_count, cons
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, i_count * sizeof(uint16_t), indices, GL_DYNAMIC_DRAW);
     }
 
+#ifdef SL_BACKEND_GL33
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, position));
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, texcoord));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, normal));
+    glEnableVertexAttribArray(2);
+
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, color));
+    glEnableVertexAttribArray(3);
+
+    glBindVertexArray(0);
+
+#endif
+
     return sl__registry_add(&sl__render.reg_meshes, &mesh);
+
+#endif // SL_BACKEND_SOFTWARE
 }
 
 void sl_mesh_destroy(sl_mesh_id mesh)
@@ -49,10 +105,19 @@ void sl_mesh_destroy(sl_mesh_id mesh)
     sl__mesh_t* data = sl__registry_get(&sl__render.reg_meshes, mesh);
     if (data == NULL) return;
 
+#ifdef SL_BACKEND_SOFTWARE
+    SDL_free(data->vertices);
+    SDL_free(data->indices);
+#else
     glDeleteBuffers(1, &data->vbo);
     if (data->ebo > 0) {
         glDeleteBuffers(1, &data->ebo);
     }
+#endif
+
+#ifdef SL_BACKEND_GL33
+    glDeleteVertexArrays(1, &data->vao);
+#endif
 
     sl__registry_remove(&sl__render.reg_meshes, mesh);
 }
@@ -66,12 +131,18 @@ void sl_mesh_update_vertices(sl_mesh_id mesh, const sl_vertex_3d_t* vertices, ui
     sl__mesh_t* data = sl__registry_get(&sl__render.reg_meshes, mesh);
     if (data == NULL) return;
 
+#ifdef SL_BACKEND_SOFTWARE
+    // Like glBufferSubData(), the update can't grow the mesh
+    count = SL_MIN(count, data->vertex_count);
+    SDL_memcpy(data->vertices, vertices, count * sizeof(sl_vertex_3d_t));
+#else
     glBindBuffer(GL_ARRAY_BUFFER, data->vbo);
     glBufferSubData(
         GL_ARRAY_BUFFER, 0, 
         count * sizeof(sl_vertex_3d_t), 
         vertices
     );
+#endif
 }
 
 void sl_mesh_update_indices(sl_mesh_id mesh, const uint16_t* indices, uint32_t count)
@@ -83,6 +154,26 @@ void sl_mesh_update_indices(sl_mesh_id mesh, const uint16_t* indices, uint32_t c
     sl__mesh_t* data = sl__registry_get(&sl__render.reg_meshes, mesh);
     if (data == NULL) return;
 
+#ifdef SL_BACKEND_SOFTWARE
+
+    if (data->indices == NULL) {
+        data->indices = SDL_malloc(count * sizeof(uint16_t));
+        if (data->indices == NULL) return;
+        data->index_count = count;
+    }
+    else {
+        count = SL_MIN(count, (uint32_t)data->index_count);
+    }
+
+    SDL_memcpy(data->indices, indices, count * sizeof(uint16_t));
+
+#else
+
+#ifdef SL_BACKEND_GL33
+    // The element buffer binding is stored in the mesh VAO
+    glBindVertexArray(data->vao);
+#endif
+
     if (data->ebo == 0) {
         glGenBuffers(1, &data->ebo);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data->ebo);
@@ -96,4 +187,6 @@ void sl_mesh_update_indices(sl_mesh_id mesh, const uint16_t* indices, uint32_t c
             indices
         );
     }
+
+#endif // SL_BACKEND_SOFTWARE
 }
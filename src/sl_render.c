@@ -31,6 +31,49 @@
 #include "./internal/sl__registry.h"
 #include "./internal/sl__render.h"
 #include "./internal/sl__core.h"
+#include "./internal/sl__simd.h"
+
+#ifdef SL_BACKEND_SOFTWARE
+    #include "./internal/sl__raster.h"
+#endif
+
+/* === SIMD Helpers === */
+
+// NOTE: Used by the bulk shape functions, each lane holds
+//       one shape so the tessellation runs four at a time.
+
+static inline void sl__f4_sincos(sl__f4 x, sl__f4* s, sl__f4* c)
+{
+    // Cephes style: reduce to [-pi/4, pi/4] around the nearest
+    // multiple of pi/2 then pick the polynomials per quadrant
+
+    sl__i4 q;
+    sl__f4 j = sl__f4_round(sl__f4_mul(x, sl__f4_set1(0.63661977236f)), &q);
+
+    sl__f4 r = sl__f4_fma(j, sl__f4_set1(-1.5703125f), x);
+    r = sl__f4_fma(j, sl__f4_set1(-4.837512969970703125e-4f), r);
+    r = sl__f4_fma(j, sl__f4_set1(-7.54978995489188216e-8f), r);
+
+    sl__f4 r2 = sl__f4_mul(r, r);
+
+    sl__f4 ps = sl__f4_fma(r2, sl__f4_set1(-1.9515295891e-4f), sl__f4_set1(8.3321608736e-3f));
+    ps = sl__f4_fma(ps, r2, sl__f4_set1(-1.6666654611e-1f));
+    ps = sl__f4_fma(sl__f4_mul(ps, r2), r, r);
+
+    sl__f4 pc = sl__f4_fma(r2, sl__f4_set1(2.443315711809948e-5f), sl__f4_set1(-1.388731625493765e-3f));
+    pc = sl__f4_fma(pc, r2, sl__f4_set1(4.166664568298827e-2f));
+    pc = sl__f4_fma(sl__f4_mul(pc, r2), r2, sl__f4_fma(r2, sl__f4_set1(-0.5f), sl__f4_set1(1.0f)));
+
+    sl__f4 zero = sl__f4_set1(0.0f);
+
+    // Odd quadrants swap the functions, the sign of sin flips for
+    // quadrants 2-3 and the sign of cos for quadrants 1-2
+    sl__f4 sin_r = sl__i4_select_bit(q, 1, pc, ps);
+    sl__f4 cos_r = sl__i4_select_bit(q, 1, ps, pc);
+
+    *s = sl__i4_select_bit(q, 2, sl__f4_sub(zero, sin_r), sin_r);
+    *c = sl__i4_select_bit(sl__i4_add1(q), 2, sl__f4_sub(zero, cos_r), cos_r);
+}
 
 /* === Internal Functions === */
 
@@ -41,6 +84,31 @@ static inline void sl__render_get_current_state(sl__render_state_t* state)
     state->blend_mode = sl__render.current_blend_mode;
 }
 
+#ifdef SL_BACKEND_SOFTWARE
+
+static sl__texture_t* sl__render_raster_target(void)
+{
+    if (sl__render.current_canvas != 0) {
+        const sl__canvas_t* canvas = sl__registry_get(&sl__render.reg_canvases, sl__render.current_canvas);
+        sl__texture_t* color = (canvas != NULL) ? sl__registry_get(&sl__render.reg_textures, canvas->color) : NULL;
+        if (color != NULL) return color;
+    }
+
+    return &sl__raster.backbuffer;
+}
+
+static const sl__texture_t* sl__render_raster_texture(sl_texture_id reg_id)
+{
+    sl__texture_t* texture = sl__registry_get(&sl__render.reg_textures, reg_id);
+    if (texture == NULL) {
+        texture = sl__registry_get(&sl__render.reg_textures, sl__render.default_texture);
+    }
+
+    return texture;
+}
+
+#else
+
 static inline void sl__render_use_shader(sl_shader_id reg_id, const sl_mat4_t* mvp)
 {
     sl__shader_t* shader = sl__registry_get(&sl__render.reg_shaders, reg_id);
@@ -49,8 +117,55 @@ static inline void sl__render_use_shader(sl_shader_id reg_id, const sl_mat4_t* m
     }
 
     glUseProgram(shader->id);
+
+#ifdef SL_BACKEND_GL33
+    (void)mvp; //< Shared by all programs through the matrices uniform block
+#else
     glUniformMatrix4fv(shader->loc_mvp, 1, GL_FALSE, mvp->a);
+    glUniform4fv(shader->loc_transforms, sl__render.transform_palette_count * 2, sl__render.transform_palette[0]);
+#endif
+
+    if (reg_id == sl__render.sdf_shader) {
+        sl_color_t outline = sl__render.text_outline_color;
+        sl_color_t shadow = sl__render.text_shadow_color;
+        glUniform1f(sl__render.loc_sdf_outline_width, sl__render.text_outline_width);
+        glUniform4f(sl__render.loc_sdf_outline_color, outline.r / 255.0f, outline.g / 255.0f, outline.b / 255.0f, outline.a / 255.0f);
+        glUniform2f(sl__render.loc_sdf_shadow_offset, sl__render.text_shadow_offset.x, sl__render.text_shadow_offset.y);
+        glUniform4f(sl__render.loc_sdf_shadow_color, shadow.r / 255.0f, shadow.g / 255.0f, shadow.b / 255.0f, shadow.a / 255.0f);
+    }
+}
+
+#ifdef SL_BACKEND_GL33
+static inline void sl__render_upload_mvp(const sl_mat4_t* mvp)
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, sl__render.ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(sl_mat4_t), mvp->a);
+}
+
+static inline void sl__render_upload_palette(void)
+{
+    // The identity entry is already in place, only the batch entries are sent
+    glBindBuffer(GL_UNIFORM_BUFFER, sl__render.ubo);
+    glBufferSubData(
+        GL_UNIFORM_BUFFER, sizeof(sl_mat4_t) + sizeof(sl__render.transform_palette[0]),
+        (sl__render.transform_palette_count - 1) * sizeof(sl__render.transform_palette[0]),
+        sl__render.transform_palette[1]
+    );
+}
+
+static inline void sl__render_upload_buffer(GLenum target, const void* data, size_t size)
+{
+    // Invalidating the whole buffer lets the driver hand out fresh storage
+    // instead of waiting for the previous draws still reading from it
+    void* dst = glMapBufferRange(target, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (dst == NULL) {
+        glBufferSubData(target, 0, size, data);
+        return;
+    }
+    SDL_memcpy(dst, data, size);
+    glUnmapBuffer(target);
 }
+#endif
 
 static inline void sl__render_bind_texture(uint32_t slot, sl_texture_id reg_id)
 {
@@ -91,6 +206,113 @@ static inline void sl__render_set_blend_mode(sl_blend_mode_t blend_mode)
     }
 }
 
+static inline void sl__render_depth_range(float near, float far)
+{
+#ifdef SL_BACKEND_GL33
+    glDepthRange(near, far);
+#else
+    glDepthRangef(near, far);
+#endif
+}
+
+static inline void sl__render_execute_call(const sl__draw_call_t* call, const sl__render_state_t** current_state, const sl_mat4_t* mvp)
+{
+    const sl__render_state_t* previous = *current_state;
+
+    if (previous == NULL || previous->shader != call->state.shader) {
+        sl__render_use_shader(call->state.shader, mvp);
+    }
+    if (previous == NULL || previous->texture != call->state.texture) {
+        sl__render_bind_texture(0, call->state.texture);
+    }
+    if (previous == NULL || previous->blend_mode != call->state.blend_mode) {
+        sl__render_set_blend_mode(call->state.blend_mode);
+    }
+
+    *current_state = &call->state;
+
+    glDrawElements(
+        GL_TRIANGLES, call->index_count, GL_UNSIGNED_SHORT, 
+        (void*)(call->index_start * sizeof(GLushort))
+    );
+}
+
+static bool sl__render_can_sort_opaque(void)
+{
+    if (!sl__render.opaque_sorting) {
+        return false;
+    }
+
+    // The window always has a depth buffer, canvases only if requested
+    if (sl__render.current_canvas != 0) {
+        const sl__canvas_t* canvas = sl__registry_get(&sl__render.reg_canvases, sl__render.current_canvas);
+        if (canvas == NULL || canvas->depth == 0) return false;
+    }
+
+    // Sorting only pays off when an opaque layer can hide another one
+    int opaque_count = 0;
+    for (int i = 0; i < sl__render.draw_call_count; i++) {
+        if (sl__render.draw_calls[i].state.blend_mode == SL_BLEND_OPAQUE) {
+            if (++opaque_count >= 2) return true;
+        }
+    }
+
+    return false;
+}
+
+static void sl__render_execute_sorted(const sl_mat4_t* mvp)
+{
+    // NOTE: Each draw call is a layer drawn at its own depth, later
+    //       layers being closer. Opaque layers are drawn front to back
+    //       with depth writes so early-z rejects the pixels they hide,
+    //       the others are then drawn back to front with only the test.
+    //       Layers compare with LEQUAL so that draws within a layer keep
+    //       their submission order.
+
+#   define LAYER_DEPTH(i) (1.0f - (float)((i) + 1) / (float)(SL__MAX_DRAW_CALLS + 1))
+
+    const sl__render_state_t* current_state = NULL;
+
+    glDepthMask(GL_TRUE);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LEQUAL);
+
+    /* --- Opaque layers, front to back --- */
+
+    for (int i = sl__render.draw_call_count - 1; i >= 0; i--) {
+        const sl__draw_call_t* call = &sl__render.draw_calls[i];
+        if (call->state.blend_mode != SL_BLEND_OPAQUE) continue;
+        sl__render_depth_range(LAYER_DEPTH(i), LAYER_DEPTH(i));
+        sl__render_execute_call(call, &current_state, mvp);
+    }
+
+    /* --- Translucent layers, back to front --- */
+
+    glDepthMask(GL_FALSE);
+
+    for (int i = 0; i < sl__render.draw_call_count; i++) {
+        const sl__draw_call_t* call = &sl__render.draw_calls[i];
+        if (call->state.blend_mode == SL_BLEND_OPAQUE) continue;
+        sl__render_depth_range(LAYER_DEPTH(i), LAYER_DEPTH(i));
+        sl__render_execute_call(call, &current_state, mvp);
+    }
+
+    /* --- Restore the user depth state --- */
+
+    glDepthFunc(GL_LESS);
+    glDepthMask(sl__render.depth_write);
+    sl__render_depth_range(sl__render.depth_near, sl__render.depth_far);
+
+    if (!sl__render.depth_test) {
+        glDisable(GL_DEPTH_TEST);
+    }
+
+#   undef LAYER_DEPTH
+}
+
+#endif // SL_BACKEND_SOFTWARE
+
 static void sl__render_commit_current_data(void)
 {
     if (!sl__render.has_pending_data || sl__render.vertex_count == 0) {
@@ -128,8 +350,58 @@ static void sl__render_flush_all(void)
         return;
     }
 
+#ifndef SL_BACKEND_SOFTWARE
+    bool use_palette = (sl__render.transform_palette_count > 1);
+#endif
+
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Rasterize all draw calls --- */
+
+    // NOTE: Vertices are projected once, the draw calls
+    //       then only differ by their indices and state.
+
+    sl_mat4_t mvp = sl_mat4_mul(&sl__render.matrix_view, &sl__render.matrix_proj);
+
+    sl__raster_begin(sl__render_raster_target());
+    sl__raster_vertices_2d(sl__render.vertex_buffer, sl__render.vertex_count, &mvp);
+
+    for (int i = 0; i < sl__render.draw_call_count; i++) {
+        const sl__draw_call_t* call = &sl__render.draw_calls[i];
+        sl__raster_draw(
+            sl__render.index_buffer + call->index_start, call->index_count,
+            sl__render_raster_texture(call->state.texture), call->state.blend_mode, false
+        );
+    }
+
+    sl__raster_end();
+
+#else
+
     /* --- Upload data --- */
 
+#ifdef SL_BACKEND_GL33
+
+    // NOTE: The batch VAO already holds the vertex layout and the element buffer
+
+    glBindVertexArray(sl__render.vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, sl__render.vbo);
+    sl__render_upload_buffer(GL_ARRAY_BUFFER, sl__render.vertex_buffer, sl__render.vertex_count * sizeof(sl_vertex_2d_t));
+    sl__render_upload_buffer(GL_ELEMENT_ARRAY_BUFFER, sl__render.index_buffer, sl__render.index_count * sizeof(GLushort));
+
+    if (use_palette) {
+        glBindBuffer(GL_ARRAY_BUFFER, sl__render.vbo_transform);
+        sl__render_upload_buffer(GL_ARRAY_BUFFER, sl__render.transform_index_buffer, sl__render.vertex_count);
+        glEnableVertexAttribArray(4);
+        sl__render_upload_palette();
+    }
+    else {
+        glDisableVertexAttribArray(4);
+    }
+
+#else
+
     glBindBuffer(GL_ARRAY_BUFFER, sl__render.vbo);
     glBufferSubData(
         GL_ARRAY_BUFFER, 0, 
@@ -155,42 +427,43 @@ static void sl__render_flush_all(void)
     glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sl_vertex_2d_t), (void*)offsetof(sl_vertex_2d_t, color));
     glEnableVertexAttribArray(3);
 
+    if (use_palette) {
+        glBindBuffer(GL_ARRAY_BUFFER, sl__render.vbo_transform);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sl__render.vertex_count, sl__render.transform_index_buffer);
+        glVertexAttribPointer(4, 1, GL_UNSIGNED_BYTE, GL_FALSE, 0, NULL);
+        glEnableVertexAttribArray(4);
+    }
+
+#endif
+
     /* --- Calculation of the projection view matrix --- */
 
     sl_mat4_t mvp = sl_mat4_mul(&sl__render.matrix_view, &sl__render.matrix_proj);
 
-    /* --- Execute all draw calls --- */
-
-    sl__render_state_t* current_state = NULL;
+#ifdef SL_BACKEND_GL33
+    sl__render_upload_mvp(&mvp);
+#endif
 
-    for (int i = 0; i < sl__render.draw_call_count; i++)
-    {
-        sl__draw_call_t* call = &sl__render.draw_calls[i];
+    /* --- Execute all draw calls --- */
 
-        if (current_state == NULL) {
-            sl__render_use_shader(call->state.shader, &mvp);
-            sl__render_bind_texture(0, call->state.texture);
-            sl__render_set_blend_mode(call->state.blend_mode);
-        }
-        else {
-            if (current_state->shader != call->state.shader) {
-                sl__render_use_shader(call->state.shader, &mvp);
-            }
-            if (current_state->texture != call->state.texture) {
-                sl__render_bind_texture(0, call->state.texture);
-            }
-            if (current_state->blend_mode != call->state.blend_mode) {
-                sl__render_set_blend_mode(call->state.blend_mode);
-            }
+    if (sl__render_can_sort_opaque()) {
+        sl__render_execute_sorted(&mvp);
+    }
+    else {
+        const sl__render_state_t* current_state = NULL;
+        for (int i = 0; i < sl__render.draw_call_count; i++) {
+            sl__render_execute_call(&sl__render.draw_calls[i], &current_state, &mvp);
         }
+    }
 
-        current_state = &call->state;
-
-        glDrawElements(
-            GL_TRIANGLES, call->index_count, GL_UNSIGNED_SHORT, 
-            (void*)(call->index_start * sizeof(GLushort))
-        );
+#ifndef SL_BACKEND_GL33
+    // Meshes do not provide palette indices and must read the identity
+    if (use_palette) {
+        glDisableVertexAttribArray(4);
     }
+#endif
+
+#endif // SL_BACKEND_SOFTWARE
 
     /* --- Reset for the next frame --- */
 
@@ -198,6 +471,9 @@ static void sl__render_flush_all(void)
     sl__render.index_count = 0;
     sl__render.draw_call_count = 0;
     sl__render.has_pending_data = false;
+
+    sl__render.transform_palette_count = 1;
+    sl__render.transform_palette_slot = -1;
 }
 
 static void sl__render_check_state_change(void)
@@ -218,6 +494,40 @@ static void sl__render_check_state_change(void)
     }
 }
 
+static inline bool sl__render_needs_palette_slot(void)
+{
+    return sl__render.gpu_transform && !sl__render.transform_is_identity && sl__render.transform_palette_slot < 0;
+}
+
+static void sl__render_store_palette_slot(void)
+{
+    // NOTE: Stores the current transform as a 2D affine, the same
+    //       part of the matrix that sl_vec2_transform uses on the CPU.
+
+    SDL_assert(sl__render.transform_palette_count < SL__TRANSFORM_PALETTE_SIZE);
+
+    const sl_mat4_t* m = &sl__render.matrix_transform;
+    float* entry = sl__render.transform_palette[sl__render.transform_palette_count];
+
+    entry[0] = m->m00; entry[1] = m->m10; entry[2] = m->m30; entry[3] = 0.0f;
+    entry[4] = m->m01; entry[5] = m->m11; entry[6] = m->m31; entry[7] = 0.0f;
+
+    sl__render.transform_palette_slot = sl__render.transform_palette_count++;
+}
+
+static void sl__render_check_palette(void)
+{
+    if (!sl__render_needs_palette_slot()) {
+        return;
+    }
+
+    if (sl__render.transform_palette_count >= SL__TRANSFORM_PALETTE_SIZE) {
+        sl__render_flush_all();
+    }
+
+    sl__render_store_palette_slot();
+}
+
 static void sl__render_check_space(int vertices_needed, int indices_needed)
 {
     // Check if there is enough space in the buffers
@@ -226,6 +536,28 @@ static void sl__render_check_space(int vertices_needed, int indices_needed)
         sl__render.draw_call_count >= SL__MAX_DRAW_CALLS) {
         sl__render_flush_all();
     }
+
+    sl__render_check_palette();
+}
+
+static int sl__render_reserve_items(int count, int vertices_per_item, int indices_per_item)
+{
+    // NOTE: Returns how many items can be written straight into the
+    //       buffers, the space and the state are checked once for all.
+
+    int n = SL_MIN((SL__VERTEX_BUFFER_SIZE - sl__render.vertex_count) / vertices_per_item,
+                   (SL__INDEX_BUFFER_SIZE - sl__render.index_count) / indices_per_item);
+
+    if (n <= 0 || sl__render.draw_call_count >= SL__MAX_DRAW_CALLS) {
+        sl__render_flush_all();
+        n = SL_MIN(SL__VERTEX_BUFFER_SIZE / vertices_per_item,
+                   SL__INDEX_BUFFER_SIZE / indices_per_item);
+    }
+
+    sl__render_check_palette();
+    sl__render_check_state_change();
+
+    return SL_MIN(n, count);
 }
 
 static inline void sl__render_add_vertex(const sl_vertex_2d_t* v)
@@ -237,14 +569,22 @@ static inline void sl__render_add_vertex(const sl_vertex_2d_t* v)
     vertex->texcoord = v->texcoord;
     vertex->color = v->color;
 
+    uint8_t transform_index = 0;
+
     if (!sl__render.transform_is_identity) {
-        vertex->position = sl_vec2_transform(vertex->position, &sl__render.matrix_transform);
+        if (sl__render.transform_palette_slot >= 0) {
+            transform_index = (uint8_t)sl__render.transform_palette_slot;
+        }
+        else {
+            vertex->position = sl_vec2_transform(vertex->position, &sl__render.matrix_transform);
+        }
     }
 
     if (!sl__render.texture_is_identity) {
         vertex->texcoord = sl_vec2_transform(vertex->texcoord, &sl__render.matrix_texture);
     }
 
+    sl__render.transform_index_buffer[sl__render.vertex_count] = transform_index;
     sl__render.vertex_count++;
 }
 
@@ -265,83 +605,202 @@ static inline void sl__render_add_index(GLushort index)
     sl__render.index_buffer[sl__render.index_count++] = index;
 }
 
-static void sl__render_codepoint(const sl__font_t* font, int codepoint, float x, float y, float font_size)
+typedef struct {
+    sl__font_t* font;
+    float scale;                        ///< Font size over the base size of the font
+    float u_scale, v_scale;             ///< Inverse size of the atlas
+    int reserved;                       ///< Glyph quads that can still be written without checks
+    bool clipped;                       ///< Cut the glyph quads to the clip rect
+    float clip_x0, clip_y0;
+    float clip_x1, clip_y1;
+    sl_texture_id previous_texture;
+    sl_shader_id previous_shader;
+    sl_blend_mode_t previous_blend;
+} sl__text_run_t;
+
+static bool sl__render_text_begin(sl__text_run_t* run, sl__font_t* font, float font_size)
 {
-    /* --- Get the character index position and it's data --- */
+    // NOTE: Everything that is the same for all glyphs of a string
+    //       is resolved once here, including the pipeline state.
+    //       Dynamic fonts pick the texture of each glyph's page.
 
-    const sl__glyph_t* glyph = sl__glyph_info(font, codepoint);
+    int w_atlas = SL__FONT_CACHE_PAGE_SIZE;
+    int h_atlas = SL__FONT_CACHE_PAGE_SIZE;
 
-    /* --- Calculate the scale factor based on font size --- */
+    if (font->cache == NULL && !sl_texture_query(font->texture, &w_atlas, &h_atlas)) {
+        return false;
+    }
 
-    float scale = font_size / font->base_size;
+    run->font = font;
+    run->scale = font_size / font->base_size;
+    run->u_scale = 1.0f / w_atlas;
+    run->v_scale = 1.0f / h_atlas;
+    run->reserved = 0;
+    run->clipped = false;
 
-    /* --- Set temporary pipeline state --- */
+    run->previous_texture = sl__render.current_texture;
+    run->previous_shader = sl__render.current_shader;
+    run->previous_blend = sl__render.current_blend_mode;
 
-    unsigned int previous_texture = sl__render.current_texture;
-    sl_blend_mode_t previous_blend = sl__render.current_blend_mode;
+    if (font->cache == NULL) {
+        sl__render.current_texture = font->texture;
+    }
+
+    // NOTE: SDF fonts use the built-in shader unless a custom one is set
+    if (font->type == SL_FONT_SDF && sl__render.sdf_shader != 0 &&
+        sl__render.current_shader == sl__render.default_shader) {
+        sl__render.current_shader = sl__render.sdf_shader;
+    }
 
-    sl__render.current_texture = font->texture;
     sl__render.current_blend_mode = SL_BLEND_PREMUL;
 
-    /* --- Calculate the padded source rect of the glyph --- */
+    return true;
+}
+
+static void sl__render_text_end(sl__text_run_t* run)
+{
+    sl__render.current_texture = run->previous_texture;
+    sl__render.current_shader = run->previous_shader;
+    sl__render.current_blend_mode = run->previous_blend;
+}
+
+static void sl__render_text_glyph(sl__text_run_t* run, int glyph_index, float x, float y, int glyphs_left)
+{
+    sl__font_t* font = run->font;
+    const sl__glyph_t* glyph = &font->glyphs[glyph_index];
+
+    /* --- Calculate the destination of the character with scaling --- */
 
-    float x_glyph = (float)(glyph->x_atlas - font->glyph_padding);
-    float y_glyph = (float)(glyph->y_atlas - font->glyph_padding);
     float w_glyph = (float)(glyph->w_atlas + 2 * font->glyph_padding);
     float h_glyph = (float)(glyph->h_atlas + 2 * font->glyph_padding);
 
-    /* --- Calculate the destination of the character with scaling --- */
+    float x_dst = x + (glyph->x_offset - font->glyph_padding) * run->scale;
+    float y_dst = y + (glyph->y_offset - font->glyph_padding) * run->scale;
+    float w_dst = w_glyph * run->scale;
+    float h_dst = h_glyph * run->scale;
 
-    float x_dst = x + (glyph->x_offset - font->glyph_padding) * scale;
-    float y_dst = y + (glyph->y_offset - font->glyph_padding) * scale;
-    float w_dst = w_glyph * scale;
-    float h_dst = h_glyph * scale;
+    /* --- Skip the glyph if it is outside of the clip rect --- */
 
-    /* --- Convert the source rect to texture coordinates --- */
+    float x0 = x_dst, x1 = x_dst + w_dst;
+    float y0 = y_dst, y1 = y_dst + h_dst;
 
-    int w_atlas = 0, h_atlas = 0;
-    sl_texture_query(font->texture, &w_atlas, &h_atlas);
+    if (run->clipped) {
+        x0 = SL_MAX(x0, run->clip_x0), x1 = SL_MIN(x1, run->clip_x1);
+        y0 = SL_MAX(y0, run->clip_y0), y1 = SL_MIN(y1, run->clip_y1);
+        if (x0 >= x1 || y0 >= y1) {
+            return;
+        }
+    }
 
-    float u0 = x_glyph / w_atlas;
-    float v0 = y_glyph / h_atlas;
-    float u1 = u0 + (w_glyph / w_atlas);
-    float v1 = v0 + (h_glyph / h_atlas);
+    /* --- Get the atlas page of the glyph --- */
 
-    /* --- Push the character to the batch with scaled dimensions --- */
+    // NOTE: Rasterizing a glyph may flush the batch to evict a page,
+    //       which discards the space reserved for the next glyphs.
 
-    sl_vertex_2d_t quad[4] = {
-        SL_VERTEX_2D(SL_VEC2(x_dst, y_dst), SL_VEC2(u0, v0), sl__render.current_color),
-        SL_VERTEX_2D(SL_VEC2(x_dst, y_dst + h_dst), SL_VEC2(u0, v1), sl__render.current_color),
-        SL_VERTEX_2D(SL_VEC2(x_dst + w_dst, y_dst + h_dst), SL_VEC2(u1, v1), sl__render.current_color),
-        SL_VERTEX_2D(SL_VEC2(x_dst + w_dst, y_dst), SL_VEC2(u1, v0), sl__render.current_color)
-    };
+    bool rasterized = false;
+    sl_texture_id texture = sl__font_glyph_texture(font, glyph_index, &rasterized);
+
+    if (texture == 0) {
+        return;
+    }
+
+    if (rasterized || texture != sl__render.current_texture) {
+        sl__render.current_texture = texture;
+        run->reserved = 0;
+    }
+
+    /* --- Reserve space for the next glyphs if needed --- */
+
+    if (run->reserved == 0) {
+        run->reserved = sl__render_reserve_items(glyphs_left, 4, 6);
+    }
 
-    sl_render_quad_list(quad, 1);
+    /* --- Convert the padded source rect to texture coordinates --- */
 
-    /* --- Reset the previous pipeline state --- */
+    float x_glyph = (float)(glyph->x_atlas - font->glyph_padding);
+    float y_glyph = (float)(glyph->y_atlas - font->glyph_padding);
+
+    float u0 = x_glyph * run->u_scale;
+    float v0 = y_glyph * run->v_scale;
+    float u1 = u0 + w_glyph * run->u_scale;
+    float v1 = v0 + h_glyph * run->v_scale;
+
+    /* --- Cut the texture coordinates like the quad --- */
 
-    sl__render.current_texture = previous_texture;
-    sl__render.current_blend_mode = previous_blend;
+    if (run->clipped) {
+        float du = (u1 - u0) / w_dst;
+        float dv = (v1 - v0) / h_dst;
+        u1 = u0 + (x1 - x_dst) * du;
+        v1 = v0 + (y1 - y_dst) * dv;
+        u0 += (x0 - x_dst) * du;
+        v0 += (y0 - y_dst) * dv;
+        x_dst = x0, w_dst = x1 - x0;
+        y_dst = y0, h_dst = y1 - y0;
+    }
+
+    /* --- Write the quad straight into the batch --- */
+
+    int base_index = sl__render.vertex_count;
+    sl_color_t color = sl__render.current_color;
+
+    sl__render_add_vertex(&SL_VERTEX_2D(SL_VEC2(x_dst, y_dst), SL_VEC2(u0, v0), color));
+    sl__render_add_vertex(&SL_VERTEX_2D(SL_VEC2(x_dst, y_dst + h_dst), SL_VEC2(u0, v1), color));
+    sl__render_add_vertex(&SL_VERTEX_2D(SL_VEC2(x_dst + w_dst, y_dst + h_dst), SL_VEC2(u1, v1), color));
+    sl__render_add_vertex(&SL_VERTEX_2D(SL_VEC2(x_dst + w_dst, y_dst), SL_VEC2(u1, v0), color));
+
+    GLushort* index = &sl__render.index_buffer[sl__render.index_count];
+
+    index[0] = base_index;
+    index[1] = base_index + 1;
+    index[2] = base_index + 2;
+    index[3] = base_index;
+    index[4] = base_index + 2;
+    index[5] = base_index + 3;
+
+    sl__render.index_count += 6;
+    run->reserved--;
 }
 
-static void sl__render_codepoints(const sl__font_t* font, const int* codepoints, int length, float x, float y, float font_size, float x_spacing, float y_spacing)
+static void sl__render_codepoint(sl__font_t* font, int codepoint, float x, float y, float font_size)
 {
+    sl__text_run_t run;
+    if (!sl__render_text_begin(&run, font, font_size)) {
+        return;
+    }
+
+    sl__render_text_glyph(&run, sl__font_glyph_index(font, codepoint), x, y, 1);
+    sl__render_text_end(&run);
+}
+
+static void sl__render_codepoints(sl__font_t* font, const int* codepoints, int length, float x, float y, float font_size, float x_spacing, float y_spacing)
+{
+    sl__text_run_t run;
+    if (!sl__render_text_begin(&run, font, font_size)) {
+        return;
+    }
+
     float y_offset = 0.0f;
     float x_offset = 0.0f;
+    int previous_index = -1;
 
-    float scale = font_size / font->base_size;
+    float scale = run.scale;
 
     for (int i = 0; i < length; i++)
     {
-        const sl__glyph_t* glyph = sl__glyph_info(font, codepoints[i]);
+        int glyph_index = sl__font_glyph_index(font, codepoints[i]);
+        const sl__glyph_t* glyph = &font->glyphs[glyph_index];
 
         if (codepoints[i] == '\n') {
             y_offset += (font_size + y_spacing);
             x_offset = 0.0f;
+            previous_index = -1;
         }
         else {
+            x_offset += sl__font_kerning(font, previous_index, glyph_index) * scale;
+            previous_index = glyph_index;
+
             if (codepoints[i] != ' ' && codepoints[i] != '\t') {
-                sl__render_codepoint(font, codepoints[i], x + x_offset, y + y_offset, font_size);
+                sl__render_text_glyph(&run, glyph_index, x + x_offset, y + y_offset, length - i);
             }
 
             if (glyph->x_advance == 0) {
@@ -352,42 +811,262 @@ static void sl__render_codepoints(const sl__font_t* font, const int* codepoints,
             }
         }
     }
+
+    sl__render_text_end(&run);
 }
 
-static void sl__render_text(const sl__font_t* font, const char* text, float x, float y, float font_size, float x_spacing, float y_spacing)
+static void sl__render_text(sl__font_t* font, const char* text, float x, float y, float font_size, float x_spacing, float y_spacing)
 {
+    sl__text_run_t run;
+    if (!sl__render_text_begin(&run, font, font_size)) {
+        return;
+    }
+
     int size = (int)strlen(text);
 
     float x_offset = 0.0f;
     float y_offset = 0.0f;
+    int previous_index = -1;
+
+    float scale = run.scale;
 
-    float scale = font_size / font->base_size;
+    // NOTE: The string is decoded in chunks before the glyph lookups,
+    //       which lets the ASCII runs be converted many bytes at once.
+
+    int codepoints[SL__TEXT_DECODE_CHUNK];
 
     for (int i = 0; i < size;)
     {
-        int codepointByteCount = 0;
-        int codepoint = sl_codepoint_next(&text[i], &codepointByteCount);
+        int decoded_size = 0;
+        int count = sl_codepoint_decode(text + i, size - i, codepoints, SL__TEXT_DECODE_CHUNK, &decoded_size);
+        i += decoded_size;
 
-        const sl__glyph_t* glyph = sl__glyph_info(font, codepoint);
+        for (int j = 0; j < count; j++)
+        {
+            int codepoint = codepoints[j];
 
-        if (codepoint == '\n') {
-            y_offset += (font_size + y_spacing);
-            x_offset = 0.0f;
-        }
-        else {
-            if (codepoint != ' ' && codepoint != '\t') {
-                sl__render_codepoint(font, codepoint, x + x_offset, y + y_offset, font_size);
-            }
+            int glyph_index = sl__font_glyph_index(font, codepoint);
+            const sl__glyph_t* glyph = &font->glyphs[glyph_index];
 
-            if (glyph->x_advance == 0) {
-                x_offset += ((float)(glyph->w_atlas) * scale + x_spacing);
+            if (codepoint == '\n') {
+                y_offset += (font_size + y_spacing);
+                x_offset = 0.0f;
+                previous_index = -1;
             }
             else {
-                x_offset += ((float)(glyph->x_advance) * scale + x_spacing);
+                x_offset += sl__font_kerning(font, previous_index, glyph_index) * scale;
+                previous_index = glyph_index;
+
+                if (codepoint != ' ' && codepoint != '\t') {
+                    // The remaining bytes bound the remaining glyphs
+                    sl__render_text_glyph(&run, glyph_index, x + x_offset, y + y_offset, (count - j) + (size - i));
+                }
+
+                if (glyph->x_advance == 0) {
+                    x_offset += ((float)(glyph->w_atlas) * scale + x_spacing);
+                }
+                else {
+                    x_offset += ((float)(glyph->x_advance) * scale + x_spacing);
+                }
+            }
+        }
+    }
+
+    sl__render_text_end(&run);
+}
+
+static void sl__render_text_layout(sl__font_t* font, const sl__text_layout_t* layout, float x, float y, float scroll, bool clip, sl_color_t color)
+{
+    sl__text_run_t run;
+    if (!sl__render_text_begin(&run, font, layout->font_size)) {
+        return;
+    }
+
+    sl_color_t previous_color = sl__render.current_color;
+    sl__render.current_color = color;
+
+    /* --- Clip to the box of the layout if requested --- */
+
+    float line_h = layout->font_size + layout->spacing.y;
+    float box_w = (layout->box_w > 0.0f) ? layout->box_w : layout->w;
+    float box_h = (clip && layout->box_h > 0.0f) ? layout->box_h : INFINITY;
+
+    if (clip) {
+        run.clipped = true;
+        run.clip_x0 = x;
+        run.clip_y0 = y;
+        run.clip_x1 = (layout->box_w > 0.0f) ? x + layout->box_w : INFINITY;
+        run.clip_y1 = y + box_h;
+    }
+
+    float align = 0.0f;
+    switch (layout->align) {
+    case SL_TEXT_ALIGN_LEFT:
+        break;
+    case SL_TEXT_ALIGN_CENTER:
+        align = 0.5f;
+        break;
+    case SL_TEXT_ALIGN_RIGHT:
+        align = 1.0f;
+        break;
+    }
+
+    /* --- Emit the visible lines only --- */
+
+    // NOTE: Indices are only checked against the font size, in
+    //       case the font was replaced without updating the layout.
+
+    int line_index = 0;
+    int first_visible = clip ? (int)SL_MAX(floorf(scroll / line_h), 0.0f) : 0;
+
+    for (int i = 0; i < layout->paragraph_count; i++)
+    {
+        const sl__layout_paragraph_t* paragraph = &layout->paragraphs[i];
+
+        if (line_index + paragraph->line_count <= first_visible) {
+            line_index += paragraph->line_count;
+            continue;
+        }
+
+        for (int j = 0; j < paragraph->line_count; j++, line_index++)
+        {
+            float y_line = line_index * line_h - scroll;
+            if (y_line + line_h <= 0.0f) continue;
+            if (y_line >= box_h) goto done;
+
+            const sl__layout_line_t* line = &paragraph->lines[j];
+            const sl__layout_glyph_t* glyphs = &paragraph->glyphs[line->glyph_first];
+            float x_line = x + (box_w - line->w) * align;
+
+            for (int k = 0; k < line->glyph_count; k++) {
+                if (glyphs[k].index >= font->glyph_count) continue;
+                sl__render_text_glyph(&run, glyphs[k].index, x_line + glyphs[k].x, y + y_line, line->glyph_count - k);
             }
         }
+    }
+
+done:
+    sl__render.current_color = previous_color;
+    sl__render_text_end(&run);
+}
+
+/* === Bulk Shape Helpers === */
+
+typedef struct {
+    float cx[4], cy[4];     ///< Shape origins
+    float ux[4], uy[4];     ///< First axis
+    float vx[4], vy[4];     ///< Second axis
+} sl__render_basis4_t;
+
+static void sl__render_basis4_transform(sl__render_basis4_t* b)
+{
+    // NOTE: Folds the current transform into the shape basis so it is
+    //       applied once per shape instead of once per vertex, unless
+    //       the GPU applies it from the transform palette.
+
+    if (sl__render.transform_is_identity || sl__render.transform_palette_slot >= 0) {
+        return;
+    }
+
+    const sl_mat4_t* m = &sl__render.matrix_transform;
+
+    sl__f4 m00 = sl__f4_set1(m->m00), m01 = sl__f4_set1(m->m01);
+    sl__f4 m10 = sl__f4_set1(m->m10), m11 = sl__f4_set1(m->m11);
+
+    sl__f4 x = sl__f4_load(b->cx), y = sl__f4_load(b->cy);
+    sl__f4_store(b->cx, sl__f4_fma(m00, x, sl__f4_fma(m10, y, sl__f4_set1(m->m30))));
+    sl__f4_store(b->cy, sl__f4_fma(m01, x, sl__f4_fma(m11, y, sl__f4_set1(m->m31))));
+
+    x = sl__f4_load(b->ux), y = sl__f4_load(b->uy);
+    sl__f4_store(b->ux, sl__f4_fma(m00, x, sl__f4_mul(m10, y)));
+    sl__f4_store(b->uy, sl__f4_fma(m01, x, sl__f4_mul(m11, y)));
+
+    x = sl__f4_load(b->vx), y = sl__f4_load(b->vy);
+    sl__f4_store(b->vx, sl__f4_fma(m00, x, sl__f4_mul(m10, y)));
+    sl__f4_store(b->vy, sl__f4_fma(m01, x, sl__f4_mul(m11, y)));
+}
+
+static void sl__render_texcoords(sl_vec2_t* texcoords, int count)
+{
+    if (sl__render.texture_is_identity) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        texcoords[i] = sl_vec2_transform(texcoords[i], &sl__render.matrix_texture);
+    }
+}
+
+static void sl__render_circle_ring(sl_vertex_2d_t* vertex, int segments)
+{
+    // Writes the center then the unit ring in the positions, with the
+    // final texcoords, straight into the batch for the circles to copy
+
+    float delta = (2.0f * SL_PI) / (float)segments;
+
+    for (int i = 0; i < segments; i += 4) {
+        float angles[4], s[4], c[4];
+        for (int k = 0; k < 4; k++) {
+            angles[k] = (float)(i + k) * delta;
+        }
+
+        sl__f4 sin_a, cos_a;
+        sl__f4_sincos(sl__f4_load(angles), &sin_a, &cos_a);
+        sl__f4_store(s, sin_a);
+        sl__f4_store(c, cos_a);
+
+        for (int k = 0; k < 4 && i + k < segments; k++) {
+            vertex[1 + i + k].position = SL_VEC2(c[k], s[k]);
+            vertex[1 + i + k].texcoord = SL_VEC2(0.5f + 0.5f * c[k], 0.5f + 0.5f * s[k]);
+        }
+    }
+
+    vertex[0].position = SL_VEC2(0.0f, 0.0f);
+    vertex[0].texcoord = SL_VEC2(0.5f, 0.5f);
+
+    for (int k = 0; k <= segments; k++) {
+        sl__render_texcoords(&vertex[k].texcoord, 1);
+    }
+}
+
+static void sl__render_basis4_emit(const sl__render_basis4_t* b, const sl_color_t* colors, int n,
+                                   const float coefs[4][2], const sl_vec2_t texcoords[4], uint8_t skip_mask)
+{
+    // Each vertex is origin + a * U + b * V, quads are wound 0-1-2 / 0-2-3
+
+    uint8_t transform_index = (uint8_t)SL_MAX(sl__render.transform_palette_slot, 0);
+
+    for (int i = 0; i < n; i++) {
+        if (skip_mask & (1 << i)) {
+            continue;
+        }
+
+        sl_color_t color = colors ? colors[i] : sl__render.current_color;
+
+        int base_index = sl__render.vertex_count;
+        sl_vertex_2d_t* vertex = &sl__render.vertex_buffer[base_index];
+
+        for (int k = 0; k < 4; k++) {
+            float a = coefs[k][0], c = coefs[k][1];
+            vertex[k].position.x = b->cx[i] + a * b->ux[i] + c * b->vx[i];
+            vertex[k].position.y = b->cy[i] + a * b->uy[i] + c * b->vy[i];
+            vertex[k].texcoord = texcoords[k];
+            vertex[k].color = color;
+        }
+
+        GLushort* index = &sl__render.index_buffer[sl__render.index_count];
+
+        index[0] = base_index;
+        index[1] = base_index + 1;
+        index[2] = base_index + 2;
+        index[3] = base_index;
+        index[4] = base_index + 2;
+        index[5] = base_index + 3;
+
+        SDL_memset(&sl__render.transform_index_buffer[base_index], transform_index, 4);
 
-        i += codepointByteCount;
+        sl__render.vertex_count += 4;
+        sl__render.index_count += 6;
     }
 }
 
@@ -402,20 +1081,105 @@ void sl_render_present(void)
 {
     sl__render_flush_all();
 
+#ifdef SL_BACKEND_SOFTWARE
+    sl__raster_present(sl__core.window);
+#else
     SDL_GL_SwapWindow(sl__core.window);
+#endif
 }
 
 void sl_render_clear(sl_color_t color)
 {
+#ifdef SL_BACKEND_SOFTWARE
+    sl__raster_clear(sl__render_raster_target(), color);
+#else
     glClearColor((float)color.r / 255.0f, (float)color.g / 255.0f, (float)color.b / 255.0f, (float)color.a / 255.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+#endif
+}
+
+bool sl_render_read_pixels(sl_image_t* image)
+{
+    if (image == NULL) {
+        return false;
+    }
+
+    sl__render_flush_all();
+
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Copy the raster target --- */
+
+    const sl__texture_t* target = sl__render_raster_target();
+
+    if (!sl_image_create(image, target->w, target->h, SL_PIXEL_FORMAT_RGBA8)) {
+        sl_loge("RENDER: Failed to read pixels; Out of memory");
+        return false;
+    }
+
+    // Targets are stored bottom-up like GL framebuffers
+    uint8_t* dst = image->pixels;
+    for (int y = 0; y < target->h; y++) {
+        const uint32_t* row = target->pixels + (size_t)(target->h - 1 - y) * target->w;
+        for (int x = 0; x < target->w; x++, dst += 4) {
+            dst[0] = (uint8_t)(row[x] >> 0);
+            dst[1] = (uint8_t)(row[x] >> 8);
+            dst[2] = (uint8_t)(row[x] >> 16);
+            dst[3] = (uint8_t)(row[x] >> 24);
+        }
+    }
+
+#else
+
+    /* --- Get the size of the current target --- */
+
+    int w = 0, h = 0;
+
+    if (sl__render.current_canvas != 0) {
+        const sl__canvas_t* canvas = sl__registry_get(&sl__render.reg_canvases, sl__render.current_canvas);
+        if (canvas == NULL) return false;
+        w = canvas->w, h = canvas->h;
+    }
+    else {
+        SDL_GetWindowSizeInPixels(sl__core.window, &w, &h);
+    }
+
+    if (!sl_image_create(image, w, h, SL_PIXEL_FORMAT_RGBA8)) {
+        sl_loge("RENDER: Failed to read pixels; Out of memory");
+        return false;
+    }
+
+    /* --- Read and flip the rows --- */
+
+    glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels);
+
+    uint8_t* pixels = image->pixels;
+    size_t pitch = (size_t)w * 4;
+
+    for (int y = 0; y < h / 2; y++) {
+        uint8_t* top = pixels + y * pitch;
+        uint8_t* bottom = pixels + (h - 1 - y) * pitch;
+        for (size_t i = 0; i < pitch; i++) {
+            uint8_t tmp = top[i];
+            top[i] = bottom[i];
+            bottom[i] = tmp;
+        }
+    }
+
+#endif
+
+    return true;
 }
 
 void sl_render_set_viewport(int x, int y, int w, int h)
 {
     sl__render_flush_all();
 
+#ifdef SL_BACKEND_SOFTWARE
+    sl__raster.viewport = (sl__raster_rect_t) { x, y, w, h };
+#else
     glViewport(x, y, w, h);
+#endif
 }
 
 void sl_render_set_scissor(int x, int y, int w, int h)
@@ -423,11 +1187,20 @@ void sl_render_set_scissor(int x, int y, int w, int h)
     sl__render_flush_all();
 
     if (w != 0 && h != 0 || x != 0 || y != 0) {
+#ifdef SL_BACKEND_SOFTWARE
+        sl__raster.scissor = (sl__raster_rect_t) { x, y, w, h };
+        sl__raster.scissor_enabled = true;
+#else
         glEnable(GL_SCISSOR_TEST);
         glScissor(x, y, w, h);
+#endif
     }
     else {
+#ifdef SL_BACKEND_SOFTWARE
+        sl__raster.scissor_enabled = false;
+#else
         glDisable(GL_SCISSOR_TEST);
+#endif
     }
 }
 
@@ -437,6 +1210,10 @@ void sl_render_set_stencil(sl_stencil_func_t func, int ref, uint32_t mask,
 {
     sl__render_flush_all();
 
+#ifdef SL_BACKEND_SOFTWARE
+    // NOTE: The software backend has no stencil buffer
+    (void)func, (void)ref, (void)mask, (void)sfail, (void)dpfail, (void)dppass;
+#else
     if(func == SL_STENCIL_DISABLE) {
         glDisable(GL_STENCIL_TEST);
         return;
@@ -466,33 +1243,64 @@ void sl_render_set_stencil(sl_stencil_func_t func, int ref, uint32_t mask,
     glEnable(GL_STENCIL_TEST);
     glStencilFunc(func_table[func], ref, mask);
     glStencilOp(op_table[sfail], op_table[dpfail], op_table[dppass]);
+#endif
 }
 
 void sl_render_set_depth_test(bool enabled)
 {
     sl__render_flush_all();
 
+#ifdef SL_BACKEND_SOFTWARE
+    (void)enabled; //< No depth buffer in the software backend
+#else
     (enabled ? glEnable : glDisable)(GL_DEPTH_TEST);
+    sl__render.depth_test = enabled;
+#endif
 }
 
 void sl_render_set_depth_write(bool enabled)
 {
     sl__render_flush_all();
 
+#ifdef SL_BACKEND_SOFTWARE
+    (void)enabled;
+#else
     glDepthMask(enabled);
+    sl__render.depth_write = enabled;
+#endif
 }
 
 void sl_render_set_depth_range(float near, float far)
 {
     sl__render_flush_all();
 
-    glDepthRangef(near, far);
+#if defined(SL_BACKEND_SOFTWARE)
+    (void)near, (void)far;
+#else
+    sl__render_depth_range(near, far);
+    sl__render.depth_near = near;
+    sl__render.depth_far = far;
+#endif
+}
+
+void sl_render_set_opaque_sorting(bool enabled)
+{
+    sl__render_flush_all();
+
+#ifdef SL_BACKEND_SOFTWARE
+    (void)enabled; //< No depth buffer in the software backend
+#else
+    sl__render.opaque_sorting = enabled;
+#endif
 }
 
 void sl_render_set_cull_face(sl_cull_mode_t cull)
 {
     sl__render_flush_all();
 
+#ifdef SL_BACKEND_SOFTWARE
+    sl__raster.cull_mode = cull;
+#else
     if (cull == SL_CULL_NONE) {
         glDisable(GL_CULL_FACE);
     }
@@ -500,6 +1308,7 @@ void sl_render_set_cull_face(sl_cull_mode_t cull)
         glEnable(GL_CULL_FACE);
         glCullFace(cull == SL_CULL_FRONT ? GL_FRONT : GL_BACK);
     }
+#endif
 }
 
 void sl_render_set_color(sl_color_t color)
@@ -517,7 +1326,9 @@ void sl_render_set_sampler(uint32_t slot, sl_texture_id texture)
         sl__render.current_texture = texture;
     }
     else {
+#ifndef SL_BACKEND_SOFTWARE
         sl__render_bind_texture(slot, texture);
+#endif
     }
 }
 
@@ -528,6 +1339,38 @@ void sl_render_set_font(sl_font_id font)
     sl__render.current_font = font;
 }
 
+void sl_render_set_text_outline(float width, sl_color_t color)
+{
+    // NOTE: The width is converted to the distance units of the
+    //       atlas, it can't go past the padding of the glyphs.
+
+    width = SL_CLAMP(width, 0.0f, SL__FONT_SDF_MAX_OUTLINE);
+    width *= SL__FONT_SDF_PIXEL_DIST_SCALE / 255.0f;
+
+    if (sl__render.text_outline_width == width &&
+        SDL_memcmp(&sl__render.text_outline_color, &color, sizeof(color)) == 0) {
+        return;
+    }
+
+    sl__render_flush_all();
+
+    sl__render.text_outline_width = width;
+    sl__render.text_outline_color = color;
+}
+
+void sl_render_set_text_shadow(sl_vec2_t offset, sl_color_t color)
+{
+    if (sl__render.text_shadow_offset.x == offset.x && sl__render.text_shadow_offset.y == offset.y &&
+        SDL_memcmp(&sl__render.text_shadow_color, &color, sizeof(color)) == 0) {
+        return;
+    }
+
+    sl__render_flush_all();
+
+    sl__render.text_shadow_offset = offset;
+    sl__render.text_shadow_color = color;
+}
+
 void sl_render_set_shader(sl_shader_id shader)
 {
     if (shader == 0) {
@@ -537,7 +1380,9 @@ void sl_render_set_shader(sl_shader_id shader)
         sl__shader_t* data = sl__registry_get(&sl__render.reg_shaders, shader);
         if (data == NULL) return;
 
+#ifndef SL_BACKEND_SOFTWARE
         glUseProgram(data->id);
+#endif
     }
 
     sl__render.current_shader = shader;
@@ -558,8 +1403,12 @@ void sl_render_set_canvas(sl_canvas_id canvas)
 
     if (canvas == 0) {
         sl_vec2_t win_size = sl_window_get_size();
+#ifdef SL_BACKEND_SOFTWARE
+        sl__raster.viewport = (sl__raster_rect_t) { 0, 0, sl__raster.backbuffer.w, sl__raster.backbuffer.h };
+#else
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, win_size.x, win_size.y);
+#endif
         sl__render.current_canvas = 0;
         if (!sl__render.use_custom_proj) {
             sl__render.matrix_proj = sl_mat4_ortho(0, win_size.x, win_size.y, 0, 0, 1);
@@ -570,8 +1419,12 @@ void sl_render_set_canvas(sl_canvas_id canvas)
     const sl__canvas_t* data = sl__registry_get(&sl__render.reg_canvases, canvas);
     if (data == NULL) return;
 
+#ifdef SL_BACKEND_SOFTWARE
+    sl__raster.viewport = (sl__raster_rect_t) { 0, 0, data->w, data->h };
+#else
     glBindFramebuffer(GL_FRAMEBUFFER, data->framebuffer);
     glViewport(0, 0, data->w, data->h);
+#endif
     sl__render.current_canvas = canvas;
 
     if (!sl__render.use_custom_proj) {
@@ -743,6 +1596,7 @@ void sl_render_pop(void)
         sl__render.matrix_transform_stack_pos--;
         SDL_memcpy(sl__render.matrix_transform.a, sl__render.matrix_transform_stack[sl__render.matrix_transform_stack_pos].a, sizeof(sl_mat4_t));
         sl__render.transform_is_identity = (0 == SDL_memcmp(sl__render.matrix_transform.a, &SL_MAT4_IDENTITY, sizeof(sl_mat4_t)));
+        sl__render.transform_palette_slot = -1;
     }
 }
 
@@ -750,6 +1604,7 @@ void sl_render_identity(void)
 {
     sl__render.matrix_transform = SL_MAT4_IDENTITY;
     sl__render.transform_is_identity = true;
+    sl__render.transform_palette_slot = -1;
 }
 
 void sl_render_translate(sl_vec3_t v)
@@ -757,6 +1612,7 @@ void sl_render_translate(sl_vec3_t v)
     sl_mat4_t translate = sl_mat4_translate(v);
     sl__render.matrix_transform = sl_mat4_mul(&sl__render.matrix_transform, &translate);
     sl__render.transform_is_identity = false;
+    sl__render.transform_palette_slot = -1;
 }
 
 void sl_render_rotate(sl_vec3_t v)
@@ -778,6 +1634,7 @@ void sl_render_rotate(sl_vec3_t v)
     }
 
     sl__render.transform_is_identity = false;
+    sl__render.transform_palette_slot = -1;
 }
 
 void sl_render_scale(sl_vec3_t v)
@@ -785,12 +1642,14 @@ void sl_render_scale(sl_vec3_t v)
     sl_mat4_t scale = sl_mat4_scale(v);
     sl__render.matrix_transform = sl_mat4_mul(&sl__render.matrix_transform, &scale);
     sl__render.transform_is_identity = false;
+    sl__render.transform_palette_slot = -1;
 }
 
 void sl_render_set_transform(const sl_mat4_t* matrix)
 {
     sl__render.matrix_transform = sl_mat4_mul(&sl__render.matrix_transform, matrix);
     sl__render.transform_is_identity = false;
+    sl__render.transform_palette_slot = -1;
 }
 
 sl_mat4_t sl_render_get_transform(void)
@@ -798,6 +1657,17 @@ sl_mat4_t sl_render_get_transform(void)
     return sl__render.matrix_transform;
 }
 
+void sl_render_set_gpu_transform(bool enabled)
+{
+#ifdef SL_BACKEND_SOFTWARE
+    // NOTE: The rasterizer already projects each batch in one pass
+    (void)enabled;
+#else
+    sl__render.gpu_transform = enabled;
+    sl__render.transform_palette_slot = -1;
+#endif
+}
+
 void sl_render_texture_identity(void)
 {
     sl__render.matrix_texture = SL_MAT4_IDENTITY;
@@ -1105,6 +1975,62 @@ void sl_render_rectangle_ex(sl_vec2_t center, sl_vec2_t size, float rotation)
     sl_render_quad(tl, tr, br, bl);
 }
 
+void sl_render_rectangles_ex(const sl_vec2_t* centers, const sl_vec2_t* sizes, const float* rotations, const sl_color_t* colors, int count)
+{
+    static const float coefs[4][2] = {
+        { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f }
+    };
+
+    sl_vec2_t texcoords[4] = {
+        { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }
+    };
+
+    sl__render_texcoords(texcoords, 4);
+
+    while (count > 0) {
+        int n = sl__render_reserve_items(count, 4, 6);
+
+        for (int i = 0; i < n; i += 4) {
+            int m = SL_MIN(4, n - i);
+
+            sl__render_basis4_t b = { 0 };
+            float w[4] = { 0 }, h[4] = { 0 }, r[4] = { 0 };
+
+            for (int k = 0; k < m; k++) {
+                b.cx[k] = centers[i + k].x;
+                b.cy[k] = centers[i + k].y;
+                w[k] = sizes[i + k].x;
+                h[k] = sizes[i + k].y;
+                if (rotations) r[k] = rotations[i + k];
+            }
+
+            sl__f4 sin_r = sl__f4_set1(0.0f);
+            sl__f4 cos_r = sl__f4_set1(1.0f);
+
+            if (rotations) {
+                sl__f4_sincos(sl__f4_load(r), &sin_r, &cos_r);
+            }
+
+            sl__f4 half_w = sl__f4_mul(sl__f4_load(w), sl__f4_set1(0.5f));
+            sl__f4 half_h = sl__f4_mul(sl__f4_load(h), sl__f4_set1(0.5f));
+
+            sl__f4_store(b.ux, sl__f4_mul(half_w, cos_r));
+            sl__f4_store(b.uy, sl__f4_mul(half_w, sin_r));
+            sl__f4_store(b.vx, sl__f4_sub(sl__f4_set1(0.0f), sl__f4_mul(half_h, sin_r)));
+            sl__f4_store(b.vy, sl__f4_mul(half_h, cos_r));
+
+            sl__render_basis4_transform(&b);
+            sl__render_basis4_emit(&b, colors ? colors + i : NULL, m, coefs, texcoords, 0);
+        }
+
+        centers += n;
+        sizes += n;
+        if (rotations) rotations += n;
+        if (colors) colors += n;
+        count -= n;
+    }
+}
+
 void sl_render_rectangle_lines_ex(sl_vec2_t center, sl_vec2_t size, float rotation, float thickness)
 {
     float half_w = size.x * 0.5f;
@@ -1395,6 +2321,79 @@ void sl_render_circle(sl_vec2_t center, float radius, int segments)
     }
 }
 
+void sl_render_circles(const sl_vec2_t* centers, const float* radii, const sl_color_t* colors, int count, int segments)
+{
+    if (segments < 3) segments = 32;
+
+    // Each circle must fit in the batch on its own
+    segments = SL_MIN(segments, SL_MIN(SL__VERTEX_BUFFER_SIZE - 1, SL__INDEX_BUFFER_SIZE / 3));
+
+    /* --- Tessellate the circles --- */
+
+    const sl_mat4_t* m = &sl__render.matrix_transform;
+
+    while (count > 0) {
+        int n = sl__render_reserve_items(count, segments + 1, segments * 3);
+
+        // The unit ring lives in the first circle's slots, so that one is written last
+        sl_vertex_2d_t* ring = &sl__render.vertex_buffer[sl__render.vertex_count];
+        sl__render_circle_ring(ring, segments);
+
+        // The transform is folded on the CPU unless the palette holds it
+        bool transform = !sl__render.transform_is_identity && sl__render.transform_palette_slot < 0;
+        uint8_t transform_index = (uint8_t)SL_MAX(sl__render.transform_palette_slot, 0);
+
+        for (int i = n - 1; i >= 0; i--) {
+            sl_color_t color = colors ? colors[i] : sl__render.current_color;
+
+            // Vertex k is center + cos * U + sin * V with the transform folded in
+            sl_vec2_t center = centers[i];
+            sl_vec2_t u = SL_VEC2(radii[i], 0.0f);
+            sl_vec2_t v = SL_VEC2(0.0f, radii[i]);
+
+            if (transform) {
+                center = sl_vec2_transform(center, m);
+                u = SL_VEC2(radii[i] * m->m00, radii[i] * m->m01);
+                v = SL_VEC2(radii[i] * m->m10, radii[i] * m->m11);
+            }
+
+            int base_index = sl__render.vertex_count + i * (segments + 1);
+            sl_vertex_2d_t* vertex = &sl__render.vertex_buffer[base_index];
+
+            vertex[0].position = center;
+            vertex[0].texcoord = ring[0].texcoord;
+            vertex[0].color = color;
+
+            for (int k = 1; k <= segments; k++) {
+                sl_vec2_t unit = ring[k].position;
+                vertex[k].position.x = center.x + unit.x * u.x + unit.y * v.x;
+                vertex[k].position.y = center.y + unit.x * u.y + unit.y * v.y;
+                vertex[k].texcoord = ring[k].texcoord;
+                vertex[k].color = color;
+            }
+
+            GLushort* index = &sl__render.index_buffer[sl__render.index_count + i * segments * 3];
+
+            for (int k = 0; k < segments; k++) {
+                int next = (k + 1 < segments) ? k + 1 : 0;
+                *index++ = base_index;
+                *index++ = base_index + 1 + k;
+                *index++ = base_index + 1 + next;
+            }
+
+            SDL_memset(&sl__render.transform_index_buffer[base_index], transform_index, segments + 1);
+        }
+
+        sl__render.vertex_count += n * (segments + 1);
+        sl__render.index_count += n * segments * 3;
+
+        centers += n;
+        radii += n;
+        if (colors) colors += n;
+        count -= n;
+    }
+}
+
 void sl_render_circle_lines(sl_vec2_t p, float radius, int segments, float thickness)
 {
     if (segments < 3) segments = 32;
@@ -1804,6 +2803,62 @@ void sl_render_line(sl_vec2_t p0, sl_vec2_t p1, float thickness)
     sl__render_add_index(base_index + 3);
 }
 
+void sl_render_lines(const sl_vec2_t* starts, const sl_vec2_t* ends, const sl_color_t* colors, int count, float thickness)
+{
+    static const float coefs[4][2] = {
+        { 0.0f, 1.0f }, { 0.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }
+    };
+
+    sl_vec2_t texcoords[4] = {
+        { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }
+    };
+
+    sl__render_texcoords(texcoords, 4);
+
+    while (count > 0) {
+        int n = sl__render_reserve_items(count, 4, 6);
+
+        for (int i = 0; i < n; i += 4) {
+            int m = SL_MIN(4, n - i);
+
+            sl__render_basis4_t b = { 0 };
+            float len_sq[4];
+
+            for (int k = 0; k < m; k++) {
+                b.cx[k] = starts[i + k].x;
+                b.cy[k] = starts[i + k].y;
+                b.ux[k] = ends[i + k].x - starts[i + k].x;
+                b.uy[k] = ends[i + k].y - starts[i + k].y;
+            }
+
+            sl__f4 dx = sl__f4_load(b.ux);
+            sl__f4 dy = sl__f4_load(b.uy);
+
+            sl__f4 lsq = sl__f4_fma(dx, dx, sl__f4_mul(dy, dy));
+            sl__f4_store(len_sq, lsq);
+
+            // The clamp only keeps the padded and degenerate lanes finite, they are skipped
+            sl__f4 scale = sl__f4_mul(sl__f4_rsqrt(sl__f4_max(lsq, sl__f4_set1(1e-6f))), sl__f4_set1(0.5f * thickness));
+
+            sl__f4_store(b.vx, sl__f4_sub(sl__f4_set1(0.0f), sl__f4_mul(dy, scale)));
+            sl__f4_store(b.vy, sl__f4_mul(dx, scale));
+
+            uint8_t skip_mask = 0;
+            for (int k = 0; k < m; k++) {
+                if (len_sq[k] < 1e-6f) skip_mask |= 1 << k;
+            }
+
+            sl__render_basis4_transform(&b);
+            sl__render_basis4_emit(&b, colors ? colors + i : NULL, m, coefs, texcoords, skip_mask);
+        }
+
+        starts += n;
+        ends += n;
+        if (colors) colors += n;
+        count -= n;
+    }
+}
+
 void sl_render_arc(sl_vec2_t center, float radius,
                    float start_angle, float end_angle,
                    float thickness, int segments)
@@ -2181,6 +3236,64 @@ void sl_render_text_centered(const char* text, sl_vec2_t position, float font_si
     sl__render_text(font, text, position.x - w * 0.5f, position.y - h * 0.5f, font_size, spacing.x, spacing.y);
 }
 
+void sl_render_text_layout(sl_text_layout_id layout, sl_vec2_t position, sl_color_t color)
+{
+    /* --- Get the layout and its font --- */
+
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) {
+        return;
+    }
+
+    sl__font_t* font = sl__registry_get(&sl__render.reg_fonts, data->font);
+    if (font == NULL) {
+        return;
+    }
+
+    /* --- Render the glyph run --- */
+
+    sl__render_text_layout(font, data, position.x, position.y, 0.0f, false, color);
+}
+
+void sl_render_text_layout_centered(sl_text_layout_id layout, sl_vec2_t position, sl_color_t color)
+{
+    /* --- Get the layout and its font --- */
+
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) {
+        return;
+    }
+
+    sl__font_t* font = sl__registry_get(&sl__render.reg_fonts, data->font);
+    if (font == NULL) {
+        return;
+    }
+
+    /* --- Render the glyph run around its stored bounds --- */
+
+    float w = (data->box_w > 0.0f) ? data->box_w : data->w;
+    sl__render_text_layout(font, data, position.x - w * 0.5f, position.y - data->h * 0.5f, 0.0f, false, color);
+}
+
+void sl_render_text_layout_box(sl_text_layout_id layout, sl_vec2_t position, float scroll, sl_color_t color)
+{
+    /* --- Get the layout and its font --- */
+
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) {
+        return;
+    }
+
+    sl__font_t* font = sl__registry_get(&sl__render.reg_fonts, data->font);
+    if (font == NULL) {
+        return;
+    }
+
+    /* --- Render the lines that are visible in the box --- */
+
+    sl__render_text_layout(font, data, position.x, position.y, scroll, true, color);
+}
+
 void sl_render_mesh(sl_mesh_id mesh, uint32_t count)
 {
     // TODO: Find a solution for normal transformation.
@@ -2196,6 +3309,19 @@ void sl_render_mesh(sl_mesh_id mesh, uint32_t count)
     sl_mat4_t mvp = sl_mat4_mul(&sl__render.matrix_transform, &sl__render.matrix_view);
     mvp = sl_mat4_mul(&mvp, &sl__render.matrix_proj);
 
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Rasterize the mesh right away --- */
+
+    int available = (data->indices != NULL) ? data->index_count : data->vertex_count;
+
+    sl__raster_begin(sl__render_raster_target());
+    sl__raster_vertices_3d(data->vertices, data->vertex_count, &mvp);
+    sl__raster_draw(data->indices, SL_MIN((int)count, available), sl__render_raster_texture(sl__render.current_texture), sl__render.current_blend_mode, false);
+    sl__raster_end();
+
+#else
+
     /* --- Configure the pipeline --- */
 
     sl__render_use_shader(sl__render.current_shader, &mvp);
@@ -2204,6 +3330,13 @@ void sl_render_mesh(sl_mesh_id mesh, uint32_t count)
 
     /* --- Bind buffer and setup vertex attributes --- */
 
+#ifdef SL_BACKEND_GL33
+
+    sl__render_upload_mvp(&mvp);
+    glBindVertexArray(data->vao);
+
+#else
+
     glBindBuffer(GL_ARRAY_BUFFER, data->vbo);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, position));
@@ -2218,15 +3351,21 @@ void sl_render_mesh(sl_mesh_id mesh, uint32_t count)
     glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, color));
     glEnableVertexAttribArray(3);
 
+#endif
+
     /* --- Draw! --- */
 
     if (data->ebo == 0) {
         glDrawArrays(GL_TRIANGLES, 0, count);
     }
     else {
+#ifndef SL_BACKEND_GL33
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data->ebo);
+#endif
         glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, NULL);
     }
+
+#endif // SL_BACKEND_SOFTWARE
 }
 
 void sl_render_mesh_lines(sl_mesh_id mesh, uint32_t count)
@@ -2239,6 +3378,19 @@ void sl_render_mesh_lines(sl_mesh_id mesh, uint32_t count)
     sl_mat4_t mvp = sl_mat4_mul(&sl__render.matrix_transform, &sl__render.matrix_view);
     mvp = sl_mat4_mul(&mvp, &sl__render.matrix_proj);
 
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Rasterize the mesh right away --- */
+
+    int available = (data->indices != NULL) ? data->index_count : data->vertex_count;
+
+    sl__raster_begin(sl__render_raster_target());
+    sl__raster_vertices_3d(data->vertices, data->vertex_count, &mvp);
+    sl__raster_draw(data->indices, SL_MIN((int)count, available), sl__render_raster_texture(sl__render.current_texture), sl__render.current_blend_mode, true);
+    sl__raster_end();
+
+#else
+
     /* --- Configure the pipeline --- */
 
     sl__render_use_shader(sl__render.current_shader, &mvp);
@@ -2247,6 +3399,13 @@ void sl_render_mesh_lines(sl_mesh_id mesh, uint32_t count)
 
     /* --- Bind buffer and setup vertex attributes --- */
 
+#ifdef SL_BACKEND_GL33
+
+    sl__render_upload_mvp(&mvp);
+    glBindVertexArray(data->vao);
+
+#else
+
     glBindBuffer(GL_ARRAY_BUFFER, data->vbo);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, position));
@@ -2261,13 +3420,19 @@ void sl_render_mesh_lines(sl_mesh_id mesh, uint32_t count)
     glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sl_vertex_3d_t), (void*)offsetof(sl_vertex_3d_t, color));
     glEnableVertexAttribArray(3);
 
+#endif
+
     /* --- Draw! --- */
 
     if (data->ebo == 0) {
         glDrawArrays(GL_LINES, 0, count);
     }
     else {
+#ifndef SL_BACKEND_GL33
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data->ebo);
+#endif
         glDrawElements(GL_LINES, count, GL_UNSIGNED_SHORT, NULL);
     }
+
+#endif // SL_BACKEND_SOFTWARE
 }
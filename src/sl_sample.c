@@ -20,30 +20,83 @@
 #include <smol.h>
 
 #include "./internal/sl__audio.h"
+#include "./internal/sl__mixer.h"
 
-/* === Public API === */
+/* === Helper Functions === */
 
-sl_sample_id sl_sample_load(const char* file_path, int channel_count)
+static sl__sample_t* sl__sample_get(sl_sample_id sample_id)
 {
-    sl__sample_t sample = { 0 };
+    sl__sample_t** sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
+    return (sample != NULL) ? *sample : NULL;
+}
 
-    if (channel_count <= 0) {
-        sl_loge("AUDIO: Failed to load sample; Invalid channel count %d", channel_count);
-        return 0;
+static bool sl__sample_post(sl__mixer_command_type_t type, sl__sample_t* sample, int channel, float value)
+{
+    sl__mixer_command_t command = {
+        .type = type,
+        .sample = sample,
+        .channel = channel,
+        .priority = sample->priority,
+        .bus = sample->bus,
+        .value = value
+    };
+
+    return sl__mixer_post(&command);
+}
+
+static void sl__sample_publish(sl__sample_t* sample, int channel, int from, sl__voice_state_t to)
+{
+    // NOTE: The mixer publishes the actual state once the command is executed,
+    //       this only makes the change visible to the API right away.
+    //       A negative 'from' state replaces any state.
+
+    int first = (channel < 0) ? 0 : channel;
+    int last = (channel < 0) ? sample->channel_count : channel + 1;
+
+    for (int i = first; i < last; i++) {
+        if (from < 0) SDL_SetAtomicInt(&sample->channels[i].state, to);
+        else SDL_CompareAndSwapAtomicInt(&sample->channels[i].state, from, to);
     }
+}
 
-    /* --- Load file data --- */
+static sl__sample_t* sl__sample_create(int channel_count)
+{
+    sl__sample_t* sample = SDL_calloc(1, sizeof(sl__sample_t));
+    sl__sample_channel_t* channels = SDL_calloc(channel_count, sizeof(sl__sample_channel_t));
 
-    if (!file_path) {
-        sl_loge("AUDIO: Failed to load sample; Null path");
-        return 0;
+    if (!sample || !channels) {
+        sl_loge("AUDIO: Failed to load sample; Could not allocate memory for channels");
+        SDL_free(channels);
+        SDL_free(sample);
+        return NULL;
     }
 
+    for (int i = 0; i < channel_count; i++) {
+        channels[i].gain = 1.0f;
+        channels[i].pan = 0.0f;
+        channels[i].voice = -1;
+        SDL_SetAtomicInt(&channels[i].state, SL__VOICE_STOPPED);
+    }
+
+    sample->priority = 0;
+    sample->bus = SL_AUDIO_BUS_SFX;
+    sample->channels = channels;
+    sample->channel_count = channel_count;
+
+    return sample;
+}
+
+static bool sl__sample_decode(sl__sample_t* sample, const char* file_path, sl_sample_storage_t storage)
+{
+    // NOTE: Only writes the sample data, can run on a loader thread
+
+    /* --- Load file data --- */
+
     size_t file_size = 0;
     void* file_data = sl_file_load(file_path, &file_size);
     if (file_data == NULL) {
         sl_loge("AUDIO: Failed load sample; Unable to load file '%s'", file_path);
-        return 0;
+        return false;
     }
 
     /* --- Decode all sample data --- */
@@ -55,153 +108,267 @@ sl_sample_id sl_sample_load(const char* file_path, int channel_count)
     case SL__AUDIO_UNKNOWN:
         sl_loge("AUDIO: Failed load sample; Unknown audio format for '%s'", file_path);
         SDL_free(file_data);
-        return 0;
+        return false;
     case SL__AUDIO_WAV:
         if (!sl__audio_sample_load_wav(&raw, file_data, file_size)) {
             sl_loge("AUDIO: Failed to load sample; Unable to load WAV file '%s'", file_path);
             SDL_free(file_data);
-            return 0;
+            return false;
         }
         break;
     case SL__AUDIO_FLAC:
         if (!sl__audio_sample_load_flac(&raw, file_data, file_size)) {
             sl_loge("AUDIO: Failed to load sample; Unable to decode FLAC file '%s'", file_path);
             SDL_free(file_data);
-            return 0;
+            return false;
         }
         break;
     case SL__AUDIO_MP3:
         if (!sl__audio_sample_load_mp3(&raw, file_data, file_size)) {
             sl_loge("AUDIO: Failed to load sample; Unable to decode MP3 file '%s'", file_path);
             SDL_free(file_data);
-            return 0;
+            return false;
         }
         break;
     case SL__AUDIO_OGG:
         if (!sl__audio_sample_load_ogg(&raw, file_data, file_size)) {
             sl_loge("AUDIO: Failed to load sample; Unable to decode OGG file '%s'", file_path);
             SDL_free(file_data);
-            return 0;
+            return false;
         }
         break;
     }
 
     SDL_free(file_data);
 
-    /* --- Create the OpenAL buffer --- */
+    /* --- Convert the PCM to the mixer rate --- */
+
+    SDL_assert(raw.bits == 16);  // Every loader decodes to signed 16-bit
+
+    int pcm_channels = raw.channels;
+
+    SDL_AudioSpec src_spec = {
+        .format = SDL_AUDIO_S16,
+        .channels = pcm_channels,
+        .freq = (int)raw.sample_rate
+    };
+
+    SDL_AudioSpec dst_spec = {
+        .format = SDL_AUDIO_S16,
+        .channels = pcm_channels,
+        .freq = SL__MIXER_SAMPLE_RATE
+    };
+
+    int16_t* pcm = raw.pcm_data;
+    int pcm_size = (int)raw.pcm_data_size;
 
-    alGenBuffers(1, &sample.buffer);
-    if (alGetError() != AL_NO_ERROR) {
-        sl_loge("AUDIO: Failed to load sample; Could not generate OpenAL buffer");
+    if (src_spec.freq != dst_spec.freq) {
+        Uint8* converted = NULL;
+        if (!SDL_ConvertAudioSamples(&src_spec, raw.pcm_data, pcm_size, &dst_spec, &converted, &pcm_size)) {
+            sl_loge("AUDIO: Failed to load sample; Unable to resample '%s'; %s", file_path, SDL_GetError());
+            SDL_free(raw.pcm_data);
+            return false;
+        }
         SDL_free(raw.pcm_data);
-        return 0;
+        pcm = (int16_t*)converted;
     }
 
-    /* --- Load data into the OpenAL buffer --- */
+    int frame_count = pcm_size / (pcm_channels * (int)sizeof(int16_t));
 
-    alBufferData(sample.buffer, raw.format, raw.pcm_data, raw.pcm_data_size, raw.sample_rate);
-    if (alGetError() != AL_NO_ERROR) {
-        sl_loge("AUDIO: Failed to load sample; Could not buffer data to OpenAL");
-        alDeleteBuffers(1, &sample.buffer);
-        SDL_free(raw.pcm_data);
-        return 0;
+    /* --- Encode it if asked to --- */
+
+    uint8_t* adpcm = NULL;
+
+    if (storage == SL_SAMPLE_STORAGE_ADPCM) {
+        adpcm = sl__audio_adpcm_encode(pcm, frame_count, pcm_channels, NULL);
+        if (adpcm == NULL) {
+            sl_loge("AUDIO: Failed to load sample; Unable to encode '%s' to ADPCM", file_path);
+            SDL_free(pcm);
+            return false;
+        }
+        SDL_free(pcm);
+        pcm = NULL;
     }
 
-    /* --- Allocate arrays for channels --- */
+    /* --- Hand the data to the sample --- */
 
-    sample.source_count = channel_count;
-    sample.sources = SDL_malloc(channel_count * sizeof(ALuint));
+    sample->pcm = pcm;
+    sample->adpcm = adpcm;
+    sample->pcm_channels = pcm_channels;
+    sample->frame_count = frame_count;
 
-    if (!sample.sources) {
-        sl_loge("AUDIO: Failed to load sample; Could not allocate memory for channels");
-        alDeleteBuffers(1, &sample.buffer);
-        SDL_free(raw.pcm_data);
-        if (sample.sources) SDL_free(sample.sources);
-        return 0;
+    return true;
+}
+
+static void sl__sample_release(sl__sample_t* sample)
+{
+    // NOTE: If the mixer runs it owns the voices playing this sample and
+    //       may have commands left for it, so it's the one releasing it.
+
+    if (!sl__sample_post(SL__MIXER_CMD_DESTROY, sample, -1, 0.0f)) {
+        sl__audio_sample_free(sample);
     }
+}
 
-    /* --- Create all OpenAL sources --- */
+static bool sl__sample_load_work(sl__load_job_t* job)
+{
+    return sl__sample_decode(job->object, job->file_path, job->storage);
+}
 
-    alGenSources(channel_count, sample.sources);
-    if (alGetError() != AL_NO_ERROR) {
-        sl_loge("AUDIO: Failed to load sample; Could not generate OpenAL sources");
-        alDeleteBuffers(1, &sample.buffer);
-        SDL_free(raw.pcm_data);
-        SDL_free(sample.sources);
+static void sl__sample_load_finish(sl__load_job_t* job)
+{
+    sl__sample_t* sample = job->object;
+    sample->load_job = NULL;
+
+    // Destroyed while loading, it's already out of the registry
+    if (job->cancelled) {
+        sl__sample_release(sample);
+        return;
+    }
+
+    if (!job->success) {
+        sl__registry_remove(&sl__audio.reg_samples, job->id);
+        sl__sample_release(sample);
+    }
+}
+
+/* === Public API === */
+
+sl_sample_id sl_sample_load(const char* file_path, int channel_count)
+{
+    return sl_sample_load_ex(file_path, channel_count, SL_SAMPLE_STORAGE_PCM);
+}
+
+sl_sample_id sl_sample_load_ex(const char* file_path, int channel_count, sl_sample_storage_t storage)
+{
+    if (channel_count <= 0) {
+        sl_loge("AUDIO: Failed to load sample; Invalid channel count %d", channel_count);
         return 0;
     }
 
-    /* --- Attach the buffer to all sources --- */
+    if (!file_path) {
+        sl_loge("AUDIO: Failed to load sample; Null path");
+        return 0;
+    }
 
-    for (int i = 0; i < channel_count; i++) {
-        alSourcei(sample.sources[i], AL_BUFFER, sample.buffer);
-        if (alGetError() != AL_NO_ERROR) {
-            sl_loge("AUDIO: Failed to load sample; Could not attach buffer to source %d", i);
-            // Cleanup already created sources
-            for (int j = 0; j < channel_count; j++) {
-                if (alIsSource(sample.sources[j])) {
-                    alDeleteSources(1, &sample.sources[j]);
-                }
-            }
-            alDeleteBuffers(1, &sample.buffer);
-            SDL_free(raw.pcm_data);
-            SDL_free(sample.sources);
-            return 0;
-        }
-        
-        // Set initial volume for this source
-        float final_volume = sl__audio_calculate_final_sample_volume();
-        alSourcef(sample.sources[i], AL_GAIN, final_volume);
+    /* --- Create the sample and load its data --- */
+
+    sl__sample_t* sample = sl__sample_create(channel_count);
+    if (sample == NULL) {
+        return 0;
+    }
+
+    if (!sl__sample_decode(sample, file_path, storage)) {
+        sl__audio_sample_free(sample);
+        return 0;
     }
 
     /* --- Push sample to the registry --- */
 
-    return sl__registry_add(&sl__audio.reg_samples, &sample);
+    sl_sample_id sample_id = sl__registry_add(&sl__audio.reg_samples, &sample);
+    if (sample_id == 0) {
+        sl_loge("AUDIO: Failed to load sample; Could not register sample");
+        sl__audio_sample_free(sample);
+        return 0;
+    }
+
+    return sample_id;
 }
 
-void sl_sample_destroy(sl_sample_id sample_id)
+sl_sample_id sl_sample_load_async(const char* file_path, int channel_count, sl_sample_storage_t storage,
+                                  sl_load_callback_t callback, void* user_data)
 {
-    sl__sample_t* sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
-    if (sample == NULL) return;
+    if (channel_count <= 0) {
+        sl_loge("AUDIO: Failed to load sample; Invalid channel count %d", channel_count);
+        return 0;
+    }
 
-    for (int i = 0; i < sample->source_count; i++) {
-        if (alIsSource(sample->sources[i])) {
-            ALint state;
-            alGetSourcei(sample->sources[i], AL_SOURCE_STATE, &state);
-            if (state == AL_PLAYING || state == AL_PAUSED) {
-                alSourceStop(sample->sources[i]);
-            }
-            alDeleteSources(1, &sample->sources[i]);
-        }
+    if (!file_path) {
+        sl_loge("AUDIO: Failed to load sample; Null path");
+        return 0;
+    }
+
+    /* --- Register the sample, its data comes later --- */
+
+    sl__sample_t* sample = sl__sample_create(channel_count);
+    if (sample == NULL) {
+        return 0;
     }
 
-    if (alIsBuffer(sample->buffer)) {
-        alDeleteBuffers(1, &sample->buffer);
+    sl_sample_id sample_id = sl__registry_add(&sl__audio.reg_samples, &sample);
+    if (sample_id == 0) {
+        sl_loge("AUDIO: Failed to load sample; Could not register sample");
+        sl__audio_sample_free(sample);
+        return 0;
     }
 
-    if (sample->sources) {
-        SDL_free(sample->sources);
+    /* --- Hand the load to a loader thread --- */
+
+    sl__load_job_t* job = SDL_calloc(1, sizeof(sl__load_job_t));
+    char* path = SDL_strdup(file_path);
+
+    if (!job || !path) {
+        sl_loge("AUDIO: Failed to load sample; Could not allocate the load job");
+        sl__registry_remove(&sl__audio.reg_samples, sample_id);
+        sl__audio_sample_free(sample);
+        SDL_free(path);
+        SDL_free(job);
+        return 0;
     }
 
+    job->work = sl__sample_load_work;
+    job->finish = sl__sample_load_finish;
+    job->object = sample;
+    job->id = sample_id;
+    job->file_path = path;
+    job->storage = storage;
+    job->callback = callback;
+    job->user_data = user_data;
+
+    sample->load_job = job;
+    sl__audio_load_submit(job);
+
+    return sample_id;
+}
+
+sl_load_state_t sl_sample_get_load_state(sl_sample_id sample_id)
+{
+    sl__sample_t* sample = sl__sample_get(sample_id);
+    if (sample == NULL) return SL_LOAD_FAILED;
+
+    return (sample->load_job != NULL) ? SL_LOAD_PENDING : SL_LOAD_READY;
+}
+
+void sl_sample_destroy(sl_sample_id sample_id)
+{
+    sl__sample_t* sample = sl__sample_get(sample_id);
+    if (sample == NULL) return;
+
     sl__registry_remove(&sl__audio.reg_samples, sample_id);
+
+    // A loader thread may still be writing it, released once the load is finished
+    if (sample->load_job != NULL) {
+        sample->load_job->cancelled = true;
+        return;
+    }
+
+    sl__sample_release(sample);
 }
 
 int sl_sample_play(sl_sample_id sample_id, int channel)
 {
-    sl__sample_t* sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
-    if (sample == NULL) return -1;
+    sl__sample_t* sample = sl__sample_get(sample_id);
+    if (sample == NULL || sample->load_job != NULL) return -1;
 
     /* --- Clamp given channel --- */
 
-    channel = SL_MIN(channel, sample->source_count - 1);
+    channel = SL_MIN(channel, sample->channel_count - 1);
 
     /* --- Select a free channel if necessary --- */
 
     if (channel < 0) {
-        for (int i = 0; i < sample->source_count; i++) {
-            ALint state = 0;
-            alGetSourcei(sample->sources[i], AL_SOURCE_STATE, &state);
-            if (state != AL_PLAYING) {
+        for (int i = 0; i < sample->channel_count; i++) {
+            if (SDL_GetAtomicInt(&sample->channels[i].state) != SL__VOICE_PLAYING) {
                 channel = i;
                 break;
             }
@@ -211,17 +378,15 @@ int sl_sample_play(sl_sample_id sample_id, int channel)
         }
     }
 
-    /* --- Stop current playback on this channel if any --- */
-
-    ALint state;
-    alGetSourcei(sample->sources[channel], AL_SOURCE_STATE, &state);
-    if (state == AL_PLAYING || state == AL_PAUSED) {
-        alSourceRewind(sample->sources[channel]);
-    }
+    /* --- Hand it to the mixer, it restarts the channel if already playing --- */
 
-    /* --- Play the sample on the specified channel --- */
+    int previous = SDL_GetAtomicInt(&sample->channels[channel].state);
+    SDL_SetAtomicInt(&sample->channels[channel].state, SL__VOICE_PLAYING);
 
-    alSourcePlay(sample->sources[channel]);
+    if (!sl__sample_post(SL__MIXER_CMD_PLAY, sample, channel, 0.0f)) {
+        SDL_SetAtomicInt(&sample->channels[channel].state, previous);
+        return -1;
+    }
 
     /* --- Return used channel --- */
 
@@ -230,53 +395,52 @@ int sl_sample_play(sl_sample_id sample_id, int channel)
 
 void sl_sample_pause(sl_sample_id sample_id, int channel)
 {
-    sl__sample_t* sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
+    sl__sample_t* sample = sl__sample_get(sample_id);
     if (sample == NULL) return;
 
-    if (channel >= sample->source_count) return;
-    if (channel >= 0) alSourcePause(sample->sources[channel]);
-    else alSourcePausev(sample->source_count, sample->sources);
+    if (channel >= sample->channel_count) return;
+    sl__sample_publish(sample, channel, SL__VOICE_PLAYING, SL__VOICE_PAUSED);
+    sl__sample_post(SL__MIXER_CMD_PAUSE, sample, channel, 0.0f);
 }
 
 void sl_sample_stop(sl_sample_id sample_id, int channel)
 {
-    sl__sample_t* sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
+    sl__sample_t* sample = sl__sample_get(sample_id);
     if (sample == NULL) return;
 
-    if (channel >= sample->source_count) return;
-    if (channel >= 0) alSourceStop(sample->sources[channel]);
-    else alSourceStopv(sample->source_count, sample->sources);
+    if (channel >= sample->channel_count) return;
+    sl__sample_publish(sample, channel, -1, SL__VOICE_STOPPED);
+    sl__sample_post(SL__MIXER_CMD_STOP, sample, channel, 0.0f);
 }
 
 void sl_sample_rewind(sl_sample_id sample_id, int channel)
 {
-    sl__sample_t* sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
+    sl__sample_t* sample = sl__sample_get(sample_id);
     if (sample == NULL) return;
 
-    if (channel >= sample->source_count) return;
-    if (channel >= 0) alSourceRewind(sample->sources[channel]);
-    else alSourceRewindv(sample->source_count, sample->sources);
+    // Rewinding puts the channel back to its initial state, like a stop
+    if (channel >= sample->channel_count) return;
+    sl__sample_publish(sample, channel, -1, SL__VOICE_STOPPED);
+    sl__sample_post(SL__MIXER_CMD_STOP, sample, channel, 0.0f);
 }
 
 bool sl_sample_is_playing(sl_sample_id sample_id, int channel)
 {
-    sl__sample_t* sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
+    sl__sample_t* sample = sl__sample_get(sample_id);
     if (sample == NULL) return false;
 
-    if (channel >= sample->source_count) {
+    if (channel >= sample->channel_count) {
         return false;
     }
 
     if (channel >= 0) {
-        ALenum state = 0;
-        alGetSourcei(sample->sources[channel], AL_SOURCE_STATE, &state);
-        return (state == AL_PLAYING);
+        return SDL_GetAtomicInt(&sample->channels[channel].state) == SL__VOICE_PLAYING;
     }
 
-    for (int i = 0; i < sample->source_count; i++) {
-        ALenum state = 0;
-        alGetSourcei(sample->sources[i], AL_SOURCE_STATE, &state);
-        if (state == AL_PLAYING) return true;
+    for (int i = 0; i < sample->channel_count; i++) {
+        if (SDL_GetAtomicInt(&sample->channels[i].state) == SL__VOICE_PLAYING) {
+            return true;
+        }
     }
 
     return false;
@@ -284,8 +448,47 @@ bool sl_sample_is_playing(sl_sample_id sample_id, int channel)
 
 int sl_sample_get_channel_count(sl_sample_id sample_id)
 {
-    sl__sample_t* sample = sl__registry_get(&sl__audio.reg_samples, sample_id);
+    sl__sample_t* sample = sl__sample_get(sample_id);
     if (sample == NULL) return 0;
 
-    return sample->source_count;
+    return sample->channel_count;
+}
+
+void sl_sample_set_volume(sl_sample_id sample_id, int channel, float volume)
+{
+    sl__sample_t* sample = sl__sample_get(sample_id);
+    if (sample == NULL) return;
+
+    if (channel >= sample->channel_count) return;
+    sl__sample_post(SL__MIXER_CMD_VOLUME, sample, channel, SL_CLAMP(volume, 0.0f, 1.0f));
+}
+
+void sl_sample_set_pan(sl_sample_id sample_id, int channel, float pan)
+{
+    sl__sample_t* sample = sl__sample_get(sample_id);
+    if (sample == NULL) return;
+
+    if (channel >= sample->channel_count) return;
+    sl__sample_post(SL__MIXER_CMD_PAN, sample, channel, SL_CLAMP(pan, -1.0f, 1.0f));
+}
+
+void sl_sample_set_priority(sl_sample_id sample_id, int priority)
+{
+    sl__sample_t* sample = sl__sample_get(sample_id);
+    if (sample == NULL) return;
+
+    sample->priority = priority;
+}
+
+void sl_sample_set_bus(sl_sample_id sample_id, sl_audio_bus_t bus)
+{
+    sl__sample_t* sample = sl__sample_get(sample_id);
+    if (sample == NULL) return;
+
+    if (bus < 0 || bus >= SL_AUDIO_BUS_COUNT) {
+        sl_logw("AUDIO: Invalid bus %d for sample %u", bus, sample_id);
+        return;
+    }
+
+    sample->bus = bus;
 }
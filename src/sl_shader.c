@@ -24,8 +24,41 @@
 #include "./internal/sl__render.h"
 #include "internal/sl__registry.h"
 
+#ifndef SL_BACKEND_SOFTWARE
+
 /* === Shader Templates === */
 
+#define SL__STRINGIFY(x) #x
+#define SL__TOSTRING(x) SL__STRINGIFY(x)
+
+// NOTE: Each palette entry holds the two rows of a 2D affine
+//       transform, batched vertices pick theirs with 'a_transform'.
+//       The first entry is the identity, used by everything else.
+
+#ifdef SL_BACKEND_GL33
+
+// NOTE: 'texture2D' is kept as an alias so that user code
+//       written for the GLES2 backend compiles unchanged.
+
+static const char* sl__shader_vertex_header_str =
+{
+    "#version 330 core\n"
+    "#define VERTEX\n"
+    "#define texture2D texture\n"
+    "layout(location = 0) in vec3 a_position;"
+    "layout(location = 1) in vec2 a_texcoord;"
+    "layout(location = 2) in vec3 a_normal;"
+    "layout(location = 3) in vec4 a_color;"
+    "layout(location = 4) in float a_transform;"
+    "layout(std140) uniform sl_matrices { mat4 u_mvp; vec4 u_transforms[" SL__TOSTRING(SL__TRANSFORM_PALETTE_SIZE) " * 2]; };"
+    "out vec3 v_position;"
+    "out vec2 v_texcoord;"
+    "out vec3 v_normal;"
+    "out vec4 v_color;\n"
+};
+
+#else
+
 static const char* sl__shader_vertex_header_str =
 {
     "#version 100\n"
@@ -34,13 +67,17 @@ static const char* sl__shader_vertex_header_str =
     "attribute vec2 a_texcoord;"
     "attribute vec3 a_normal;"
     "attribute vec4 a_color;"
+    "attribute float a_transform;"
     "uniform mat4 u_mvp;"
+    "uniform vec4 u_transforms[" SL__TOSTRING(SL__TRANSFORM_PALETTE_SIZE) " * 2];"
     "varying vec3 v_position;"
     "varying vec2 v_texcoord;"
     "varying vec3 v_normal;"
     "varying vec4 v_color;\n"
 };
 
+#endif
+
 static const char* sl__shader_vertex_function_str =
 {
     "vec4 vertex(mat4 mvp, vec3 position)"
@@ -53,17 +90,42 @@ static const char* sl__shader_vertex_main_str =
 {
     "\nvoid main()"
     "{"
-    "    v_position = a_position;"
+    "    int t = int(a_transform) * 2;"
+    "    vec3 p = vec3(a_position.xy, 1.0);"
+    "    vec3 position = vec3(dot(u_transforms[t].xyz, p), dot(u_transforms[t + 1].xyz, p), a_position.z);"
+    "    v_position = position;"
     "    v_texcoord = a_texcoord;"
     "    v_normal = a_normal;"
     "    v_color = a_color;"
-    "    gl_Position = vertex(u_mvp, a_position);"
+    "    gl_Position = vertex(u_mvp, position);"
     "}"
 };
 
+#ifdef SL_BACKEND_GL33
+
+static const char* sl__shader_fragment_header_str =
+{
+    "#version 330 core\n"
+    "#define PIXEL\n"
+    "#define SL_DERIVATIVES\n"
+    "#define texture2D texture\n"
+    "uniform sampler2D u_texture;"
+    "in vec3 v_position;"
+    "in vec2 v_texcoord;"
+    "in vec3 v_normal;"
+    "in vec4 v_color;"
+    "out vec4 sl_frag_color;\n"
+};
+
+#else
+
 static const char* sl__shader_fragment_header_str =
 {
     "#version 100\n"
+    "#ifdef GL_OES_standard_derivatives\n"
+    "#extension GL_OES_standard_derivatives : enable\n"
+    "#define SL_DERIVATIVES\n"
+    "#endif\n"
     "#define PIXEL\n"
     "precision mediump float;"
     "uniform sampler2D u_texture;"
@@ -73,6 +135,8 @@ static const char* sl__shader_fragment_header_str =
     "varying vec4 v_color;\n"
 };
 
+#endif
+
 static const char* sl__shader_fragment_function_str =
 {
     "vec4 pixel(vec4 color, sampler2D tex, vec2 uv, vec2 screen_pos)"
@@ -81,6 +145,18 @@ static const char* sl__shader_fragment_function_str =
     "}"
 };
 
+#ifdef SL_BACKEND_GL33
+
+static const char* sl__shader_fragment_main_str =
+{
+    "\nvoid main()"
+    "{"
+    "    sl_frag_color = pixel(v_color, u_texture, v_texcoord, gl_FragCoord.xy);"
+    "}"
+};
+
+#else
+
 static const char* sl__shader_fragment_main_str =
 {
     "\nvoid main()"
@@ -89,6 +165,47 @@ static const char* sl__shader_fragment_main_str =
     "}"
 };
 
+#endif
+
+/* === Built-in SDF Text Shader === */
+
+// NOTE: 'SL_DERIVATIVES' is defined by the pixel header when 'fwidth()'
+//       is available, otherwise a fixed smoothing width is used.
+//       The distance is 0.5 on the glyph edge, the smoothing follows
+//       its screen-space derivative so one atlas stays sharp at any
+//       size. Colors are premultiplied to match the text blend mode.
+
+static const char* sl__shader_sdf_str =
+{
+    "uniform float u_outline_width;"
+    "uniform vec4 u_outline_color;"
+    "uniform vec2 u_shadow_offset;"
+    "uniform vec4 u_shadow_color;"
+    "vec4 sl_premul(vec4 c) { return vec4(c.rgb * c.a, c.a); }"
+    "vec4 pixel(vec4 color, sampler2D tex, vec2 uv, vec2 screen_pos)"
+    "{"
+    "    float d = texture2D(tex, uv).r;\n"
+    "#ifdef SL_DERIVATIVES\n"
+    "    float w = max(0.7 * fwidth(d), 0.001);\n"
+    "#else\n"
+    "    float w = 0.04;\n"
+    "#endif\n"
+    "    float edge = 0.5 - u_outline_width;"
+    "    vec4 result = sl_premul(color) * smoothstep(0.5 - w, 0.5 + w, d);"
+    "    if (u_outline_width > 0.0) {"
+    "        result += sl_premul(u_outline_color) * smoothstep(edge - w, edge + w, d) * (1.0 - result.a);"
+    "    }\n"
+    "#ifdef SL_DERIVATIVES\n"
+    "    if (u_shadow_color.a > 0.0) {"
+    "        vec2 offset = dFdx(uv) * u_shadow_offset.x - dFdy(uv) * u_shadow_offset.y;"
+    "        float shadow = smoothstep(edge - w, edge + w, texture2D(tex, uv - offset).r);"
+    "        result += sl_premul(u_shadow_color) * shadow * (1.0 - result.a);"
+    "    }\n"
+    "#endif\n"
+    "    return result;"
+    "}"
+};
+
 /* === Internal Functions === */
 
 static int sl__shader_has_function(const char* code, const char* function_name)
@@ -212,6 +329,16 @@ static GLuint sl__shader_program_link(const char* vertex_source, const char* fra
 
     glAttachShader(program, vertex_shader);
     glAttachShader(program, fragment_shader);
+
+#ifndef SL_BACKEND_GL33
+    // NOTE: Locations must match the layouts set up by the render module
+    glBindAttribLocation(program, 0, "a_position");
+    glBindAttribLocation(program, 1, "a_texcoord");
+    glBindAttribLocation(program, 2, "a_normal");
+    glBindAttribLocation(program, 3, "a_color");
+    glBindAttribLocation(program, 4, "a_transform");
+#endif
+
     glLinkProgram(program);
 
     int success;
@@ -230,10 +357,27 @@ static GLuint sl__shader_program_link(const char* vertex_source, const char* fra
     return program;
 }
 
+#endif // SL_BACKEND_SOFTWARE
+
 /* === Public API === */
 
 sl_shader_id sl_shader_create(const char* code)
 {
+#ifdef SL_BACKEND_SOFTWARE
+
+    // NOTE: The rasterizer only implements the default shader,
+    //       custom shaders are registered but render like it.
+
+    if (code != NULL) {
+        sl_logw("SHADER: Custom shaders are not supported by the software backend; The default shader will be used");
+    }
+
+    sl__shader_t shader = { .id = 0, .loc_mvp = -1, .loc_transforms = -1 };
+
+    return sl__registry_add(&sl__render.reg_shaders, &shader);
+
+#else
+
     char* vertex_source = NULL;
     char* fragment_source = NULL;
     GLuint program = 0;
@@ -272,9 +416,17 @@ sl_shader_id sl_shader_create(const char* code)
 
     sl__shader_t shader = {
         .id = program,
-        .loc_mvp = glGetUniformLocation(program, "u_mvp")
+        .loc_mvp = glGetUniformLocation(program, "u_mvp"),
+        .loc_transforms = glGetUniformLocation(program, "u_transforms")
     };
 
+#ifdef SL_BACKEND_GL33
+    GLuint matrices_index = glGetUniformBlockIndex(program, "sl_matrices");
+    if (matrices_index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, matrices_index, SL__UBO_BINDING_MATRICES);
+    }
+#endif
+
     result = sl__registry_add(&sl__render.reg_shaders, &shader);
 
 cleanup:
@@ -282,6 +434,18 @@ cleanup:
     SDL_free(fragment_source);
 
     return result;
+
+#endif // SL_BACKEND_SOFTWARE
+}
+
+sl_shader_id sl__shader_create_sdf(void)
+{
+#ifdef SL_BACKEND_SOFTWARE
+    // NOTE: The rasterizer only implements the default shader
+    return 0;
+#else
+    return sl_shader_create(sl__shader_sdf_str);
+#endif
 }
 
 sl_shader_id sl_shader_load(const char* file_path)
@@ -294,7 +458,7 @@ sl_shader_id sl_shader_load(const char* file_path)
 
 void sl_shader_destroy(sl_shader_id shader)
 {
-    if (shader == 0 || shader == sl__render.default_shader) {
+    if (shader == 0 || shader == sl__render.default_shader || shader == sl__render.sdf_shader) {
         return;
     }
 
@@ -305,7 +469,10 @@ void sl_shader_destroy(sl_shader_id shader)
     sl__shader_t* data = sl__registry_get(&sl__render.reg_shaders, shader);
     if (data == NULL) return;
 
+#ifndef SL_BACKEND_SOFTWARE
     glDeleteProgram(data->id);
+#endif
+
     sl__registry_remove(&sl__render.reg_shaders, shader);
 }
 
@@ -314,5 +481,10 @@ int sl_shader_uniform(sl_shader_id shader, const char* name)
     sl__shader_t* data = sl__registry_get(&sl__render.reg_shaders, shader);
     if (!data) return -1;
 
+#ifdef SL_BACKEND_SOFTWARE
+    (void)name;
+    return -1;
+#else
     return glGetUniformLocation(data->id, name);
+#endif
 }
@@ -20,214 +20,292 @@
 #include <smol.h>
 
 #include "./internal/sl__audio.h"
-#include <SDL3/SDL_timer.h>
 
-/* === Public API === */
+/* === Helper Functions === */
 
-sl_stream_id sl_stream_load(const char* file_path)
+static sl__stream_t* sl__stream_get_any(sl_stream_id stream)
 {
-    sl__stream_t stream = { 0 };
+    sl__stream_t** data = sl__registry_get(&sl__audio.reg_streams, stream);
+    return (data != NULL) ? *data : NULL;
+}
 
-    /* --- Load file data --- */
+static sl__stream_t* sl__stream_get(sl_stream_id stream)
+{
+    // Pending streams have no decoder yet, only a few calls accept them
+    sl__stream_t* data = sl__stream_get_any(stream);
+    return (data != NULL && data->load_job == NULL) ? data : NULL;
+}
 
-    if (!file_path) {
-        sl_loge("AUDIO: Invalid file path provided to sl_stream_load");
+static size_t sl__stream_seconds_to_frame(const sl__stream_t* stream, double seconds)
+{
+    if (seconds <= 0.0) {
         return 0;
     }
 
-    size_t file_size = 0;
-    void* file_data = sl_file_load(file_path, &file_size);
-    if (!file_data) {
-        sl_loge("AUDIO: Failed to load stream file: %s", file_path);
-        return 0;
+    size_t frame = (size_t)(seconds * stream->decoder.sample_rate + 0.5);
+
+    // The total can be unknown, in which case the decoder clamps the seek itself
+    if (stream->decoder.total_samples > 0) {
+        frame = SL_MIN(frame, stream->decoder.total_samples);
     }
 
-    /* --- Check file format --- */
+    return frame;
+}
 
-    sl__audio_format_t format = sl__audio_get_format((const uint8_t*)file_data, file_size);
-    if (format == SL__AUDIO_UNKNOWN) {
-        sl_loge("AUDIO: Unknown or unsupported audio format in file: %s", file_path);
-        SDL_free(file_data);
-        return 0;
+static sl__stream_t* sl__stream_create(void)
+{
+    sl__stream_t* stream = SDL_calloc(1, sizeof(sl__stream_t));
+    if (!stream) {
+        sl_loge("AUDIO: Failed to allocate stream");
+        return NULL;
     }
 
-    /* --- Initialize the decoder --- */
+    // NOTE: The ring is filled by the decoder workers on the first play
 
-    if (!sl__audio_stream_decoder_init(&stream.decoder, file_data, file_size, format)) {
-        sl_loge("AUDIO: Failed to initialize decoder for file: %s", file_path);
-        SDL_free(file_data);
-        return 0;
+    SDL_SetAtomicInt(&stream->state, SL__STREAM_STOPPED);
+    stream->active_index = -1;
+    stream->is_paused = false;
+    stream->should_loop = false;
+    stream->volume = 1.0f;
+
+    sl__audio_update_stream_volume(stream);
+
+    return stream;
+}
+
+static bool sl__stream_open(sl__stream_t* stream, const char* file_path, const sl_stream_desc_t* buffering)
+{
+    /* --- Open the file through its decoder --- */
+
+    // NOTE: The file stays open and is read as the stream plays
+
+    if (!sl__audio_stream_decoder_open(&stream->decoder, file_path)) {
+        sl_loge("AUDIO: Failed to open stream file: %s", file_path);
+        return false;
     }
 
-    SDL_free(file_data); // We can free file_data now because the decoders have copied the data
+    /* --- Allocate the decode-ahead ring --- */
 
-    /* --- Create OpenAL buffers --- */
+    stream->buffer_count = buffering->buffer_count;
+    stream->buffer_frames = SL_MAX(1, (int)(buffering->buffer_duration * stream->decoder.sample_rate + 0.5f));
 
-    alGenBuffers(SL__stream_BUFFER_COUNT, stream.buffers);
-    if (alGetError() != AL_NO_ERROR) {
-        sl_loge("AUDIO: Failed to generate OpenAL buffers for stream");
-        stream.decoder.close_func(stream.decoder.handle);
-        return 0;
+    size_t ring_size = (size_t)stream->buffer_count * stream->buffer_frames * stream->decoder.channels * sizeof(int16_t);
+    stream->ring_pcm = SDL_malloc(ring_size);
+    if (!stream->ring_pcm) {
+        sl_loge("AUDIO: Failed to allocate stream decode ring");
+        sl__audio_stream_decoder_close(&stream->decoder);
+        return false;
     }
 
-    /* --- Create the OpenAL source --- */
+    return true;
+}
+
+static void sl__stream_discard(sl__stream_t* stream)
+{
+    // Releases an opened stream never handed to the stream thread
+    sl__audio_stream_decoder_close(&stream->decoder);
+    SDL_free(stream->ring_pcm);
+    SDL_free(stream);
+}
 
-    alGenSources(1, &stream.source);
-    if (alGetError() != AL_NO_ERROR) {
-        sl_loge("AUDIO: Failed to generate OpenAL source for stream");
-        alDeleteBuffers(SL__stream_BUFFER_COUNT, stream.buffers);
-        stream.decoder.close_func(stream.decoder.handle);
-        return 0;
+static bool sl__stream_load_work(sl__load_job_t* job)
+{
+    return sl__stream_open(job->object, job->file_path, &job->buffering);
+}
+
+static void sl__stream_load_finish(sl__load_job_t* job)
+{
+    sl__stream_t* stream = job->object;
+    stream->load_job = NULL;
+
+    // Destroyed while loading, it's already out of the registry
+    if (job->cancelled) {
+        if (job->success) sl__stream_discard(stream);
+        else SDL_free(stream);
+        return;
     }
 
-    /* --- Initialize states --- */
+    if (!job->success) {
+        sl__registry_remove(&sl__audio.reg_streams, job->id);
+        SDL_free(stream);
+    }
+}
 
-    stream.is_paused = false;
-    stream.should_loop = false;
-    stream.volume = 1.0f;
-    stream.assigned_buffer_index = -1;
+/* === Public API === */
 
-    /* --- Pre-fill buffers for first playback --- */
+sl_stream_id sl_stream_load(const char* file_path)
+{
+    return sl_stream_load_ex(file_path, &sl__audio.stream_desc);
+}
 
-    sl__audio_stream_prepare_buffers(&stream);
+sl_stream_id sl_stream_load_ex(const char* file_path, const sl_stream_desc_t* desc)
+{
+    /* --- Resolve the buffering --- */
+
+    sl_stream_desc_t buffering = sl__audio.stream_desc;
+    if (desc != NULL) {
+        sl__audio_stream_desc_resolve(&buffering, desc);
+    }
 
-    /* --- Set initial volume --- */
+    if (!file_path) {
+        sl_loge("AUDIO: Invalid file path provided to sl_stream_load");
+        return 0;
+    }
 
-    float volume = sl__audio_calculate_final_stream_volume(stream.volume);
-    alSourcef(stream.source, AL_GAIN, volume);
+    /* --- Allocate the stream and open its file --- */
+
+    sl__stream_t* stream = sl__stream_create();
+    if (!stream) {
+        return 0;
+    }
+
+    if (!sl__stream_open(stream, file_path, &buffering)) {
+        SDL_free(stream);
+        return 0;
+    }
 
     sl_stream_id stream_id = sl__registry_add(&sl__audio.reg_streams, &stream);
     if (stream_id == 0) {
         sl_loge("AUDIO: Failed to register stream in registry");
-        alDeleteSources(1, &stream.source);
-        alDeleteBuffers(SL__stream_BUFFER_COUNT, stream.buffers);
-        stream.decoder.close_func(stream.decoder.handle);
+        sl__audio_stream_free(stream);
         return 0;
     }
 
     return stream_id;
 }
 
-void sl_stream_destroy(sl_stream_id stream)
+sl_stream_id sl_stream_load_async(const char* file_path, const sl_stream_desc_t* desc,
+                                  sl_load_callback_t callback, void* user_data)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
-    if (data == NULL) {
-        sl_logw("AUDIO: Attempted to destroy invalid stream [ID %d]", stream);
-        return;
+    /* --- Resolve the buffering --- */
+
+    sl_stream_desc_t buffering = sl__audio.stream_desc;
+    if (desc != NULL) {
+        sl__audio_stream_desc_resolve(&buffering, desc);
     }
 
-    /* --- Make sure this stream is not currently playing --- */
+    if (!file_path) {
+        sl_loge("AUDIO: Invalid file path provided to sl_stream_load_async");
+        return 0;
+    }
 
-    if (sl__audio.stream_thread_initialized) {
-        SDL_LockMutex(sl__audio.stream_mutex);
-        if (sl__audio_stream_is_active(stream)) {
-            sl__audio_stream_remove_active(stream);
-            SDL_SignalCondition(sl__audio.stream_condition);
-        }
-        SDL_UnlockMutex(sl__audio.stream_mutex);
+    /* --- Register the stream, its file is opened later --- */
+
+    sl__stream_t* stream = sl__stream_create();
+    if (!stream) {
+        return 0;
     }
 
-    /* --- Stop the OpenAL source --- */
+    sl_stream_id stream_id = sl__registry_add(&sl__audio.reg_streams, &stream);
+    if (stream_id == 0) {
+        sl_loge("AUDIO: Failed to register stream in registry");
+        SDL_free(stream);
+        return 0;
+    }
 
-    alSourceStop(data->source);
+    /* --- Hand the load to a loader thread --- */
 
-    /* --- Flush queue buffers --- */
+    sl__load_job_t* job = SDL_calloc(1, sizeof(sl__load_job_t));
+    char* path = SDL_strdup(file_path);
 
-    sl__audio_stream_unqueue_all_buffers(data);
+    if (!job || !path) {
+        sl_loge("AUDIO: Failed to allocate stream load job");
+        sl__registry_remove(&sl__audio.reg_streams, stream_id);
+        SDL_free(stream);
+        SDL_free(path);
+        SDL_free(job);
+        return 0;
+    }
 
-    /* --- Clean OpenAL resources --- */
+    job->work = sl__stream_load_work;
+    job->finish = sl__stream_load_finish;
+    job->object = stream;
+    job->id = stream_id;
+    job->file_path = path;
+    job->buffering = buffering;
+    job->callback = callback;
+    job->user_data = user_data;
 
-    alDeleteSources(1, &data->source);
-    alDeleteBuffers(SL__stream_BUFFER_COUNT, data->buffers);
+    stream->load_job = job;
+    sl__audio_load_submit(job);
 
-    /* --- Clean the decoder and associated data --- */
+    return stream_id;
+}
+
+sl_load_state_t sl_stream_get_load_state(sl_stream_id stream)
+{
+    sl__stream_t* data = sl__stream_get_any(stream);
+    if (data == NULL) return SL_LOAD_FAILED;
 
-    if (data->decoder.handle) {
-        data->decoder.close_func(data->decoder.handle);
-        data->decoder.handle = NULL;
+    return (data->load_job != NULL) ? SL_LOAD_PENDING : SL_LOAD_READY;
+}
+
+void sl_stream_destroy(sl_stream_id stream)
+{
+    sl__stream_t* data = sl__stream_get_any(stream);
+    if (data == NULL) {
+        sl_logw("AUDIO: Attempted to destroy invalid stream [ID %d]", stream);
+        return;
     }
 
-    /* --- Release decode buffer if assigned --- */
+    sl__registry_remove(&sl__audio.reg_streams, stream);
 
-    if (data->assigned_buffer_index >= 0) {
-        sl__audio_stream_release_decode_buffer(data->assigned_buffer_index);
+    // A loader thread may still be opening it, released once the load is finished
+    if (data->load_job != NULL) {
+        data->load_job->cancelled = true;
+        return;
     }
 
-    /* --- Remove from registry --- */
+    /* --- Release it here or let the stream thread do it --- */
 
-    sl__registry_remove(&sl__audio.reg_streams, stream);
+    // NOTE: Commands are executed in order, so once posted no earlier
+    //       command can still refer to this stream after its release.
+
+    if (sl__audio.stream_thread_initialized) {
+        sl__audio_stream_post(SL__STREAM_CMD_DESTROY, data, false);
+    }
+    else {
+        sl__audio_stream_free(data);
+    }
 }
 
 void sl_stream_play(sl_stream_id stream)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get(stream);
     if (data == NULL) {
         sl_logw("AUDIO: Attempted to play invalid stream [ID %d]", stream);
         return;
     }
 
-    if (!sl__audio_stream_thread_init()) {
-        sl_loge("AUDIO: Failed to initialize stream streaming thread");
-        return;
-    }
+    // NOTE: Set before posting, a short stream can be played through and
+    //       marked stopped by the stream thread before this call returns.
+
+    int previous = SDL_SetAtomicInt(&data->state, SL__STREAM_PLAYING);
 
-    SDL_LockMutex(sl__audio.stream_mutex);
-
-    // Resume if paused
-    if (sl__audio_stream_is_active(stream) && data->is_paused) {
-        data->is_paused = false;
-        alSourcePlay(data->source);
-        float volume = sl__audio_calculate_final_stream_volume(data->volume);
-        alSourcef(data->source, AL_GAIN, volume);
-    } else {
-        // Add to active list if not already present
-        if (!sl__audio_stream_is_active(stream)) {
-            if (!sl__audio_stream_add_active(stream)) {
-                sl_loge("AUDIO: Failed to add stream to active list");
-                SDL_UnlockMutex(sl__audio.stream_mutex);
-                return;
-            }
-        }
-
-        data->is_paused = false;
-        float volume = sl__audio_calculate_final_stream_volume(data->volume);
-        alSourcef(data->source, AL_GAIN, volume);
-        alSourcePlay(data->source);
-    }
-
-    SDL_SignalCondition(sl__audio.stream_condition);
-    SDL_UnlockMutex(sl__audio.stream_mutex);
+    if (!sl__audio_stream_post(SL__STREAM_CMD_PLAY, data, false)) {
+        SDL_SetAtomicInt(&data->state, previous);
+    }
 }
 
 void sl_stream_pause(sl_stream_id stream)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get(stream);
     if (data == NULL) {
         sl_logw("AUDIO: Attempted to pause invalid stream [ID %d]", stream);
         return;
     }
 
-    if (!sl__audio.stream_thread_initialized) {
-        sl_logw("AUDIO: Cannot pause stream [ID %d], streaming thread not initialized", stream);
+    if (!SDL_CompareAndSwapAtomicInt(&data->state, SL__STREAM_PLAYING, SL__STREAM_PAUSED)) {
+        sl_logw("AUDIO: Cannot pause stream [ID %d] (not currently playing)", stream);
         return;
     }
 
-    SDL_LockMutex(sl__audio.stream_mutex);
-
-    if (sl__audio_stream_is_active(stream) && !data->is_paused) {
-        data->is_paused = true;
-        alSourcePause(data->source);
-    }
-    else {
-        sl_logw("AUDIO: Cannot pause stream [ID %d] (not currently active or already paused)", stream);
-    }
-
-    SDL_UnlockMutex(sl__audio.stream_mutex);
+    sl__audio_stream_post(SL__STREAM_CMD_PAUSE, data, false);
 }
 
 void sl_stream_stop(sl_stream_id stream)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get(stream);
     if (data == NULL) {
         sl_logw("AUDIO: Attempted to stop invalid stream [ID %d]", stream);
         return;
@@ -238,127 +316,113 @@ void sl_stream_stop(sl_stream_id stream)
         return;
     }
 
-    SDL_LockMutex(sl__audio.stream_mutex);
-
-    if (sl__audio_stream_is_active(stream)) {
-        sl__audio_stream_remove_active(stream);
-        
-        alSourceStop(data->source);
-        sl__audio_stream_unqueue_all_buffers(data);
-        
-        // Release decode buffer
-        if (data->assigned_buffer_index >= 0) {
-            sl__audio_stream_release_decode_buffer(data->assigned_buffer_index);
-            data->assigned_buffer_index = -1;
-        }
-        
-        // Reset stream state
-        data->decoder.seek_func(data->decoder.handle, 0);
-        data->decoder.current_sample = 0;
-        data->decoder.is_finished = false;
-        data->is_paused = false;
-        
-        sl__audio_stream_prepare_buffers(data);
-    }
-
-    SDL_UnlockMutex(sl__audio.stream_mutex);
+    SDL_SetAtomicInt(&data->state, SL__STREAM_STOPPED);
+    sl__audio_stream_post(SL__STREAM_CMD_STOP, data, false);
 }
 
 void sl_stream_rewind(sl_stream_id stream)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get(stream);
     if (data == NULL) {
         sl_logw("AUDIO: Attempted to rewind invalid stream [ID %d]", stream);
         return;
     }
 
     if (!sl__audio.stream_thread_initialized) {
-        // If thread not initialized, just rewind the decoder silently
+        // If thread not initialized, nothing else owns the decoder, just rewind it
         data->decoder.seek_func(data->decoder.handle, 0);
         data->decoder.current_sample = 0;
         data->decoder.is_finished = false;
-        sl__audio_stream_prepare_buffers(data);
         return;
     }
 
-    SDL_LockMutex(sl__audio.stream_mutex);
-
-    if (sl__audio_stream_is_active(stream)) {
-        bool wasPaused = data->is_paused;
-
-        // Temporarily stop the source
-        alSourceStop(data->source);
-
-        // Flush queue buffers
-        sl__audio_stream_unqueue_all_buffers(data);
-
-        // Rewind the decoder
-        data->decoder.seek_func(data->decoder.handle, 0);
-        data->decoder.current_sample = 0;
-        data->decoder.is_finished = false;
+    sl__audio_stream_post(SL__STREAM_CMD_REWIND, data, false);
+}
 
-        // Pre-fill the buffers again
-        sl__audio_stream_prepare_buffers(data);
+void sl_stream_seek(sl_stream_id stream, double seconds)
+{
+    sl__stream_t* data = sl__stream_get(stream);
+    if (data == NULL) {
+        sl_logw("AUDIO: Attempted to seek invalid stream [ID %d]", stream);
+        return;
+    }
 
-        // Resume playing if it was not paused
-        if (!wasPaused) {
-            alSourcePlay(data->source);
-        }
+    size_t frame = sl__stream_seconds_to_frame(data, seconds);
 
-        // Wake up thread
-        SDL_SignalCondition(sl__audio.stream_condition);
-    }
-    else {
-        // Not currently active, just rewind the decoder
-        data->decoder.seek_func(data->decoder.handle, 0);
-        data->decoder.current_sample = 0;
+    if (!sl__audio.stream_thread_initialized) {
+        // If thread not initialized, nothing else owns the decoder, just seek it
+        data->decoder.seek_func(data->decoder.handle, frame);
+        data->decoder.current_sample = frame;
         data->decoder.is_finished = false;
-        sl__audio_stream_prepare_buffers(data);
+        return;
     }
 
-    SDL_UnlockMutex(sl__audio.stream_mutex);
+    sl__audio_stream_post_command(&(sl__stream_command_t) {
+        .type = SL__STREAM_CMD_SEEK,
+        .stream = data,
+        .frame = frame
+    });
 }
 
 bool sl_stream_is_playing(sl_stream_id stream)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get(stream);
     if (data == NULL) {
         return false;
     }
 
-    if (!sl__audio.stream_thread_initialized) {
-        return false;
-    }
-
-    SDL_LockMutex(sl__audio.stream_mutex);
-    bool is_active = sl__audio_stream_is_active(stream);
-    bool is_paused = data->is_paused;
-    SDL_UnlockMutex(sl__audio.stream_mutex);
-
-    return is_active && !is_paused;
+    return SDL_GetAtomicInt(&data->state) == SL__STREAM_PLAYING;
 }
 
 void sl_stream_loop(sl_stream_id stream, bool loop)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get(stream);
     if (data == NULL) {
         sl_logw("AUDIO: Attempted to set loop on invalid stream [ID %d]", stream);
         return;
     }
 
     if (sl__audio.stream_thread_initialized) {
-        SDL_LockMutex(sl__audio.stream_mutex);
-        data->should_loop = loop;
-        SDL_UnlockMutex(sl__audio.stream_mutex);
+        sl__audio_stream_post(SL__STREAM_CMD_LOOP, data, loop);
     }
     else {
         data->should_loop = loop;
     }
 }
 
+void sl_stream_set_loop_points(sl_stream_id stream, double start, double end)
+{
+    sl__stream_t* data = sl__stream_get(stream);
+    if (data == NULL) {
+        sl_logw("AUDIO: Attempted to set loop points on invalid stream [ID %d]", stream);
+        return;
+    }
+
+    size_t loop_start = sl__stream_seconds_to_frame(data, start);
+    size_t loop_end = (end > 0.0) ? sl__stream_seconds_to_frame(data, end) : 0;
+
+    if (loop_end > 0 && loop_end <= loop_start) {
+        sl_logw("AUDIO: Invalid loop points on stream [ID %d], loop end must come after loop start", stream);
+        return;
+    }
+
+    if (sl__audio.stream_thread_initialized) {
+        sl__audio_stream_post_command(&(sl__stream_command_t) {
+            .type = SL__STREAM_CMD_LOOP_POINTS,
+            .stream = data,
+            .frame = loop_start,
+            .frame_end = loop_end
+        });
+    }
+    else {
+        data->loop_start = loop_start;
+        data->loop_end = loop_end;
+    }
+}
+
 void sl_stream_set_volume(sl_stream_id stream, float volume)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get_any(stream);
     if (data == NULL) {
         sl_logw("AUDIO: Attempted to set volume on invalid stream [ID %d]", stream);
         return;
@@ -368,39 +432,18 @@ void sl_stream_set_volume(sl_stream_id stream, float volume)
     if (volume < 0.0f) volume = 0.0f;
     if (volume > 1.0f) volume = 1.0f;
 
-    if (sl__audio.stream_thread_initialized) {
-        SDL_LockMutex(sl__audio.stream_mutex);
-        data->volume = volume;
-
-        // Update OpenAL source volume immediately if this stream is currently active
-        if (sl__audio_stream_is_active(stream)) {
-            float final_volume = sl__audio_calculate_final_stream_volume(volume);
-            alSourcef(data->source, AL_GAIN, final_volume);
-        }
+    data->volume = volume;
 
-        SDL_UnlockMutex(sl__audio.stream_mutex);
-    }
-    else {
-        data->volume = volume;
-    }
+    sl__audio_update_stream_volume(data);
 }
 
 float sl_stream_get_volume(sl_stream_id stream)
 {
-    sl__stream_t* data = sl__registry_get(&sl__audio.reg_streams, stream);
+    sl__stream_t* data = sl__stream_get_any(stream);
     if (data == NULL) {
         sl_logw("AUDIO: Attempted to get volume from invalid stream [ID %d]", stream);
         return 0.0f;
     }
 
-    float volume;
-    if (sl__audio.stream_thread_initialized) {
-        SDL_LockMutex(sl__audio.stream_mutex);
-        volume = data->volume;
-        SDL_UnlockMutex(sl__audio.stream_mutex);
-    } else {
-        volume = data->volume;
-    }
-
-    return volume;
+    return data->volume;
 }
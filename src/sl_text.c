@@ -17,9 +17,102 @@
  *   3. This notice may not be removed or altered from any source distribution.
  */
 
+#include <smol.h>
+
 #include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_thread.h>
 #include <SDL3/SDL_time.h>
 
+/* === Format Ring === */
+
+// NOTE: Each thread formats into its own ring of buffers, so a result
+//       stays valid for the next SL_TEXT_FORMAT_RING_SIZE - 1 calls of
+//       that thread. Buffers only grow and are freed on thread exit.
+
+#define SL__TEXT_FORMAT_MIN_SIZE 512
+
+typedef struct {
+    char* buffers[SL_TEXT_FORMAT_RING_SIZE];
+    int sizes[SL_TEXT_FORMAT_RING_SIZE];
+    int next;
+} sl__text_format_ring_t;
+
+static SDL_TLSID sl__text_format_tls;
+
+static void sl__text_format_ring_free(void* data)
+{
+    sl__text_format_ring_t* ring = data;
+
+    for (int i = 0; i < SL_TEXT_FORMAT_RING_SIZE; i++) {
+        SDL_free(ring->buffers[i]);
+    }
+
+    SDL_free(ring);
+}
+
+static char* sl__text_format_buffer(int size, int* buffer_size)
+{
+    // NOTE: Returns the next buffer of the ring with at least 'size'
+    //       bytes if possible, or the largest one it could get.
+
+    sl__text_format_ring_t* ring = SDL_GetTLS(&sl__text_format_tls);
+
+    if (ring == NULL) {
+        ring = SDL_calloc(1, sizeof(sl__text_format_ring_t));
+        if (ring == NULL) {
+            return NULL;
+        }
+        if (!SDL_SetTLS(&sl__text_format_tls, ring, sl__text_format_ring_free)) {
+            SDL_free(ring);
+            return NULL;
+        }
+    }
+
+    int slot = ring->next;
+    ring->next = (ring->next + 1) % SL_TEXT_FORMAT_RING_SIZE;
+
+    if (ring->sizes[slot] < size) {
+        int new_size = SL_MAX(ring->sizes[slot], SL__TEXT_FORMAT_MIN_SIZE);
+        while (new_size < size) new_size *= 2;
+
+        char* buffer = SDL_realloc(ring->buffers[slot], new_size);
+        if (buffer != NULL) {
+            ring->buffers[slot] = buffer;
+            ring->sizes[slot] = new_size;
+        }
+    }
+
+    *buffer_size = ring->sizes[slot];
+
+    return ring->buffers[slot];
+}
+
+static bool sl__text_builder_reserve(sl_text_builder_t* builder, int length)
+{
+    // NOTE: 'length' excludes the null terminator
+
+    if (length < builder->capacity) {
+        return true;
+    }
+
+    int capacity = SL_MAX(builder->capacity, 64);
+    while (capacity <= length) capacity *= 2;
+
+    char* data = SDL_realloc(builder->data, capacity);
+    if (data == NULL) {
+        return false;
+    }
+
+    if (builder->data == NULL) {
+        data[0] = '\0';
+    }
+
+    builder->data = data;
+    builder->capacity = capacity;
+
+    return true;
+}
+
 /* === Public API === */
 
 void sl_text_to_upper(char* str)
@@ -74,23 +167,35 @@ char* sl_text_contains(const char* str, const char* keyword)
 
 const char* sl_text_format(const char* text, ...)
 {
-    #define SL_FMT_BUFFER_LENGTH 512
-    static char buffer[SL_FMT_BUFFER_LENGTH];
+    int size = 0;
+    char* buffer = NULL;
 
     if (!text) {
-        buffer[0] = '\0';
-        return buffer;
+        buffer = sl__text_format_buffer(1, &size);
+        if (buffer) buffer[0] = '\0';
+        return buffer ? buffer : "";
     }
 
-    va_list args;
-    va_start(args, text);
-    int req_byte_count = SDL_vsnprintf(buffer, SL_FMT_BUFFER_LENGTH, text, args);
-    va_end(args);
+    va_list args1, args2;
+    va_start(args1, text);
+    va_copy(args2, args1);
 
-    if (req_byte_count >= SL_FMT_BUFFER_LENGTH) {
-        if (SL_FMT_BUFFER_LENGTH >= 4) {
-            strcpy(buffer + SL_FMT_BUFFER_LENGTH - 4, "...");
-        }
+    int req_byte_count = SDL_vsnprintf(NULL, 0, text, args1) + 1;
+    va_end(args1);
+
+    buffer = sl__text_format_buffer(req_byte_count, &size);
+    if (buffer) {
+        SDL_vsnprintf(buffer, size, text, args2);
+    }
+    va_end(args2);
+
+    if (buffer == NULL) {
+        return "";
+    }
+
+    // Only happens if the buffer failed to grow
+    if (req_byte_count > size && size >= 4) {
+        strcpy(buffer + size - 4, "...");
     }
 
     return buffer;
@@ -120,13 +225,15 @@ char* sl_text_format_dynamic(const char* text, ...)
 
 const char* sl_text_format_date_time(int64_t time)
 {
-    static char date_time_str[32];
+    int size = 0;
+    char* date_time_str = sl__text_format_buffer(32, &size);
+    if (date_time_str == NULL) return "";
 
     SDL_DateTime date_time = { 0 };
     SDL_TimeToDateTime(time, &date_time, true);
 
     SDL_snprintf(
-        date_time_str, sizeof(date_time_str), "%04d-%02d-%02d %02d:%02d:%02d",
+        date_time_str, size, "%04d-%02d-%02d %02d:%02d:%02d",
         date_time.year, date_time.month + 1, date_time.day,
         date_time.hour, date_time.minute, date_time.second
     );
@@ -136,13 +243,15 @@ const char* sl_text_format_date_time(int64_t time)
 
 const char* sl_text_format_date(int64_t time)
 {
-    static char date_str[16];
+    int size = 0;
+    char* date_str = sl__text_format_buffer(16, &size);
+    if (date_str == NULL) return "";
 
     SDL_DateTime date_time = { 0 };
     SDL_TimeToDateTime(time, &date_time, true);
 
     SDL_snprintf(
-        date_str, sizeof(date_str), "%04d-%02d-%02d",
+        date_str, size, "%04d-%02d-%02d",
         date_time.year, date_time.month + 1, date_time.day
     );
 
@@ -151,13 +260,15 @@ const char* sl_text_format_date(int64_t time)
 
 const char* sl_text_format_time(int64_t time)
 {
-    static char time_str[16];
+    int size = 0;
+    char* time_str = sl__text_format_buffer(16, &size);
+    if (time_str == NULL) return "";
 
     SDL_DateTime date_time = { 0 };
     SDL_TimeToDateTime(time, &date_time, true);
 
     SDL_snprintf(
-        time_str, sizeof(time_str), "%02d:%02d:%02d",
+        time_str, size, "%02d:%02d:%02d",
         date_time.hour, date_time.minute, date_time.second
     );
 
@@ -294,3 +405,107 @@ void sl_text_trim(char* str)
     while (end > start && SDL_isspace((uint8_t)*end)) *end-- = '\0';
     SDL_memmove(str, start, end - start + 2);
 }
+
+bool sl_text_builder_create(sl_text_builder_t* builder, int capacity)
+{
+    *builder = (sl_text_builder_t) { 0 };
+
+    if (!sl__text_builder_reserve(builder, SL_MAX(capacity, 1) - 1)) {
+        sl_loge("TEXT: Failed to create text builder; Out of memory");
+        return false;
+    }
+
+    return true;
+}
+
+void sl_text_builder_destroy(sl_text_builder_t* builder)
+{
+    SDL_free(builder->data);
+    *builder = (sl_text_builder_t) { 0 };
+}
+
+void sl_text_builder_clear(sl_text_builder_t* builder)
+{
+    builder->length = 0;
+
+    if (builder->data != NULL) {
+        builder->data[0] = '\0';
+    }
+}
+
+bool sl_text_builder_append(sl_text_builder_t* builder, const char* text)
+{
+    if (!text) return false;
+
+    return sl_text_builder_append_n(builder, text, (int)SDL_strlen(text));
+}
+
+bool sl_text_builder_append_n(sl_text_builder_t* builder, const char* text, int length)
+{
+    if (!text || length < 0) return false;
+
+    if (!sl__text_builder_reserve(builder, builder->length + length)) {
+        return false;
+    }
+
+    SDL_memcpy(builder->data + builder->length, text, length);
+    builder->length += length;
+    builder->data[builder->length] = '\0';
+
+    return true;
+}
+
+bool sl_text_builder_append_format(sl_text_builder_t* builder, const char* format, ...)
+{
+    if (!format) return false;
+
+    va_list args1, args2;
+    va_start(args1, format);
+    va_copy(args2, args1);
+
+    int length = SDL_vsnprintf(NULL, 0, format, args1);
+    va_end(args1);
+
+    bool result = (length >= 0 && sl__text_builder_reserve(builder, builder->length + length));
+    if (result) {
+        SDL_vsnprintf(builder->data + builder->length, length + 1, format, args2);
+        builder->length += length;
+    }
+    va_end(args2);
+
+    return result;
+}
+
+bool sl_text_builder_append_codepoint(sl_text_builder_t* builder, int codepoint)
+{
+    // NOTE: Encoded here rather than with sl_codepoint_to_utf8(),
+    //       whose static buffer can't be shared between threads.
+
+    char utf8[4];
+    int size = 0;
+
+    if (codepoint < 0 || codepoint > 0x10ffff) {
+        return false;
+    }
+
+    if (codepoint <= 0x7f) {
+        utf8[size++] = (char)codepoint;
+    }
+    else if (codepoint <= 0x7ff) {
+        utf8[size++] = (char)(((codepoint >> 6) & 0x1f) | 0xc0);
+        utf8[size++] = (char)((codepoint & 0x3f) | 0x80);
+    }
+    else if (codepoint <= 0xffff) {
+        utf8[size++] = (char)(((codepoint >> 12) & 0x0f) | 0xe0);
+        utf8[size++] = (char)(((codepoint >> 6) & 0x3f) | 0x80);
+        utf8[size++] = (char)((codepoint & 0x3f) | 0x80);
+    }
+    else {
+        utf8[size++] = (char)(((codepoint >> 18) & 0x07) | 0xf0);
+        utf8[size++] = (char)(((codepoint >> 12) & 0x3f) | 0x80);
+        utf8[size++] = (char)(((codepoint >> 6) & 0x3f) | 0x80);
+        utf8[size++] = (char)((codepoint & 0x3f) | 0x80);
+    }
+
+    return sl_text_builder_append_n(builder, utf8, size);
+}
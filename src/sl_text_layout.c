@@ -0,0 +1,475 @@
+/**
+ * Copyright (c) 2025 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <smol.h>
+
+#include "./internal/sl__render.h"
+
+#include <SDL3/SDL_stdinc.h>
+
+/* === Internal Functions === */
+
+static bool sl__text_layout_grow(void** data, int* capacity, int count, size_t size)
+{
+    if (count < *capacity) {
+        return true;
+    }
+
+    int new_capacity = (*capacity > 0) ? 2 * (*capacity) : 16;
+    void* new_data = SDL_realloc(*data, new_capacity * size);
+    if (new_data == NULL) {
+        return false;
+    }
+
+    *data = new_data;
+    *capacity = new_capacity;
+
+    return true;
+}
+
+static bool sl__text_layout_push_line(sl__layout_paragraph_t* paragraph, int glyph_first)
+{
+    if (!sl__text_layout_grow((void**)&paragraph->lines, &paragraph->line_capacity, paragraph->line_count, sizeof(sl__layout_line_t))) {
+        return false;
+    }
+
+    paragraph->lines[paragraph->line_count++] = (sl__layout_line_t) {
+        .glyph_first = glyph_first
+    };
+
+    return true;
+}
+
+static void sl__text_layout_end_line(sl__layout_paragraph_t* paragraph, int glyph_end, float w)
+{
+    sl__layout_line_t* line = &paragraph->lines[paragraph->line_count - 1];
+    line->glyph_count = glyph_end - line->glyph_first;
+    line->w = w;
+}
+
+static bool sl__text_layout_build_paragraph(const sl__text_layout_t* layout, sl__font_t* font, sl__layout_paragraph_t* paragraph, const char* text, int length)
+{
+    // NOTE: Glyphs are placed exactly like sl_render_text does, only
+    //       relative to their line so alignment is left for the draw.
+    //       Word breaks happen after the last blank that fits, the
+    //       glyphs already placed past it are moved to the new line.
+
+    paragraph->length = length;
+    paragraph->glyph_count = 0;
+    paragraph->line_count = 0;
+
+    if (!sl__text_layout_push_line(paragraph, 0)) {
+        return false;
+    }
+
+    float scale = layout->font_size / font->base_size;
+    bool wrap = (layout->wrap != SL_TEXT_WRAP_NONE && layout->box_w > 0.0f);
+
+    float x_offset = 0.0f;
+    float visible_w = 0.0f;     //< End of the last drawable glyph of the line
+    int previous_index = -1;
+
+    int break_glyph = 0;        //< First glyph after the last blank of the line
+    float break_x = 0.0f;       //< Offset of that glyph
+    float break_w = 0.0f;       //< Width of the line before that blank
+
+    int codepoints[SL__TEXT_DECODE_CHUNK];
+
+    for (int i = 0; i < length;)
+    {
+        int decoded_size = 0;
+        int count = sl_codepoint_decode(text + i, length - i, codepoints, SL__TEXT_DECODE_CHUNK, &decoded_size);
+        i += decoded_size;
+
+        for (int j = 0; j < count; j++)
+        {
+            int codepoint = codepoints[j];
+
+            int glyph_index = sl__font_glyph_index(font, codepoint);
+            const sl__glyph_t* glyph = &font->glyphs[glyph_index];
+
+            float advance = (float)((glyph->x_advance == 0) ? glyph->w_atlas : glyph->x_advance) * scale;
+            float x = x_offset + sl__font_kerning(font, previous_index, glyph_index) * scale;
+            previous_index = glyph_index;
+
+            /* --- Blanks only move the pen and mark a break opportunity --- */
+
+            if (codepoint == ' ' || codepoint == '\t') {
+                break_w = visible_w;
+                x_offset = x + advance + layout->spacing.x;
+                break_glyph = paragraph->glyph_count;
+                break_x = x_offset;
+                continue;
+            }
+
+            /* --- Break the line if the glyph overflows the box --- */
+
+            int line_first = paragraph->lines[paragraph->line_count - 1].glyph_first;
+
+            if (wrap && x + advance > layout->box_w && paragraph->glyph_count > line_first) {
+                if (layout->wrap == SL_TEXT_WRAP_WORD && break_glyph > line_first) {
+                    sl__text_layout_end_line(paragraph, break_glyph, break_w);
+                    if (!sl__text_layout_push_line(paragraph, break_glyph)) {
+                        return false;
+                    }
+                    for (int k = break_glyph; k < paragraph->glyph_count; k++) {
+                        paragraph->glyphs[k].x -= break_x;
+                    }
+                    x -= break_x;
+                    visible_w = SL_MAX(visible_w - break_x, 0.0f);
+                    line_first = break_glyph;
+                }
+                if (x + advance > layout->box_w && paragraph->glyph_count > line_first) {
+                    sl__text_layout_end_line(paragraph, paragraph->glyph_count, visible_w);
+                    if (!sl__text_layout_push_line(paragraph, paragraph->glyph_count)) {
+                        return false;
+                    }
+                    x = visible_w = 0.0f;
+                }
+                break_glyph = 0;
+            }
+
+            /* --- Place the glyph --- */
+
+            if (!sl__text_layout_grow((void**)&paragraph->glyphs, &paragraph->glyph_capacity, paragraph->glyph_count, sizeof(sl__layout_glyph_t))) {
+                return false;
+            }
+
+            paragraph->glyphs[paragraph->glyph_count++] = (sl__layout_glyph_t) {
+                .index = glyph_index, .x = x
+            };
+
+            visible_w = x + advance;
+            x_offset = visible_w + layout->spacing.x;
+        }
+    }
+
+    sl__text_layout_end_line(paragraph, paragraph->glyph_count, visible_w);
+
+    return true;
+}
+
+static void sl__text_layout_free_paragraph(sl__layout_paragraph_t* paragraph)
+{
+    SDL_free(paragraph->glyphs);
+    SDL_free(paragraph->lines);
+}
+
+static int sl__text_layout_paragraph_length(const char* text)
+{
+    const char* end = SDL_strchr(text, '\n');
+    return (end != NULL) ? (int)(end - text) : (int)SDL_strlen(text);
+}
+
+static int sl__text_layout_count_paragraphs(const char* text)
+{
+    int count = 1;
+    for (const char* c = text; *c != '\0'; c++) {
+        count += (*c == '\n');
+    }
+    return count;
+}
+
+static void sl__text_layout_measure(sl__text_layout_t* layout)
+{
+    layout->line_count = 0;
+    layout->w = 0.0f;
+
+    for (int i = 0; i < layout->paragraph_count; i++) {
+        const sl__layout_paragraph_t* paragraph = &layout->paragraphs[i];
+        for (int j = 0; j < paragraph->line_count; j++) {
+            layout->w = SL_MAX(layout->w, paragraph->lines[j].w);
+        }
+        layout->line_count += paragraph->line_count;
+    }
+
+    int lines = SL_MAX(layout->line_count, 1);
+    layout->h = lines * layout->font_size + (lines - 1) * layout->spacing.y;
+}
+
+static bool sl__text_layout_build_range(sl__text_layout_t* layout, int first, int last, const char* text)
+{
+    // NOTE: 'text' points to the first byte of the paragraph 'first'
+
+    sl__font_t* font = sl__registry_get(&sl__render.reg_fonts, layout->font);
+    if (font == NULL) {
+        sl_loge("TEXT: Failed to build text layout; Invalid font");
+        return false;
+    }
+
+    for (int i = first; i < last; i++) {
+        int length = sl__text_layout_paragraph_length(text);
+        if (!sl__text_layout_build_paragraph(layout, font, &layout->paragraphs[i], text, length)) {
+            sl_loge("TEXT: Failed to build text layout; Out of memory");
+            return false;
+        }
+        text += length + 1;
+    }
+
+    return true;
+}
+
+static bool sl__text_layout_build(sl__text_layout_t* layout)
+{
+    /* --- Match the paragraph count of the text --- */
+
+    int count = sl__text_layout_count_paragraphs(layout->text);
+
+    if (count != layout->paragraph_count) {
+        for (int i = count; i < layout->paragraph_count; i++) {
+            sl__text_layout_free_paragraph(&layout->paragraphs[i]);
+        }
+        sl__layout_paragraph_t* paragraphs = SDL_realloc(layout->paragraphs, count * sizeof(sl__layout_paragraph_t));
+        if (paragraphs == NULL) {
+            sl_loge("TEXT: Failed to build text layout; Out of memory");
+            layout->paragraph_count = SL_MIN(layout->paragraph_count, count);
+            return false;
+        }
+        for (int i = layout->paragraph_count; i < count; i++) {
+            paragraphs[i] = (sl__layout_paragraph_t) { 0 };
+        }
+        layout->paragraphs = paragraphs;
+        layout->paragraph_count = count;
+    }
+
+    /* --- Lay out every paragraph and measure the bounds --- */
+
+    bool result = sl__text_layout_build_range(layout, 0, count, layout->text);
+    sl__text_layout_measure(layout);
+
+    return result;
+}
+
+static bool sl__text_layout_update(sl__text_layout_t* layout, char* text)
+{
+    // NOTE: The paragraphs shared by the start and the end of the old
+    //       and the new strings are kept, only the ones in between are
+    //       laid out again. The layout always takes 'text' over.
+
+    int old_count = layout->paragraph_count;
+    int new_count = sl__text_layout_count_paragraphs(text);
+
+    /* --- Count the unchanged paragraphs at the start --- */
+
+    int prefix = 0;
+    int prefix_bytes = 0;
+
+    while (prefix < old_count && prefix < new_count) {
+        int length = layout->paragraphs[prefix].length;
+        if (sl__text_layout_paragraph_length(text + prefix_bytes) != length ||
+            SDL_memcmp(layout->text + prefix_bytes, text + prefix_bytes, length) != 0) {
+            break;
+        }
+        prefix_bytes += length + 1;
+        prefix++;
+    }
+
+    /* --- Count the unchanged paragraphs at the end --- */
+
+    int suffix = 0;
+    int old_end = (int)SDL_strlen(layout->text);
+    int new_end = (int)SDL_strlen(text);
+
+    while (prefix + suffix < old_count && prefix + suffix < new_count) {
+        int length = layout->paragraphs[old_count - suffix - 1].length;
+        int old_start = old_end - length;
+        int new_start = new_end - length;
+        if (new_start < prefix_bytes || (new_start > 0 && text[new_start - 1] != '\n') ||
+            SDL_memcmp(layout->text + old_start, text + new_start, length) != 0) {
+            break;
+        }
+        old_end = old_start - 1;
+        new_end = new_start - 1;
+        suffix++;
+    }
+
+    /* --- Splice the paragraph array --- */
+
+    sl__layout_paragraph_t* paragraphs = SDL_malloc(new_count * sizeof(sl__layout_paragraph_t));
+    if (paragraphs == NULL) {
+        sl_loge("TEXT: Failed to update text layout; Out of memory");
+        SDL_free(text);
+        return false;
+    }
+
+    SDL_memcpy(paragraphs, layout->paragraphs, prefix * sizeof(sl__layout_paragraph_t));
+    SDL_memcpy(paragraphs + new_count - suffix, layout->paragraphs + old_count - suffix, suffix * sizeof(sl__layout_paragraph_t));
+
+    int changed = new_count - prefix - suffix;
+    int removed = old_count - prefix - suffix;
+
+    // Paragraphs in between reuse the arrays of the removed ones
+    for (int i = 0; i < changed; i++) {
+        paragraphs[prefix + i] = (i < removed) ? layout->paragraphs[prefix + i] : (sl__layout_paragraph_t) { 0 };
+    }
+    for (int i = changed; i < removed; i++) {
+        sl__text_layout_free_paragraph(&layout->paragraphs[prefix + i]);
+    }
+
+    SDL_free(layout->paragraphs);
+    SDL_free(layout->text);
+
+    layout->paragraphs = paragraphs;
+    layout->paragraph_count = new_count;
+    layout->text = text;
+
+    /* --- Lay out the changed paragraphs only --- */
+
+    bool result = sl__text_layout_build_range(layout, prefix, prefix + changed, text + prefix_bytes);
+    sl__text_layout_measure(layout);
+
+    return result;
+}
+
+/* === Public API === */
+
+sl_text_layout_id sl_text_layout_create(sl_font_id font, const char* text, float font_size, sl_vec2_t spacing)
+{
+    sl__text_layout_t layout = { 0 };
+
+    layout.font = font;
+    layout.font_size = font_size;
+    layout.spacing = spacing;
+    layout.wrap = SL_TEXT_WRAP_NONE;
+    layout.align = SL_TEXT_ALIGN_LEFT;
+    layout.text = SDL_strdup(text ? text : "");
+
+    if (layout.text == NULL) {
+        sl_loge("TEXT: Failed to create text layout; Out of memory");
+        return 0;
+    }
+
+    if (!sl__text_layout_build(&layout)) {
+        for (int i = 0; i < layout.paragraph_count; i++) {
+            sl__text_layout_free_paragraph(&layout.paragraphs[i]);
+        }
+        SDL_free(layout.paragraphs);
+        SDL_free(layout.text);
+        return 0;
+    }
+
+    return sl__registry_add(&sl__render.reg_layouts, &layout);
+}
+
+void sl_text_layout_destroy(sl_text_layout_id layout)
+{
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < data->paragraph_count; i++) {
+        sl__text_layout_free_paragraph(&data->paragraphs[i]);
+    }
+
+    SDL_free(data->paragraphs);
+    SDL_free(data->text);
+
+    sl__registry_remove(&sl__render.reg_layouts, layout);
+}
+
+bool sl_text_layout_set_text(sl_text_layout_id layout, const char* text)
+{
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) {
+        return false;
+    }
+
+    if (text == NULL) {
+        text = "";
+    }
+
+    /* --- Keep the current run if the string is the same --- */
+
+    if (SDL_strcmp(data->text, text) == 0) {
+        return true;
+    }
+
+    char* copy = SDL_strdup(text);
+    if (copy == NULL) {
+        sl_loge("TEXT: Failed to update text layout; Out of memory");
+        return false;
+    }
+
+    return sl__text_layout_update(data, copy);
+}
+
+bool sl_text_layout_set_font(sl_text_layout_id layout, sl_font_id font, float font_size, sl_vec2_t spacing)
+{
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) {
+        return false;
+    }
+
+    /* --- Keep the current run if nothing changed --- */
+
+    if (data->font == font && data->font_size == font_size &&
+        data->spacing.x == spacing.x && data->spacing.y == spacing.y) {
+        return true;
+    }
+
+    data->font = font;
+    data->font_size = font_size;
+    data->spacing = spacing;
+
+    return sl__text_layout_build(data);
+}
+
+bool sl_text_layout_set_box(sl_text_layout_id layout, float w, float h, sl_text_wrap_t wrap, sl_text_align_t align)
+{
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) {
+        return false;
+    }
+
+    w = SL_MAX(w, 0.0f);
+    h = SL_MAX(h, 0.0f);
+
+    /* --- Only the wrap width changes the line breaks --- */
+
+    bool was_wrapped = (data->wrap != SL_TEXT_WRAP_NONE && data->box_w > 0.0f);
+    bool is_wrapped = (wrap != SL_TEXT_WRAP_NONE && w > 0.0f);
+    bool relayout = (was_wrapped || is_wrapped) && (data->wrap != wrap || data->box_w != w);
+
+    data->box_w = w;
+    data->box_h = h;
+    data->wrap = wrap;
+    data->align = align;
+
+    return relayout ? sl__text_layout_build(data) : true;
+}
+
+bool sl_text_layout_query(sl_text_layout_id layout, float* w, float* h)
+{
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) return false;
+
+    if (w) *w = data->w;
+    if (h) *h = data->h;
+
+    return true;
+}
+
+int sl_text_layout_line_count(sl_text_layout_id layout)
+{
+    sl__text_layout_t* data = sl__registry_get(&sl__render.reg_layouts, layout);
+    if (data == NULL) return 0;
+
+    return data->line_count;
+}
@@ -21,6 +21,10 @@
 
 #include "./internal/sl__render.h"
 
+#ifdef SL_BACKEND_SOFTWARE
+    #include "./internal/sl__raster.h"
+#endif
+
 /* === Public API === */
 
 sl_texture_id sl_texture_create(const void* pixels, int w, int h, sl_pixel_format_t format)
@@ -30,6 +34,21 @@ sl_texture_id sl_texture_create(const void* pixels, int w, int h, sl_pixel_forma
         return 0;
     }
 
+#ifdef SL_BACKEND_SOFTWARE
+
+    /* --- Convert texels for the rasterizer --- */
+
+    sl__texture_t tex = { 0 };
+
+    if (!sl__raster_texture_alloc(&tex, pixels, w, h, format)) {
+        sl_loge("TEXTURE: Failed to create texture; Out of memory");
+        return 0;
+    }
+
+    return sl__registry_add(&sl__render.reg_textures, &tex);
+
+#else
+
     /* --- Generate texture --- */
 
     GLuint texture;
@@ -43,31 +62,7 @@ sl_texture_id sl_texture_create(const void* pixels, int w, int h, sl_pixel_forma
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE);
 
-    GLenum gl_internal_format = GL_RGBA;
-    GLenum gl_format = GL_RGBA;
-    GLenum gl_type = GL_UNSIGNED_BYTE;
-
-    switch (format) {
-    case SL_PIXEL_FORMAT_LUMINANCE8:
-        gl_internal_format = gl_format = GL_LUMINANCE;
-        break;
-    case SL_PIXEL_FORMAT_ALPHA8:
-        gl_internal_format = gl_format = GL_ALPHA;
-        break;
-    case SL_PIXEL_FORMAT_LUMINANCE_ALPHA8:
-        gl_internal_format = gl_format = GL_LUMINANCE_ALPHA;
-        break;
-    case SL_PIXEL_FORMAT_RGB8:
-        gl_internal_format = gl_format = GL_RGB;
-        break;
-    case SL_PIXEL_FORMAT_RGBA8:
-        gl_internal_format = gl_format = GL_RGBA;
-        break;
-    default:
-        break;
-    }
-
-    glTexImage2D(GL_TEXTURE_2D, 0, gl_internal_format, w, h, 0, gl_format, gl_type, pixels);
+    sl__render_tex_image_2d(format, w, h, pixels);
 
     /* --- Push texture to the registry --- */
 
@@ -78,6 +73,8 @@ sl_texture_id sl_texture_create(const void* pixels, int w, int h, sl_pixel_forma
     };
 
     return sl__registry_add(&sl__render.reg_textures, &tex);
+
+#endif // SL_BACKEND_SOFTWARE
 }
 
 sl_texture_id sl_texture_load(const char* file_path, int* w, int* h)
@@ -117,6 +114,30 @@ sl_texture_id sl_texture_load_from_memory(const sl_image_t* image)
     return texture;
 }
 
+bool sl_texture_update(sl_texture_id texture, int x, int y, int w, int h, const void* pixels, sl_pixel_format_t format)
+{
+    sl__texture_t* data = sl__registry_get(&sl__render.reg_textures, texture);
+    if (data == NULL || pixels == NULL) {
+        sl_loge("TEXTURE: Failed to update texture; Invalid input parameters");
+        return false;
+    }
+
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > data->w || y + h > data->h) {
+        sl_loge("TEXTURE: Failed to update texture; Region out of bounds");
+        return false;
+    }
+
+#ifdef SL_BACKEND_SOFTWARE
+    sl__raster_texture_update(data, x, y, w, h, pixels, format);
+#else
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, data->id);
+    sl__render_tex_sub_image_2d(format, x, y, w, h, pixels);
+#endif
+
+    return true;
+}
+
 void sl_texture_destroy(sl_texture_id texture)
 {
     if (texture == 0 || texture == sl__render.default_texture) {
@@ -130,7 +151,11 @@ void sl_texture_destroy(sl_texture_id texture)
     sl__texture_t* data = sl__registry_get(&sl__render.reg_textures, texture);
     if (data == NULL) return;
 
+#ifdef SL_BACKEND_SOFTWARE
+    sl__raster_texture_free(data);
+#else
     glDeleteTextures(1, &data->id);
+#endif
 
     sl__registry_remove(&sl__render.reg_textures, texture);
 }
@@ -139,9 +164,14 @@ void sl_texture_generate_mipmap(sl_texture_id texture)
 {
     sl__texture_t* data = sl__registry_get(&sl__render.reg_textures, texture);
 
+#ifdef SL_BACKEND_SOFTWARE
+    // NOTE: The rasterizer has no mip levels, trilinear falls back to bilinear
+    (void)data;
+#else
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, data->id);
     glGenerateMipmap(GL_TEXTURE_2D);
+#endif
 }
 
 void sl_texture_parameters(sl_texture_id texture, sl_filter_mode_t filter, sl_wrap_mode_t wrap)
@@ -152,6 +182,12 @@ void sl_texture_parameters(sl_texture_id texture, sl_filter_mode_t filter, sl_wr
 
     sl__texture_t* data = sl__registry_get(&sl__render.reg_textures, texture);
 
+#ifdef SL_BACKEND_SOFTWARE
+    if (data != NULL) {
+        data->filter = filter;
+        data->wrap = wrap;
+    }
+#else
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, data->id);
 
@@ -180,6 +216,7 @@ void sl_texture_parameters(sl_texture_id texture, sl_filter_mode_t filter, sl_wr
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         break;
     }
+#endif
 }
 
 bool sl_texture_query(sl_texture_id texture, int* w, int* h)